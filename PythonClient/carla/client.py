@@ -7,6 +7,7 @@
 """CARLA Client."""
 
 import logging
+import mmap
 import struct
 
 from contextlib import contextmanager
@@ -36,6 +37,13 @@ def make_carla_client(host, world_port, timeout=15):
         yield client
 
 
+@contextmanager
+def make_carla_observer(host, observer_port, timeout=15):
+    """Context manager for creating and connecting a CarlaObserver."""
+    with util.make_connection(CarlaObserver, host, observer_port, timeout) as observer:
+        yield observer
+
+
 class CarlaClient(object):
     """The CARLA client. Manages communications with the CARLA server."""
 
@@ -46,6 +54,8 @@ class CarlaClient(object):
         self._current_settings = None
         self._is_episode_requested = False
         self._sensors = {}
+        self._shared_memory_path = '/dev/shm/carla-server-%d' % (world_port + 1)
+        self._shared_memory = None
 
     def connect(self, connection_attempts=10):
         """
@@ -116,15 +126,12 @@ class CarlaClient(object):
         Read the data sent from the server this frame. The episode must be
         started. Return a pair containing the protobuf object containing the
         measurements followed by the raw data of the sensors.
+
+        With SharedMemoryTransport enabled, the raw data of the sensors points
+        directly into the shared memory region and is overwritten a few frames
+        later, copy it if it needs to be kept.
         """
-        # Read measurements.
-        data = self._stream_client.read()
-        if not data:
-            raise RuntimeError('failed to read data from server')
-        pb_message = carla_protocol.Measurements()
-        pb_message.ParseFromString(data)
-        # Read sensor data.
-        return pb_message, dict(x for x in self._read_sensor_data())
+        return _read_data(self._stream_client, self._sensors, self._get_shared_memory)
 
     def send_control(self, *args, **kwargs):
         """
@@ -132,6 +139,9 @@ class CarlaClient(object):
 
         If synchronous mode was requested, the server will pause the simulation
         until this message is received.
+
+        If repeat_frames is given, the control is applied during that number
+        of frames, and the next measurements are those of the last frame.
         """
         if isinstance(args[0] if args else None, carla_protocol.Control):
             pb_message = args[0]
@@ -142,6 +152,7 @@ class CarlaClient(object):
             pb_message.brake = kwargs.get('brake', 0.0)
             pb_message.hand_brake = kwargs.get('hand_brake', False)
             pb_message.reverse = kwargs.get('reverse', False)
+            pb_message.repeat_frames = kwargs.get('repeat_frames', 1)
         self._control_client.write(pb_message.SerializeToString())
 
     def _request_new_episode(self, carla_settings):
@@ -152,6 +163,8 @@ class CarlaClient(object):
         # Disconnect agent clients.
         self._stream_client.disconnect()
         self._control_client.disconnect()
+        # The server creates a new shared memory region every episode.
+        self._shared_memory = None
         # Send new episode request.
         pb_message = carla_protocol.RequestNewEpisode()
         pb_message.ini_file = str(carla_settings)
@@ -167,17 +180,133 @@ class CarlaClient(object):
         self._is_episode_requested = True
         return pb_message
 
-    def _read_sensor_data(self):
-        while True:
-            data = self._stream_client.read()
-            if not data:
-                raise StopIteration
-            yield self._parse_sensor_data(data)
+    def _get_shared_memory(self):
+        """Map the shared memory region of the current episode on first use."""
+        if self._shared_memory is None:
+            self._shared_memory = _map_shared_memory(self._shared_memory_path)
+        return self._shared_memory
 
-    def _parse_sensor_data(self, data):
-        sensor_id = struct.unpack('<L', data[0:4])[0]
-        parser = self._sensors[sensor_id]
-        return parser.name, parser.parse_raw_data(data[4:])
+
+class CarlaObserver(object):
+    """
+    Read-only client, receives the same measurements and sensor data sent to
+    the client controlling the simulation. Frames are dropped if the observer
+    cannot keep up. The server closes the connection at the end of each
+    episode, connect again to observe the next one.
+    """
+
+    def __init__(self, host, observer_port, timeout=15):
+        self._stream_client = tcp.TCPClient(host, observer_port, timeout)
+        self._sensors = {}
+        self.scene = None
+
+    def connect(self, connection_attempts=10):
+        """
+        Connect to the observer port of a CARLA server, the scene description
+        of the current episode is stored in "scene".
+        """
+        self._stream_client.connect(connection_attempts)
+        data = self._stream_client.read()
+        if not data:
+            raise RuntimeError('failed to read data from server')
+        self.scene = carla_protocol.SceneDescription()
+        self.scene.ParseFromString(data)
+        self._sensors = dict((sensor.id, sensor) \
+            for sensor in _make_sensor_parsers(self.scene.sensors))
+
+    def disconnect(self):
+        """Disconnect from server."""
+        self._stream_client.disconnect()
+
+    def connected(self):
+        """Return whether there is an active connection."""
+        return self._stream_client.connected()
+
+    def read_data(self):
+        """
+        Read the next frame received. Return a pair containing the protobuf
+        object containing the measurements followed by the raw data of the
+        sensors.
+        """
+        return _read_data(self._stream_client, self._sensors)
+
+
+def _read_data(stream_client, sensors, get_shared_memory=None):
+    # Read measurements.
+    data = stream_client.read()
+    if not data:
+        raise RuntimeError('failed to read data from server')
+    pb_message = carla_protocol.Measurements()
+    pb_message.ParseFromString(data)
+    # Read sensor data.
+    return pb_message, dict(x for x in _read_sensor_data(stream_client, sensors, get_shared_memory))
+
+
+def _read_sensor_data(stream_client, sensors, get_shared_memory=None):
+    while True:
+        data = stream_client.read()
+        if not data:
+            return
+        yield _parse_sensor_data(sensors, data, get_shared_memory)
+
+
+# Set in the sensor id when the data is in the shared memory region.
+_SHARED_MEMORY_FLAG = 0x80000000
+
+# Each slot of the region is [sequence, size, data, sequence], see
+# carla::server::SharedMemoryRing.
+_SLOT_PREFIX_SIZE = 16
+
+
+class SharedMemoryOverwrittenError(RuntimeError):
+    """
+    The sensor data was overwritten in the shared memory region before being
+    read, the client lags behind the server by more frames than the region
+    holds.
+    """
+    pass
+
+
+def _read_slot(shared_memory, offset, size, sequence):
+    """Return a view of the data of the slot, checking its sequence numbers."""
+    end = offset + _SLOT_PREFIX_SIZE + size
+    if end + 8 > len(shared_memory):
+        raise RuntimeError('invalid shared memory location')
+    # The server writes the first sequence number before the data and the
+    # last one after, so checking the last before copying and the first after
+    # detects a slot overwritten meanwhile. The data is copied out of the
+    # region, the slot is reused once the client falls behind.
+    after = struct.unpack('<Q', shared_memory[end:end + 8])[0]
+    data = bytes(shared_memory[offset + _SLOT_PREFIX_SIZE:end])
+    before = struct.unpack('<Q', shared_memory[offset:offset + 8])[0]
+    if before != sequence or after != sequence:
+        raise SharedMemoryOverwrittenError(
+            'sensor data overwritten in shared memory, the client lags behind')
+    return data
+
+
+def _parse_sensor_data(sensors, data, get_shared_memory=None):
+    sensor_id = struct.unpack('<L', data[0:4])[0]
+    if sensor_id & _SHARED_MEMORY_FLAG:
+        # The message only contains the location of the data in the region.
+        sensor_id &= ~_SHARED_MEMORY_FLAG
+        offset, size, sequence = struct.unpack('<QLQ', data[4:24])
+        data = _read_slot(get_shared_memory(), offset, size, sequence)
+    else:
+        data = data[4:]
+    parser = sensors[sensor_id]
+    return parser.name, parser.parse_raw_data(data)
+
+
+def _map_shared_memory(path):
+    with open(path, 'rb') as fd:
+        shared_memory = mmap.mmap(fd.fileno(), 0, access=mmap.ACCESS_READ)
+    try:
+        # Slicing a memoryview does not copy the data.
+        return memoryview(shared_memory)
+    except TypeError:
+        # Python 2 mmap does not support memoryview, slicing copies.
+        return shared_memory
 
 
 def _make_sensor_parsers(sensors):
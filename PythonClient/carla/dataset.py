@@ -0,0 +1,399 @@
+# Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""Random-access dataset of measurements and sensor data.
+
+A dataset is a folder with two files, both only ever appended to:
+
+  * "data.bin", a header followed by one record per frame. Each record is a
+    table of blobs followed by the blobs, each blob aligned to 64 bytes so it
+    can be used in place, e.g. as a numpy array over the mapped file.
+  * "index.bin", a header followed by a fixed size entry per frame pointing to
+    its record, so looking up the n-th frame is O(1).
+
+Every integer is little-endian.
+
+    data    := "CARLADAT" u32:version u32:reserved record*
+    record  := u64:frame_number u32:number_of_blobs u32:reserved
+               blob_entry[number_of_blobs] name* padding blob*
+    blob_entry := u16:encoding u16:name_size u32:width u32:height f32:fov
+                  u64:offset u64:size
+    index   := "CARLAIDX" u32:version u32:entry_size entry*
+    entry   := u64:frame_number u64:offset u64:size
+
+Blob offsets are absolute offsets in "data.bin". The index entry of a frame
+is written only once its record is complete, so a dataset whose writer was
+interrupted is still readable up to the last frame indexed.
+
+The same layout is written by the ImageConverter tool (Util/ImageConverter).
+"""
+
+import mmap
+import os
+import struct
+
+from collections import namedtuple
+
+try:
+    import numpy
+except ImportError:
+    raise RuntimeError('cannot import numpy, make sure numpy package is installed.')
+
+from . import sensor
+
+
+VERSION = 1
+
+ALIGNMENT = 64
+
+DATA_FILE = 'data.bin'
+
+INDEX_FILE = 'index.bin'
+
+_DATA_HEADER = struct.Struct('<8sII')
+_INDEX_HEADER = struct.Struct('<8sII')
+_INDEX_ENTRY = struct.Struct('<QQQ')
+_RECORD_HEADER = struct.Struct('<QII')
+_BLOB_ENTRY = struct.Struct('<HHIIfQQ')
+
+
+class Encoding(object):
+    """Encoding of the blobs."""
+    RAW = 0
+    # Measurements protobuf message as received from the server.
+    MEASUREMENTS = 1
+    # BGRA images as received from the server, by image type.
+    IMAGE_SCENE_FINAL = 2
+    IMAGE_DEPTH = 3
+    IMAGE_SEMANTIC_SEGMENTATION = 4
+    # RGB images, e.g. converted by the ImageConverter.
+    RGB = 5
+    # PNG file of an image.
+    PNG = 6
+    # Point count of each channel (uint32) followed by the points (float32
+    # x, y, z); width is the number of channels and fov the horizontal angle.
+    LIDAR = 7
+
+
+_IMAGE_ENCODINGS = {
+    'SceneFinal': Encoding.IMAGE_SCENE_FINAL,
+    'Depth': Encoding.IMAGE_DEPTH,
+    'SemanticSegmentation': Encoding.IMAGE_SEMANTIC_SEGMENTATION
+}
+
+_IMAGE_TYPES = dict((v, k) for k, v in _IMAGE_ENCODINGS.items())
+
+
+Blob = namedtuple('Blob', 'name encoding width height fov data')
+
+
+def _padding(offset):
+    return (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT
+
+
+def _size(data):
+    view = memoryview(data)
+    return len(view) * view.itemsize
+
+
+def _check_header(header, magic, path):
+    if len(header) < 16:
+        raise ValueError('%s: not a CARLA dataset' % path)
+    magic_read, version, value = struct.unpack('<8sII', header[:16])
+    if magic_read != magic:
+        raise ValueError('%s: not a CARLA dataset' % path)
+    if version != VERSION:
+        raise ValueError('%s: unsupported version %d' % (path, version))
+    return value
+
+
+# ==============================================================================
+# -- DatasetWriter -------------------------------------------------------------
+# ==============================================================================
+
+
+class DatasetWriter(object):
+    """Appends frames to the dataset at folder 'path', created if missing.
+
+    If 'compress_images' is True, camera images are stored as PNG (requires
+    PIL) instead of raw, smaller but slower to read.
+    """
+
+    def __init__(self, path, compress_images=False):
+        self._compress_images = compress_images
+        if not os.path.isdir(path):
+            os.makedirs(path)
+        data_path = os.path.join(path, DATA_FILE)
+        index_path = os.path.join(path, INDEX_FILE)
+        self._data = open(data_path, 'ab')
+        self._index = open(index_path, 'ab')
+        try:
+            self._open(data_path, index_path)
+        except:
+            self.close()
+            raise
+
+    def _open(self, data_path, index_path):
+        if self._data.tell() == 0:
+            self._data.write(_DATA_HEADER.pack(b'CARLADAT', VERSION, 0))
+        else:
+            with open(data_path, 'rb') as f:
+                _check_header(f.read(16), b'CARLADAT', data_path)
+        if self._index.tell() == 0:
+            self._index.write(_INDEX_HEADER.pack(b'CARLAIDX', VERSION, _INDEX_ENTRY.size))
+        else:
+            with open(index_path, 'rb') as f:
+                _check_header(f.read(16), b'CARLAIDX', index_path)
+            # Drop an entry left incomplete by an interrupted writer.
+            entries = (self._index.tell() - _INDEX_HEADER.size) // _INDEX_ENTRY.size
+            self._index.truncate(_INDEX_HEADER.size + entries * _INDEX_ENTRY.size)
+            self._index.seek(0, os.SEEK_END)
+        self._data.seek(0, os.SEEK_END)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        self._data.close()
+        self._index.close()
+
+    def add_frame(self, frame_number, measurements=None, sensor_data=None):
+        """Append a frame. 'measurements' is the Measurements message (or its
+        serialized bytes) and 'sensor_data' a dict of sensor name to Image,
+        LidarMeasurement or bytes, as returned by CarlaClient.read_data."""
+        blobs = []
+        if measurements is not None:
+            if not isinstance(measurements, (bytes, bytearray, memoryview)):
+                measurements = measurements.SerializeToString()
+            blobs.append(Blob('measurements', Encoding.MEASUREMENTS, 0, 0, 0.0, measurements))
+        for name, data in sorted((sensor_data or {}).items()):
+            blobs.append(self._make_blob(name, data))
+        self.add_blobs(frame_number, blobs)
+
+    def add_blobs(self, frame_number, blobs):
+        """Append a frame made of the given list of Blob."""
+        names = [b.name.encode('utf-8') for b in blobs]
+        begin = self._data.tell()
+        header_size = (
+            _RECORD_HEADER.size +
+            len(blobs) * _BLOB_ENTRY.size +
+            sum(len(n) for n in names))
+        offset = begin + header_size + _padding(begin + header_size)
+        header = [_RECORD_HEADER.pack(frame_number, len(blobs), 0)]
+        for blob, name in zip(blobs, names):
+            size = _size(blob.data)
+            header.append(_BLOB_ENTRY.pack(
+                blob.encoding, len(name), blob.width, blob.height, blob.fov, offset, size))
+            offset += size + _padding(offset + size)
+        header.extend(names)
+        self._data.write(b''.join(header))
+        for blob in blobs:
+            self._data.write(b'\0' * _padding(self._data.tell()))
+            self._data.write(blob.data)
+        end = self._data.tell()
+        self._data.flush()
+        self._index.write(_INDEX_ENTRY.pack(frame_number, begin, end - begin))
+        self._index.flush()
+
+    def _make_blob(self, name, data):
+        if isinstance(data, sensor.Image):
+            if self._compress_images:
+                return Blob(name, Encoding.PNG, data.width, data.height, data.fov, _encode_png(data))
+            encoding = _IMAGE_ENCODINGS.get(data.type, Encoding.IMAGE_SCENE_FINAL)
+            return Blob(name, encoding, data.width, data.height, data.fov, data.raw_data)
+        elif isinstance(data, sensor.LidarMeasurement):
+            counts = numpy.asarray(data.point_count_by_channel, dtype=numpy.dtype('<u4'))
+            points = numpy.asarray(data.point_cloud.array, dtype=numpy.dtype('<f4'))
+            return Blob(
+                name, Encoding.LIDAR, data.channels, len(points), data.horizontal_angle,
+                counts.tobytes() + points.tobytes())
+        return Blob(name, Encoding.RAW, 0, 0, 0.0, bytes(data))
+
+
+def _encode_png(image):
+    try:
+        from PIL import Image as PImage
+    except ImportError:
+        raise RuntimeError('cannot import PIL, make sure pillow package is installed')
+    import io
+    bgra = numpy.frombuffer(image.raw_data, dtype=numpy.dtype('uint8'))
+    bgra = numpy.reshape(bgra, (image.height, image.width, 4))
+    output = io.BytesIO()
+    PImage.fromarray(bgra[:, :, 2::-1].copy(), mode='RGB').save(output, format='PNG')
+    return output.getvalue()
+
+
+# ==============================================================================
+# -- DatasetReader -------------------------------------------------------------
+# ==============================================================================
+
+
+class Frame(object):
+    """A frame of a dataset. The data points into the mapped file, it is valid
+    as long as the reader is open."""
+
+    def __init__(self, frame_number, blobs):
+        self.frame_number = frame_number
+        self.blobs = blobs
+
+    @property
+    def measurements(self):
+        """Parsed Measurements message, None if not stored."""
+        for blob in self.blobs:
+            if blob.encoding == Encoding.MEASUREMENTS:
+                from . import carla_server_pb2
+                measurements = carla_server_pb2.Measurements()
+                measurements.ParseFromString(bytes(blob.data))
+                return measurements
+        return None
+
+    @property
+    def sensor_data(self):
+        """Dict of sensor name to sensor.Image or sensor.LidarMeasurement, as
+        returned by CarlaClient.read_data, or the Blob if not a sensor."""
+        return dict((b.name, _to_sensor_data(self.frame_number, b))
+                    for b in self.blobs if b.encoding != Encoding.MEASUREMENTS)
+
+
+def _to_sensor_data(frame_number, blob):
+    if blob.encoding in _IMAGE_TYPES:
+        return sensor.Image(
+            frame_number, blob.width, blob.height, _IMAGE_TYPES[blob.encoding], blob.fov, blob.data)
+    elif blob.encoding == Encoding.LIDAR:
+        channels = blob.width
+        counts = numpy.frombuffer(blob.data, dtype=numpy.dtype('<u4'), count=channels)
+        points = numpy.frombuffer(blob.data, dtype=numpy.dtype('<f4'), offset=4 * channels)
+        points = numpy.reshape(points, (blob.height, 3))
+        return sensor.LidarMeasurement(
+            frame_number, blob.fov, channels, counts, sensor.PointCloud(frame_number, points))
+    return blob
+
+
+def blob_to_array(blob):
+    """Numpy array of the pixels of an image blob, without copy unless
+    compressed: BGRA (height, width, 4) as received from the server, RGB
+    (height, width, 3) if converted or decoded from PNG."""
+    if blob.encoding in _IMAGE_TYPES:
+        array = numpy.frombuffer(blob.data, dtype=numpy.dtype('uint8'))
+        return numpy.reshape(array, (blob.height, blob.width, 4))
+    elif blob.encoding == Encoding.RGB:
+        array = numpy.frombuffer(blob.data, dtype=numpy.dtype('uint8'))
+        return numpy.reshape(array, (blob.height, blob.width, 3))
+    elif blob.encoding == Encoding.PNG:
+        from PIL import Image as PImage
+        import io
+        return numpy.asarray(PImage.open(io.BytesIO(blob.data)).convert('RGB'))
+    raise ValueError('blob "%s" is not an image' % blob.name)
+
+
+class DatasetReader(object):
+    """Reads the dataset at folder 'path' through memory maps. Frames are
+    looked up by position in O(1), dataset[i], or by frame number with
+    find_frame. Frames appended after opening are not visible."""
+
+    def __init__(self, path):
+        self._files = []
+        self._maps = []
+        try:
+            self._open(path)
+        except:
+            self.close()
+            raise
+
+    def _open(self, path):
+        self._data = self._map(os.path.join(path, DATA_FILE), b'CARLADAT')
+        index = self._map(os.path.join(path, INDEX_FILE), b'CARLAIDX')
+        entry_size = _check_header(index, b'CARLAIDX', path)
+        if entry_size != _INDEX_ENTRY.size:
+            raise ValueError('%s: unexpected index entry size %d' % (path, entry_size))
+        count = (len(index) - _INDEX_HEADER.size) // _INDEX_ENTRY.size
+        if count > 0:
+            self._index = numpy.frombuffer(
+                index, dtype=numpy.dtype('<u8'), offset=_INDEX_HEADER.size, count=3 * count)
+            self._index = numpy.reshape(self._index, (count, 3))
+        else:
+            self._index = numpy.zeros((0, 3), dtype=numpy.dtype('<u8'))
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        self._index = None
+        self._data = None
+        for m in self._maps:
+            try:
+                m.close()
+            except BufferError:
+                # Still referenced by a frame, closed when collected.
+                pass
+        for f in self._files:
+            f.close()
+        self._maps = []
+        self._files = []
+
+    def __len__(self):
+        return len(self._index)
+
+    def __getitem__(self, position):
+        if position < 0:
+            position += len(self)
+        if not 0 <= position < len(self):
+            raise IndexError('frame %d out of range' % position)
+        frame_number, offset, size = (int(x) for x in self._index[position])
+        return self._read_record(offset, size)
+
+    def __iter__(self):
+        for position in range(len(self)):
+            yield self[position]
+
+    def frame_numbers(self):
+        return self._index[:, 0]
+
+    def find_frame(self, frame_number):
+        """Frame with the given frame number, O(1) if the frame numbers are
+        consecutive, O(log n) if they are sorted. Raises KeyError if missing."""
+        numbers = self._index[:, 0]
+        if len(numbers) > 0:
+            position = frame_number - int(numbers[0])
+            if 0 <= position < len(numbers) and numbers[position] == frame_number:
+                return self[position]
+            position = int(numpy.searchsorted(numbers, frame_number))
+            if position < len(numbers) and numbers[position] == frame_number:
+                return self[position]
+        raise KeyError('frame %d not found' % frame_number)
+
+    def _map(self, path, magic):
+        f = open(path, 'rb')
+        self._files.append(f)
+        m = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._maps.append(m)
+        view = memoryview(m)
+        _check_header(view[:16].tobytes(), magic, path)
+        return view
+
+    def _read_record(self, offset, size):
+        data = self._data
+        frame_number, number_of_blobs, _ = _RECORD_HEADER.unpack_from(data, offset)
+        entries = []
+        position = offset + _RECORD_HEADER.size
+        for _ in range(number_of_blobs):
+            entries.append(_BLOB_ENTRY.unpack_from(data, position))
+            position += _BLOB_ENTRY.size
+        blobs = []
+        for encoding, name_size, width, height, fov, blob_offset, blob_size in entries:
+            name = data[position:position + name_size].tobytes().decode('utf-8')
+            position += name_size
+            if blob_offset + blob_size > offset + size:
+                raise ValueError('corrupt record of frame %d' % frame_number)
+            blobs.append(Blob(
+                name, encoding, width, height, fov, data[blob_offset:blob_offset + blob_size]))
+        return Frame(frame_number, blobs)
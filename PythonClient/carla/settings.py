@@ -35,9 +35,16 @@ class CarlaSettings(object):
     def __init__(self, **kwargs):
         # [CARLA/Server]
         self.SynchronousMode = True
+        self.PipelinedSynchronousMode = False
+        self.SharedMemoryTransport = False
         self.SendNonPlayerAgentsInfo = False
+        self.SendTelemetry = False
+        self.AllowSoftReset = True
+        self.FixedTimeStep = 0.0
+        self.ReproducibleSimulation = False
         # [CARLA/QualitySettings]
         self.QualityLevel = 'Epic'
+        self.DisableRendering = False
         # [CARLA/LevelSettings]
         self.PlayerVehicle = None
         self.NumberOfVehicles = 20
@@ -46,6 +53,14 @@ class CarlaSettings(object):
         self.SeedVehicles = None
         self.SeedPedestrians = None
         self.DisableTwoWheeledVehicles = False
+        # [CARLA/TickScheduler]
+        self.VehicleAITickRate = 0.0
+        self.VehicleAITickBudget = 0.0
+        self.WalkerAITickRate = 0.0
+        self.WalkerAITickBudget = 0.0
+        self.TrafficLightTickRate = 0.0
+        self.SpawnerTickRate = 0.0
+        self.SpawnerTickBudget = 0.0
         self.set(**kwargs)
         self._sensors = []
 
@@ -80,6 +95,7 @@ class CarlaSettings(object):
         S_SERVER = 'CARLA/Server'
         S_QUALITY = 'CARLA/QualitySettings'
         S_LEVEL = 'CARLA/LevelSettings'
+        S_TICK_SCHEDULER = 'CARLA/TickScheduler'
         S_SENSOR = 'CARLA/Sensor'
 
         def get_attribs(obj):
@@ -94,9 +110,16 @@ class CarlaSettings(object):
 
         add_section(S_SERVER, self, [
             'SynchronousMode',
-            'SendNonPlayerAgentsInfo'])
+            'PipelinedSynchronousMode',
+            'SharedMemoryTransport',
+            'SendNonPlayerAgentsInfo',
+            'SendTelemetry',
+            'AllowSoftReset',
+            'FixedTimeStep',
+            'ReproducibleSimulation'])
         add_section(S_QUALITY, self, [
-            'QualityLevel'])
+            'QualityLevel',
+            'DisableRendering'])
         add_section(S_LEVEL, self, [
             'NumberOfVehicles',
             'NumberOfPedestrians',
@@ -104,6 +127,14 @@ class CarlaSettings(object):
             'SeedVehicles',
             'SeedPedestrians',
             'DisableTwoWheeledVehicles'])
+        add_section(S_TICK_SCHEDULER, self, [
+            'VehicleAITickRate',
+            'VehicleAITickBudget',
+            'WalkerAITickRate',
+            'WalkerAITickBudget',
+            'TrafficLightTickRate',
+            'SpawnerTickRate',
+            'SpawnerTickBudget'])
 
         ini.add_section(S_SENSOR)
         ini.set(S_SENSOR, 'Sensors', ','.join(s.SensorName for s in self._sensors))
@@ -4,13 +4,16 @@
 # This work is licensed under the terms of the MIT license.
 # For a copy, see <https://opensource.org/licenses/MIT>.
 
-"""Basic TCP client."""
+"""Basic TCP client, also supports Unix domain sockets."""
 
 import logging
 import socket
 import struct
 import time
 
+UNIX_SCHEME = 'unix://'
+
+
 class TCPConnectionError(Exception):
     pass
 
@@ -22,6 +25,9 @@ class TCPClient(object):
 
     Received messages are expected to be prepended by a int32 defining the
     message size. Messages are sent following this convention.
+
+    If host is given as "unix://<path>", the client connects instead to the
+    Unix domain socket "<path>-<port>".
     """
 
     def __init__(self, host, port, timeout):
@@ -37,7 +43,7 @@ class TCPClient(object):
         error = None
         for attempt in range(1, connection_attempts + 1):
             try:
-                self._socket = socket.create_connection(address=(self._host, self._port), timeout=self._timeout)
+                self._socket = self._create_connection()
                 self._socket.settimeout(self._timeout)
                 logging.debug('%sconnected', self._logprefix)
                 return
@@ -93,5 +99,18 @@ class TCPClient(object):
             length -= len(data)
         return buf
 
+    def _create_connection(self):
+        if self._host.startswith(UNIX_SCHEME):
+            path = '%s-%d' % (self._host[len(UNIX_SCHEME):], self._port)
+            unix_socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            unix_socket.settimeout(self._timeout)
+            try:
+                unix_socket.connect(path)
+            except socket.error:
+                unix_socket.close()
+                raise
+            return unix_socket
+        return socket.create_connection(address=(self._host, self._port), timeout=self._timeout)
+
     def _reraise_exception_as_tcp_error(self, message, exception):
         raise TCPConnectionError('%s%s: %s' % (self._logprefix, message, exception))
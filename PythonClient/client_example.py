@@ -12,10 +12,12 @@ from __future__ import print_function
 
 import argparse
 import logging
+import os
 import random
 import time
 
 from carla.client import make_carla_client
+from carla.dataset import DatasetWriter
 from carla.sensor import Camera, Lidar
 from carla.settings import CarlaSettings
 from carla.tcp import TCPConnectionError
@@ -107,6 +109,11 @@ def run_carla_client(args):
             print('Starting new episode at %r...' % scene.map_name)
             client.start_episode(player_start)
 
+            # Append every frame to a dataset if requested.
+            dataset = None
+            if args.dataset is not None:
+                dataset = DatasetWriter(os.path.join(args.dataset, 'episode_{:0>4d}'.format(episode)))
+
             # Iterate every frame in the episode.
             for frame in range(0, frames_per_episode):
 
@@ -122,6 +129,9 @@ def run_carla_client(args):
                         filename = args.out_filename_format.format(episode, name, frame)
                         measurement.save_to_disk(filename)
 
+                if dataset is not None:
+                    dataset.add_frame(measurements.frame_number, measurements, sensor_data)
+
                 # We can access the encoded data of a given image as numpy
                 # array using its "data" property. For instance, to get the
                 # depth value (normalized) at pixel X, Y
@@ -174,6 +184,9 @@ def run_carla_client(args):
                     control.steer += random.uniform(-0.1, 0.1)
                     client.send_control(control)
 
+            if dataset is not None:
+                dataset.close()
+
 
 def print_measurements(measurements):
     number_of_agents = len(measurements.non_player_agents)
@@ -233,6 +246,11 @@ def main():
         action='store_true',
         dest='save_images_to_disk',
         help='save images (and Lidar data if active) to disk')
+    argparser.add_argument(
+        '-d', '--dataset',
+        metavar='PATH',
+        default=None,
+        help='append measurements and sensor data to a dataset at PATH, a folder per episode')
     argparser.add_argument(
         '-c', '--carla-settings',
         metavar='PATH',
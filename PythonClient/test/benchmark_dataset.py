@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""Compare the read throughput of a dataset (carla.dataset) against the
+PNG-per-frame layout written by Image.save_to_disk."""
+
+import argparse
+import logging
+import os
+import random
+import shutil
+import sys
+import tempfile
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+
+import numpy
+
+from carla import sensor
+from carla.dataset import DatasetReader, DatasetWriter, blob_to_array
+from carla.util import StopWatch
+
+try:
+    from PIL import Image as PImage
+except ImportError:
+    raise RuntimeError('cannot import PIL, make sure pillow package is installed')
+
+
+def make_images(args):
+    """Synthetic camera images, smooth enough to compress like real ones."""
+    y, x = numpy.mgrid[0:args.height, 0:args.width]
+    for frame in range(args.frames):
+        bgra = numpy.empty((args.height, args.width, 4), dtype=numpy.uint8)
+        bgra[:, :, 0] = (x + frame) % 256
+        bgra[:, :, 1] = (y + 2 * frame) % 256
+        bgra[:, :, 2] = (x + y) % 256
+        bgra[:, :, 3] = 255
+        yield sensor.Image(frame, args.width, args.height, 'SceneFinal', 90.0, bgra.tobytes())
+
+
+def write_png_per_frame(path, args):
+    for image in make_images(args):
+        image.save_to_disk(os.path.join(path, 'CameraRGB', '{:06d}.png'.format(image.frame_number)))
+
+
+def write_dataset(path, args, compress_images):
+    with DatasetWriter(path, compress_images=compress_images) as writer:
+        for image in make_images(args):
+            writer.add_frame(image.frame_number, sensor_data={'CameraRGB': image})
+
+
+def read_png_per_frame(path, order):
+    for frame in order:
+        filename = os.path.join(path, 'CameraRGB', '{:06d}.png'.format(frame))
+        yield numpy.asarray(PImage.open(filename))
+
+
+def read_dataset(path, order):
+    with DatasetReader(path) as reader:
+        for frame in order:
+            yield blob_to_array(reader.find_frame(frame).blobs[0])
+
+
+def benchmark(name, frames, args):
+    """Read every frame, sequentially and shuffled. Each frame is copied to
+    memory, the raw dataset would not touch the pixels otherwise."""
+    sequential = list(range(args.frames))
+    shuffled = list(sequential)
+    random.Random(args.frames).shuffle(shuffled)
+    for order_name, order in [('sequential', sequential), ('random', shuffled)]:
+        watch = StopWatch()
+        total_bytes = 0
+        for array in frames(order):
+            total_bytes += numpy.array(array).nbytes
+        watch.stop()
+        print('{:<22} {:<10} {:8.1f} frames/s {:9.1f} MB/s'.format(
+            name, order_name,
+            len(order) / watch.seconds(),
+            total_bytes / (1e6 * watch.seconds())))
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '-n', '--frames',
+        metavar='N',
+        default=500,
+        type=int,
+        help='number of frames (default: 500)')
+    argparser.add_argument(
+        '--width',
+        metavar='W',
+        default=800,
+        type=int,
+        help='image width (default: 800)')
+    argparser.add_argument(
+        '--height',
+        metavar='H',
+        default=600,
+        type=int,
+        help='image height (default: 600)')
+    args = argparser.parse_args()
+
+    logging.basicConfig(format='%(levelname)s: %(message)s', level=logging.INFO)
+
+    root = tempfile.mkdtemp()
+    try:
+        layouts = [
+            ('png per frame', write_png_per_frame, read_png_per_frame),
+            ('dataset (raw)', lambda p, a: write_dataset(p, a, False), read_dataset),
+            ('dataset (png)', lambda p, a: write_dataset(p, a, True), read_dataset)]
+        for index, (name, write, read) in enumerate(layouts):
+            path = os.path.join(root, str(index))
+            logging.info('writing %d %dx%d frames, %s', args.frames, args.width, args.height, name)
+            write(path, args)
+            benchmark(name, lambda order: read(path, order), args)
+    finally:
+        shutil.rmtree(root)
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        print('\nCancelled by user. Bye!')
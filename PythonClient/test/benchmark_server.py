@@ -10,9 +10,11 @@
 
 import argparse
 import logging
+import math
 import os
 import random
 import sys
+import threading
 import time
 
 sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
@@ -32,6 +34,12 @@ Annotated {count:d} frames.
 average = {avg:.2f} FPS
 maximum = {max:.2f} FPS
 minimum = {min:.2f} FPS
+---------------------------
+frame time = {ft_avg:.2f} ms
+std dev    = {ft_std:.2f} ms
+worst      = {ft_max:.2f} ms
+---------------------------
+throughput = {mbps:.2f} MB/s
 ===========================
 """
 
@@ -117,6 +125,111 @@ def generate_settings_scenario_010():
     return settings
 
 
+def generate_settings_scenario_011():
+    logging.info('Scenario 011: no sensors, no pedestrians, 50 vehicles')
+    settings = make_base_settings()
+    settings.set(NumberOfVehicles=50, NumberOfPedestrians=0)
+    return settings
+
+
+def generate_settings_scenario_012():
+    logging.info('Scenario 012: no sensors, no pedestrians, 200 vehicles')
+    settings = make_base_settings()
+    settings.set(NumberOfVehicles=200, NumberOfPedestrians=0)
+    return settings
+
+
+def generate_settings_scenario_013():
+    logging.info('Scenario 013: no sensors, no pedestrians, 500 vehicles')
+    settings = make_base_settings()
+    settings.set(NumberOfVehicles=500, NumberOfPedestrians=0)
+    return settings
+
+
+def make_settings_2000_agents():
+    settings = make_base_settings()
+    settings.set(
+        SendNonPlayerAgentsInfo=True,
+        NumberOfVehicles=1000,
+        NumberOfPedestrians=1000)
+    return settings
+
+
+def generate_settings_scenario_014():
+    logging.info('Scenario 014: no sensors, 2000 agents, controlling 1 vehicle')
+    return make_settings_2000_agents()
+
+
+def generate_settings_scenario_015():
+    logging.info('Scenario 015: no sensors, 2000 agents, controlling 10 vehicles')
+    return make_settings_2000_agents()
+
+
+def generate_settings_scenario_016():
+    logging.info('Scenario 016: no sensors, 2000 agents, controlling 100 vehicles')
+    return make_settings_2000_agents()
+
+
+def generate_settings_scenario_017():
+    logging.info('Scenario 017: no sensors, 2000 agents, controlling 500 vehicles')
+    return make_settings_2000_agents()
+
+
+def generate_settings_scenario_018():
+    logging.info('Scenario 018: no sensors, 1000 pedestrians')
+    settings = make_base_settings()
+    settings.set(NumberOfPedestrians=1000)
+    return settings
+
+
+def generate_settings_scenario_019():
+    logging.info('Scenario 019: 4 cameras 1920x1080')
+    settings = make_base_settings()
+    for index in range(4):
+        camera = Camera('FullHDCamera%d' % index)
+        camera.set_image_size(1920, 1080)
+        camera.set_rotation(0.0, 90.0 * index, 0.0)
+        settings.add_sensor(camera)
+    return settings
+
+
+def generate_settings_scenario_020():
+    logging.info('Scenario 020: no rendering, 200 vehicles, 100 pedestrians')
+    settings = make_base_settings()
+    settings.set(DisableRendering=True, NumberOfVehicles=200, NumberOfPedestrians=100)
+    return settings
+
+
+def generate_settings_scenario_021():
+    logging.info('Scenario 021: no rendering, 200 vehicles, 100 pedestrians, reduced AI tick rates')
+    settings = make_base_settings()
+    settings.set(
+        DisableRendering=True,
+        NumberOfVehicles=200,
+        NumberOfPedestrians=100,
+        VehicleAITickRate=10.0,
+        WalkerAITickRate=2.0,
+        TrafficLightTickRate=2.0,
+        SpawnerTickRate=1.0)
+    return settings
+
+
+# Number of non-player vehicles controlled by the client in each scenario.
+generate_settings_scenario_014.controlled_agents = 1
+generate_settings_scenario_015.controlled_agents = 10
+generate_settings_scenario_016.controlled_agents = 100
+generate_settings_scenario_017.controlled_agents = 500
+
+
+def add_agent_controls(control, measurements, count):
+    """Add a constant throttle control for the first count vehicles."""
+    vehicles = (a for a in measurements.non_player_agents if a.HasField('vehicle'))
+    for _, agent in zip(range(count), vehicles):
+        agent_control = control.agent_controls.add()
+        agent_control.id = agent.id
+        agent_control.vehicle_control.throttle = 0.5
+
+
 class FPSWatch(object):
     def __init__(self):
         self.stop_watch = StopWatch()
@@ -124,36 +237,120 @@ class FPSWatch(object):
         self.count = 0
         self.max = 0.0
         self.min = float("inf")
+        self.frame_time_sum = 0.0
+        self.frame_time_sum_sq = 0.0
+        self.frame_time_max = 0.0
+        self.received_bytes = 0
 
-    def annotate(self):
+    def annotate(self, received_bytes=0):
         self.stop_watch.stop()
         fps = 1.0 / self.stop_watch.seconds()
         self.sum += fps
         self.count += 1
         self.max = max(self.max, fps)
         self.min = min(self.min, fps)
+        frame_time = self.stop_watch.milliseconds()
+        self.frame_time_sum += frame_time
+        self.frame_time_sum_sq += frame_time * frame_time
+        self.frame_time_max = max(self.frame_time_max, frame_time)
+        self.received_bytes += received_bytes
         self.stop_watch.restart()
 
     def __str__(self):
+        frame_time_avg = self.frame_time_sum / self.count
+        frame_time_var = self.frame_time_sum_sq / self.count - frame_time_avg * frame_time_avg
         return TEXT.format(
             count=self.count,
             avg=self.sum/self.count,
             max=self.max,
-            min=self.min)
+            min=self.min,
+            ft_avg=frame_time_avg,
+            ft_std=math.sqrt(max(frame_time_var, 0.0)),
+            ft_max=self.frame_time_max,
+            mbps=self.received_bytes / (1e3 * self.frame_time_sum) if self.frame_time_sum > 0.0 else 0.0)
 
 
-def run_carla_client(args, settings_generators):
-    with make_carla_client(args.host, args.port, timeout=25) as client:
+def run_carla_client(args, settings_generators, port):
+    watches = []
+    with make_carla_client(args.host, port, timeout=25) as client:
         for settings_generator in settings_generators:
-            scene = client.load_settings(settings_generator())
+            settings = settings_generator()
+            if args.no_soft_reset:
+                settings.set(AllowSoftReset=False)
+            synchronous = args.synchronous or args.pipelined
+            if synchronous:
+                settings.set(
+                    SynchronousMode=True,
+                    PipelinedSynchronousMode=args.pipelined)
+            if args.shared_memory:
+                settings.set(SharedMemoryTransport=True)
+            episode_start = StopWatch()
+            scene = client.load_settings(settings)
+            controlled_agents = getattr(settings_generator, 'controlled_agents', 0)
             client.start_episode(0)
+            episode_start.stop()
+            logging.info('episode started in %.2f ms', episode_start.milliseconds())
             watch = FPSWatch()
-            for frame in range(0, 3000):
+            mismatched_frames = 0
+            start_time = time.time()
+            frame = 0
+            while (time.time() - start_time < 60.0 * args.minutes) if args.minutes else (frame < 3000):
+                frame += 1
                 measurements, sensor_data = client.read_data()
-                client.send_control(measurements.player_measurements.autopilot_control)
-                watch.annotate()
+                if synchronous and any(x.frame_number != measurements.frame_number for x in sensor_data.values()):
+                    mismatched_frames += 1
+                if args.client_delay > 0.0:
+                    time.sleep(args.client_delay / 1000.0)
+                control = measurements.player_measurements.autopilot_control
+                if controlled_agents > 0:
+                    add_agent_controls(control, measurements, controlled_agents)
+                control.repeat_frames = args.repeat_frames
+                client.send_control(control)
+                watch.annotate(measurements.ByteSize() + sum(
+                    len(getattr(x, 'raw_data', b'')) for x in sensor_data.values()))
+                if args.minutes and frame % 10000 == 0:
+                    logging.info('%.1f minutes elapsed', (time.time() - start_time) / 60.0)
+                    logging.info(str(watch))
             print(str(watch))
+            watches.append(watch)
+            if mismatched_frames > 0:
+                logging.warning('%d frames with sensor data from a different frame', mismatched_frames)
         print('done.')
+    return watches
+
+
+def run_session(args, settings_generators, port):
+    logging.info('listening to server %s:%s', args.host, port)
+
+    while True:
+        try:
+
+            return run_carla_client(args, settings_generators, port)
+
+        except AssertionError as assertion:
+            raise assertion
+        except Exception as exception:
+            logging.error('exception: %s', exception)
+            time.sleep(1)
+
+
+def run_sessions(args, settings_generators):
+    """Run a client for each server instance, every instance uses the next
+    three ports. Report the total throughput of each scenario."""
+    results = [None] * args.sessions
+
+    def run(index):
+        results[index] = run_session(args, settings_generators, args.port + 3 * index)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(args.sessions)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    for index, generator in enumerate(settings_generators):
+        total = sum(watches[index].sum / watches[index].count for watches in results)
+        print('{}: {:.2f} FPS in total over {:d} sessions'.format(
+            generator.__name__, total, args.sessions))
 
 
 def main():
@@ -172,7 +369,7 @@ def main():
         '--host',
         metavar='H',
         default='localhost',
-        help='IP of the host server (default: localhost)')
+        help='IP of the host server, or "unix://<path>" for Unix domain sockets (default: localhost)')
     argparser.add_argument(
         '-p', '--port',
         metavar='P',
@@ -185,6 +382,46 @@ def main():
         default=-1,
         type=int,
         help='benchmark scenario to use')
+    argparser.add_argument(
+        '--no-soft-reset',
+        action='store_true',
+        help='always reload the level when starting a new episode')
+    argparser.add_argument(
+        '--synchronous',
+        action='store_true',
+        help='run the server in synchronous mode (ticks per second are reported as FPS)')
+    argparser.add_argument(
+        '--pipelined',
+        action='store_true',
+        help='run the server in pipelined synchronous mode')
+    argparser.add_argument(
+        '--shared-memory',
+        action='store_true',
+        help='receive the sensor data through shared memory (server in the same machine)')
+    argparser.add_argument(
+        '--client-delay',
+        metavar='MS',
+        default=0.0,
+        type=float,
+        help='simulate MS milliseconds of client processing per frame (default: 0)')
+    argparser.add_argument(
+        '--repeat-frames',
+        metavar='K',
+        default=1,
+        type=int,
+        help='apply each control during K frames (FPS counts the controls sent)')
+    argparser.add_argument(
+        '--sessions',
+        metavar='N',
+        default=1,
+        type=int,
+        help='benchmark N servers at once, listening to consecutive ports (default: 1)')
+    argparser.add_argument(
+        '--minutes',
+        metavar='M',
+        default=None,
+        type=float,
+        help='soak test, run each scenario for M minutes instead of 3000 frames')
     argparser.add_argument(
         '-l', '--list',
         action='store_true',
@@ -219,19 +456,10 @@ def main():
 
     settings_generators = [getattr(self_module, x) for x in generators_to_use]
 
-    logging.info('listening to server %s:%s', args.host, args.port)
-
-    while True:
-        try:
-
-            run_carla_client(args, settings_generators)
-            return
-
-        except AssertionError as assertion:
-            raise assertion
-        except Exception as exception:
-            logging.error('exception: %s', exception)
-            time.sleep(1)
+    if args.sessions > 1:
+        run_sessions(args, settings_generators)
+    else:
+        run_session(args, settings_generators, args.port)
 
 
 if __name__ == '__main__':
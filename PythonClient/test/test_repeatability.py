@@ -21,6 +21,19 @@ from carla.client import make_carla_client
 from carla.sensor import Camera, Image
 from carla.settings import CarlaSettings
 from carla.tcp import TCPConnectionError
+from carla.util import StopWatch
+
+
+def measurements_are_identical(meas1, meas2):
+    """Compare two measurements messages bit by bit, except for the platform
+    timestamp which is wall-clock time."""
+    copy1 = type(meas1)()
+    copy1.CopyFrom(meas1)
+    copy1.platform_timestamp = 0
+    copy2 = type(meas2)()
+    copy2.CopyFrom(meas2)
+    copy2.platform_timestamp = 0
+    return copy1.SerializeToString() == copy2.SerializeToString()
 
 
 def run_carla_clients(args):
@@ -36,7 +49,9 @@ def run_carla_clients(args):
                 SendNonPlayerAgentsInfo=True,
                 NumberOfVehicles=50,
                 NumberOfPedestrians=50,
-                WeatherId=random.choice([1, 3, 7, 8, 14]))
+                WeatherId=random.choice([1, 3, 7, 8, 14]),
+                FixedTimeStep=args.time_step,
+                ReproducibleSimulation=args.reproducible)
             settings.randomize_seeds()
 
             if args.images_to_disk:
@@ -59,6 +74,8 @@ def run_carla_clients(args):
             client2.start_episode(player_start)
 
             frame = 0
+            mismatches = 0
+            watch = StopWatch()
             while True:
                 frame += 1
 
@@ -85,8 +102,21 @@ def run_carla_clients(args):
                     assert control1.brake == control2.brake
                     assert control1.hand_brake == control2.hand_brake
                     assert control1.reverse == control2.reverse
+                    if args.reproducible:
+                        assert measurements_are_identical(meas1, meas2)
+                        assert all(x.raw_data == y.raw_data for x, y in zip(images1, images2))
                 except AssertionError:
-                    logging.exception('assertion failed')
+                    mismatches += 1
+                    logging.exception('assertion failed at frame %d', frame)
+
+                if frame % 1000 == 0:
+                    watch.stop()
+                    logging.info(
+                        'frame %d: %.2f steps/second, %d frames with mismatches',
+                        frame,
+                        1000.0 / watch.seconds(),
+                        mismatches)
+                    watch.restart()
 
                 if args.images_to_disk:
                     assert len(images1) == 1
@@ -131,6 +161,16 @@ def main():
         default=3000,
         type=int,
         help='TCP port to listen to the second server (default: 3000)')
+    argparser.add_argument(
+        '-t', '--time-step',
+        metavar='S',
+        default=0.1,
+        type=float,
+        help='fixed time-step in seconds, 0 uses the command-line one (default: 0.1)')
+    argparser.add_argument(
+        '-r', '--reproducible',
+        action='store_true',
+        help='enable reproducible simulation and check every measurement is bit-identical')
     argparser.add_argument(
         '-i', '--images-to-disk',
         action='store_true',
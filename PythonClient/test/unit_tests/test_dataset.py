@@ -0,0 +1,156 @@
+import os
+import shutil
+import tempfile
+import unittest
+
+import numpy as np
+
+from carla import sensor
+from carla.carla_server_pb2 import Measurements
+from carla.dataset import Blob, DatasetReader, DatasetWriter, Encoding, blob_to_array
+from carla.dataset import ALIGNMENT, DATA_FILE, INDEX_FILE
+
+
+def make_image(frame, width=8, height=6, image_type='SceneFinal'):
+    raw_data = bytes(bytearray((frame + i) % 256 for i in range(4 * width * height)))
+    return sensor.Image(frame, width, height, image_type, 90.0, raw_data)
+
+
+def make_lidar(frame):
+    counts = np.array([3, 2], dtype=np.uint32)
+    points = np.arange(15, dtype=np.float32).reshape((5, 3)) + frame
+    return sensor.LidarMeasurement(frame, 12.5, 2, counts, sensor.PointCloud(frame, points))
+
+
+def make_measurements(frame):
+    measurements = Measurements()
+    measurements.frame_number = frame
+    measurements.player_measurements.forward_speed = 0.5 * frame
+    return measurements
+
+
+class testDataset(unittest.TestCase):
+
+    def setUp(self):
+        self._path = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self._path)
+
+    def write_frames(self, frames, **kwargs):
+        with DatasetWriter(self._path, **kwargs) as writer:
+            for frame in frames:
+                writer.add_frame(
+                    frame,
+                    measurements=make_measurements(frame),
+                    sensor_data={
+                        'CameraRGB': make_image(frame),
+                        'CameraDepth': make_image(frame, image_type='Depth'),
+                        'Lidar32': make_lidar(frame)})
+
+    def check_frame(self, frame, number):
+        self.assertEqual(frame.frame_number, number)
+        self.assertEqual(frame.measurements.frame_number, number)
+        self.assertAlmostEqual(frame.measurements.player_measurements.forward_speed, 0.5 * number)
+        data = frame.sensor_data
+        self.assertEqual(sorted(data.keys()), ['CameraDepth', 'CameraRGB', 'Lidar32'])
+        expected = make_image(number)
+        self.assertEqual(data['CameraRGB'].type, 'SceneFinal')
+        self.assertEqual(data['CameraRGB'].width, expected.width)
+        self.assertEqual(data['CameraRGB'].height, expected.height)
+        self.assertEqual(bytes(data['CameraRGB'].raw_data), expected.raw_data)
+        self.assertEqual(data['CameraDepth'].type, 'Depth')
+        lidar = make_lidar(number)
+        self.assertEqual(data['Lidar32'].channels, 2)
+        self.assertAlmostEqual(data['Lidar32'].horizontal_angle, 12.5)
+        self.assertEqual(list(data['Lidar32'].point_count_by_channel), [3, 2])
+        self.assertTrue(np.array_equal(data['Lidar32'].data, lidar.data))
+
+    def test_write_and_read(self):
+        self.write_frames(range(10))
+        with DatasetReader(self._path) as reader:
+            self.assertEqual(len(reader), 10)
+            for number, frame in enumerate(reader):
+                self.check_frame(frame, number)
+            self.check_frame(reader[-1], 9)
+            self.assertRaises(IndexError, lambda: reader[10])
+
+    def test_blobs_are_aligned(self):
+        self.write_frames(range(3))
+        with DatasetReader(self._path) as reader:
+            for frame in reader:
+                for blob in frame.blobs:
+                    address = np.frombuffer(blob.data, dtype=np.uint8).ctypes.data
+                    self.assertEqual(address % ALIGNMENT, 0)
+
+    def test_append(self):
+        self.write_frames(range(5))
+        self.write_frames(range(5, 8))
+        with DatasetReader(self._path) as reader:
+            self.assertEqual(len(reader), 8)
+            self.assertEqual(list(reader.frame_numbers()), list(range(8)))
+            for number, frame in enumerate(reader):
+                self.check_frame(frame, number)
+
+    def test_find_frame(self):
+        self.write_frames([10, 11, 12, 20, 25])
+        with DatasetReader(self._path) as reader:
+            self.check_frame(reader.find_frame(11), 11)
+            self.check_frame(reader.find_frame(20), 20)
+            self.check_frame(reader.find_frame(25), 25)
+            self.assertRaises(KeyError, reader.find_frame, 13)
+            self.assertRaises(KeyError, reader.find_frame, 9)
+            self.assertRaises(KeyError, reader.find_frame, 26)
+
+    def test_interrupted_writer(self):
+        self.write_frames(range(4))
+        # Half a record and half an index entry, as if the writer was killed.
+        with open(os.path.join(self._path, DATA_FILE), 'ab') as f:
+            f.write(b'\xff' * 100)
+        with open(os.path.join(self._path, INDEX_FILE), 'ab') as f:
+            f.write(b'\xff' * 10)
+        with DatasetReader(self._path) as reader:
+            self.assertEqual(len(reader), 4)
+        self.write_frames([4])
+        with DatasetReader(self._path) as reader:
+            self.assertEqual(len(reader), 5)
+            for number, frame in enumerate(reader):
+                self.check_frame(frame, number)
+
+    def test_raw_blobs(self):
+        pixels = np.arange(4 * 5 * 3, dtype=np.uint8)
+        with DatasetWriter(self._path) as writer:
+            writer.add_blobs(7, [
+                Blob('CameraRGB', Encoding.RGB, 4, 5, 90.0, pixels.tobytes()),
+                Blob('extra', Encoding.RAW, 0, 0, 0.0, b'hello')])
+        with DatasetReader(self._path) as reader:
+            frame = reader.find_frame(7)
+            self.assertIsNone(frame.measurements)
+            data = frame.sensor_data
+            self.assertEqual(bytes(data['extra'].data), b'hello')
+            array = blob_to_array(data['CameraRGB'])
+            self.assertEqual(array.shape, (5, 4, 3))
+            self.assertTrue(np.array_equal(array.flatten(), pixels))
+            self.assertRaises(ValueError, blob_to_array, data['extra'])
+
+    def test_compressed_images(self):
+        try:
+            import PIL
+        except ImportError:
+            self.skipTest('PIL not installed')
+        image = make_image(3)
+        with DatasetWriter(self._path, compress_images=True) as writer:
+            writer.add_frame(3, sensor_data={'CameraRGB': image})
+        with DatasetReader(self._path) as reader:
+            blob = reader[0].sensor_data['CameraRGB']
+            self.assertEqual(blob.encoding, Encoding.PNG)
+            bgra = np.frombuffer(image.raw_data, dtype=np.uint8).reshape((6, 8, 4))
+            self.assertTrue(np.array_equal(blob_to_array(blob), bgra[:, :, 2::-1]))
+
+    def test_not_a_dataset(self):
+        with open(os.path.join(self._path, DATA_FILE), 'wb') as f:
+            f.write(b'this is not a dataset')
+        with open(os.path.join(self._path, INDEX_FILE), 'wb') as f:
+            f.write(b'this is not a dataset')
+        self.assertRaises(ValueError, DatasetReader, self._path)
+        self.assertRaises(ValueError, DatasetWriter, self._path)
@@ -0,0 +1,69 @@
+import struct
+import unittest
+from carla.client import _parse_sensor_data, SharedMemoryOverwrittenError
+
+
+class _RawParser(object):
+    name = 'Camera'
+
+    @staticmethod
+    def parse_raw_data(data):
+        return data
+
+
+def _write_slot(region, offset, sequence, data):
+    """Write a slot as the server does, [sequence, size, data, sequence]."""
+    struct.pack_into('<QQ', region, offset, sequence, len(data))
+    region[offset + 16:offset + 16 + len(data)] = data
+    struct.pack_into('<Q', region, offset + 16 + len(data), sequence)
+
+
+def _reference(sensor_id, offset, size, sequence):
+    return struct.pack('<LQLQ', sensor_id | 0x80000000, offset, size, sequence)
+
+
+class testSharedMemory(unittest.TestCase):
+
+    def setUp(self):
+        self.region = bytearray(1024)
+        self.sensors = {7: _RawParser()}
+
+    def test_read_slot(self):
+        """
+            The data of a slot is read through its reference.
+        """
+        _write_slot(self.region, 32, 5, b'sensor data')
+        name, data = _parse_sensor_data(
+            self.sensors, _reference(7, 32, 11, 5), lambda: self.region)
+        self.assertEqual(name, 'Camera')
+        self.assertEqual(data, b'sensor data')
+
+    def test_client_lags_behind(self):
+        """
+            A slot overwritten before being read raises instead of returning
+            the data of another frame.
+        """
+        _write_slot(self.region, 32, 5, b'sensor data')
+        reference = _reference(7, 32, 11, 5)
+        # The server wrapped around the region and reused the slot.
+        _write_slot(self.region, 0, 9, b'x' * 100)
+        with self.assertRaises(SharedMemoryOverwrittenError):
+            _parse_sensor_data(self.sensors, reference, lambda: self.region)
+
+    def test_slot_partially_overwritten(self):
+        """
+            A slot whose end marker was overwritten is detected too.
+        """
+        _write_slot(self.region, 32, 5, b'sensor data')
+        reference = _reference(7, 32, 11, 5)
+        _write_slot(self.region, 48, 9, b'y' * 8)
+        with self.assertRaises(SharedMemoryOverwrittenError):
+            _parse_sensor_data(self.sensors, reference, lambda: self.region)
+
+    def test_invalid_location(self):
+        """
+            A reference outside the region is rejected.
+        """
+        with self.assertRaises(RuntimeError):
+            _parse_sensor_data(
+                self.sensors, _reference(7, 1020, 11, 5), lambda: self.region)
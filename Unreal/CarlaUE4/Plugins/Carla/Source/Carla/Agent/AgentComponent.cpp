@@ -14,12 +14,18 @@
 #include "Engine/Engine.h"
 #include "Kismet/GameplayStatics.h"
 
-static FDataRouter &GetDataRouter(UWorld *World)
+/// The data router is reached through the game mode if we are the host,
+/// otherwise through the game instance. Return nullptr if not available.
+static FDataRouter *GetDataRouter(UWorld *World)
 {
   check(World != nullptr);
-  ACarlaGameModeBase *GameMode = Cast<ACarlaGameModeBase>(World->GetAuthGameMode());
-  check(GameMode != nullptr);
-  return GameMode->GetDataRouter();
+  ACarlaGameModeBase *GameMode = Cast<ACarlaGameModeBase>(UGameplayStatics::GetGameMode(World));
+  if (GameMode != nullptr)
+  {
+    return &GameMode->GetDataRouter();
+  }
+  UCarlaGameInstance *GameInstance = Cast<UCarlaGameInstance>(UGameplayStatics::GetGameInstance(World));
+  return (GameInstance != nullptr ? &GameInstance->GetDataRouter() : nullptr);
 }
 
 UAgentComponent::UAgentComponent(const FObjectInitializer& ObjectInitializer)
@@ -42,42 +48,44 @@ void UAgentComponent::BeginPlay()
 
   if (bRegisterAgentComponent)
   {
-    /**
-      * This only returns true if the current game mode is not null
-      * because you can only access a game mode if you are the host
-      * @param oftheworld UWorld is needed to access the game mode
-      * @return true if there is a game mode and it is not null
-     */
-    if(UGameplayStatics::GetGameMode(GetWorld())!=nullptr)
-    {
-      GetDataRouter(GetWorld()).RegisterAgent(this);
-    } else
-    {
-        UCarlaGameInstance* GameInstance = Cast<UCarlaGameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
-        if(GameInstance)    GameInstance->GetDataRouter().RegisterAgent(this);
-    }
-    bAgentComponentIsRegistered = true;
+    RegisterAgentComponent();
   }
 }
 
 void UAgentComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+  DeregisterAgentComponent();
+
+  Super::EndPlay(EndPlayReason);
+}
+
+void UAgentComponent::RegisterAgentComponent()
 {
   if (bAgentComponentIsRegistered)
   {
-    if(UGameplayStatics::GetGameMode(GetWorld())!=nullptr)
-    {
-     GetDataRouter(GetWorld()).DeregisterAgent(this);
-    }
-    else
+    return;
+  }
+  FDataRouter *DataRouter = GetDataRouter(GetWorld());
+  if (DataRouter != nullptr)
+  {
+    // A pooled agent registered again is a new agent for the client.
+    Id = DataRouter->GenerateAgentId();
+    DataRouter->RegisterAgent(this);
+  }
+  bAgentComponentIsRegistered = true;
+}
+
+void UAgentComponent::DeregisterAgentComponent()
+{
+  if (bAgentComponentIsRegistered)
+  {
+    FDataRouter *DataRouter = GetDataRouter(GetWorld());
+    if (DataRouter != nullptr)
     {
-        UCarlaGameInstance* GameInstance = Cast<UCarlaGameInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
-        if(GameInstance)
-           GameInstance->GetDataRouter().DeregisterAgent(this);
+      DataRouter->DeregisterAgent(this);
     }
     bAgentComponentIsRegistered = false;
   }
-
-  Super::EndPlay(EndPlayReason);
 }
 
 void UAgentComponent::ApplyAIControl(const FSingleAgentControl &Control) {
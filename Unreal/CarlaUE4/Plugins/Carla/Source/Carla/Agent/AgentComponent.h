@@ -25,15 +25,25 @@ public:
 
   UAgentComponent(const FObjectInitializer& ObjectInitializer);
 
+  /// Id of this agent, assigned each time the component is registered.
   uint32 GetId() const
   {
-    return GetTypeHash(this);
+    return Id;
   }
 
   virtual void AcceptVisitor(IAgentComponentVisitor &Visitor) const;
 
 
   virtual void ApplyAIControl(const FSingleAgentControl &Control);
+
+  /// Register this agent in the data router, does nothing if already
+  /// registered. Called at begin play if bRegisterAgentComponent is set.
+  void RegisterAgentComponent();
+
+  /// Remove this agent from the data router, e.g. while its owner is kept
+  /// inactive in a pool. Called at end play.
+  void DeregisterAgentComponent();
+
 protected:
 
   virtual void BeginPlay() override;
@@ -51,4 +61,7 @@ private:
   /** Whether this component has been registered. */
   UPROPERTY(Category = "Agent Component", VisibleAnywhere, AdvancedDisplay)
   bool bAgentComponentIsRegistered = false;
+
+  UPROPERTY(Category = "Agent Component", VisibleAnywhere, AdvancedDisplay)
+  uint32 Id = 0u;
 };
@@ -0,0 +1,162 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "AgentSpatialIndex.h"
+
+#include "Agent/AgentComponent.h"
+
+// =============================================================================
+// -- Static local methods -----------------------------------------------------
+// =============================================================================
+
+static FVector GetAgentLocation(const UAgentComponent &Agent)
+{
+  const AActor *Owner = Agent.GetOwner();
+  check(Owner != nullptr);
+  return Owner->GetActorLocation();
+}
+
+// =============================================================================
+// -- FAgentSpatialIndex -------------------------------------------------------
+// =============================================================================
+
+FAgentSpatialIndex::FAgentSpatialIndex(const float InCellSize)
+  : CellSize(InCellSize)
+{
+  check(CellSize > 0.0f);
+}
+
+void FAgentSpatialIndex::Add(UAgentComponent &Agent)
+{
+  const uint32 Id = Agent.GetId();
+  if (SlotById.Contains(Id)) {
+    UE_LOG(LogCarla, Warning, TEXT("FAgentSpatialIndex: Agent %u already registered"), Id);
+    return;
+  }
+  const FVector Location = GetAgentLocation(Agent);
+  const int32 Slot = Agents.Add(&Agent);
+  Entries.Add(FEntry{Location, GetCell(Location)});
+  SlotById.Add(Id, Slot);
+  AddToCell(Entries[Slot].Cell, Slot);
+}
+
+void FAgentSpatialIndex::Remove(const UAgentComponent &Agent)
+{
+  int32 Slot;
+  if (!SlotById.RemoveAndCopyValue(Agent.GetId(), Slot)) {
+    return;
+  }
+  RemoveFromCell(Entries[Slot].Cell, Slot);
+  const int32 LastSlot = Agents.Num() - 1;
+  if (Slot != LastSlot) {
+    // The last agent is moved into the freed slot, fix its references.
+    const FIntPoint &MovedCell = Entries[LastSlot].Cell;
+    RemoveFromCell(MovedCell, LastSlot);
+    AddToCell(MovedCell, Slot);
+    SlotById[Agents[LastSlot]->GetId()] = Slot;
+  }
+  Agents.RemoveAtSwap(Slot, 1, false);
+  Entries.RemoveAtSwap(Slot, 1, false);
+}
+
+void FAgentSpatialIndex::Update()
+{
+  for (int32 Slot = 0; Slot < Entries.Num(); ++Slot) {
+    FEntry &Entry = Entries[Slot];
+    Entry.Location = GetAgentLocation(*Agents[Slot]);
+    const FIntPoint Cell = GetCell(Entry.Location);
+    if (Cell != Entry.Cell) {
+      RemoveFromCell(Entry.Cell, Slot);
+      AddToCell(Cell, Slot);
+      Entry.Cell = Cell;
+    }
+  }
+}
+
+void FAgentSpatialIndex::Reset()
+{
+  Agents.Reset();
+  Entries.Reset();
+  SlotById.Reset();
+  Cells.Reset();
+}
+
+UAgentComponent *FAgentSpatialIndex::FindAgent(const uint32 Id) const
+{
+  const int32 *Slot = SlotById.Find(Id);
+  return (Slot != nullptr ? Agents[*Slot] : nullptr);
+}
+
+const FVector &FAgentSpatialIndex::GetLocation(const UAgentComponent &Agent) const
+{
+  return Entries[SlotById.FindChecked(Agent.GetId())].Location;
+}
+
+template <typename F>
+void FAgentSpatialIndex::ForEachEntryIn(
+    const FVector2D &Min,
+    const FVector2D &Max,
+    F &&Functor) const
+{
+  const FIntPoint MinCell = GetCell(FVector(Min, 0.0f));
+  const FIntPoint MaxCell = GetCell(FVector(Max, 0.0f));
+  const int64 NumberOfCells =
+      static_cast<int64>(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1);
+  if (NumberOfCells > Cells.Num()) {
+    // Cheaper to go through the occupied cells only.
+    for (const auto &Item : Cells) {
+      const FIntPoint &Cell = Item.Key;
+      if ((Cell.X >= MinCell.X) && (Cell.X <= MaxCell.X) &&
+          (Cell.Y >= MinCell.Y) && (Cell.Y <= MaxCell.Y)) {
+        for (int32 Slot : Item.Value) {
+          Functor(Slot);
+        }
+      }
+    }
+  } else {
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+      for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+        if (const TArray<int32> *Slots = Cells.Find(FIntPoint(X, Y))) {
+          for (int32 Slot : *Slots) {
+            Functor(Slot);
+          }
+        }
+      }
+    }
+  }
+}
+
+void FAgentSpatialIndex::FindInBox(
+    const FTransform &BoxTransform,
+    const FVector &Extent,
+    TArray<UAgentComponent *> &OutAgents) const
+{
+  const FBox Bounds = FBox(-Extent, Extent).TransformBy(BoxTransform);
+  ForEachEntryIn(FVector2D(Bounds.Min), FVector2D(Bounds.Max), [&](const int32 Slot) {
+    const FVector Local = BoxTransform.InverseTransformPosition(Entries[Slot].Location);
+    if ((FMath::Abs(Local.X) <= Extent.X) &&
+        (FMath::Abs(Local.Y) <= Extent.Y) &&
+        (FMath::Abs(Local.Z) <= Extent.Z)) {
+      OutAgents.Add(Agents[Slot]);
+    }
+  });
+}
+
+void FAgentSpatialIndex::AddToCell(const FIntPoint &Cell, const int32 Slot)
+{
+  Cells.FindOrAdd(Cell).Add(Slot);
+}
+
+void FAgentSpatialIndex::RemoveFromCell(const FIntPoint &Cell, const int32 Slot)
+{
+  TArray<int32> *Slots = Cells.Find(Cell);
+  check(Slots != nullptr);
+  Slots->RemoveSingleSwap(Slot, false);
+  if (Slots->Num() == 0) {
+    Cells.Remove(Cell);
+  }
+}
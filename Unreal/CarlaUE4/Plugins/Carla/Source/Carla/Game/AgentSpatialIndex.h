@@ -0,0 +1,114 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "Util/NonCopyable.h"
+
+class UAgentComponent;
+
+/// Uniform grid over the XY plane holding the location of every registered
+/// agent. Locations are refreshed once per tick with Update(), agents are
+/// only moved between cells when they cross a cell boundary.
+///
+/// Agents are also indexed by id, so looking up an agent given its id is
+/// constant time. The index is the owner of the list of registered agents,
+/// see FDataRouter.
+class FAgentSpatialIndex : private NonCopyable
+{
+public:
+
+  /// Default size of the grid cells in centimeters.
+  static constexpr float DefaultCellSize = 2000.0f;
+
+  explicit FAgentSpatialIndex(float InCellSize = DefaultCellSize);
+
+  // ===========================================================================
+  /// @name Modifiers
+  // ===========================================================================
+  /// @{
+
+  void Add(UAgentComponent &Agent);
+
+  void Remove(const UAgentComponent &Agent);
+
+  /// Refresh the location of every agent in the index.
+  void Update();
+
+  void Reset();
+
+  /// @}
+  // ===========================================================================
+  /// @name Queries
+  // ===========================================================================
+  /// @{
+
+  int32 Num() const
+  {
+    return Agents.Num();
+  }
+
+  /// Every registered agent, in no particular order.
+  const TArray<UAgentComponent *> &GetAgents() const
+  {
+    return Agents;
+  }
+
+  /// Return the agent with the given @a Id, or nullptr if not registered.
+  UAgentComponent *FindAgent(uint32 Id) const;
+
+  /// Location of @a Agent as of the last Update().
+  ///
+  /// @pre @a Agent is registered in the index.
+  const FVector &GetLocation(const UAgentComponent &Agent) const;
+
+  /// Append to @a OutAgents the agents whose location lies inside the
+  /// oriented box defined by @a BoxTransform and @a Extent.
+  void FindInBox(
+      const FTransform &BoxTransform,
+      const FVector &Extent,
+      TArray<UAgentComponent *> &OutAgents) const;
+
+  /// @}
+
+private:
+
+  struct FEntry
+  {
+    FVector Location;
+
+    FIntPoint Cell;
+  };
+
+  FIntPoint GetCell(const FVector &Location) const
+  {
+    return {
+        FMath::FloorToInt(Location.X / CellSize),
+        FMath::FloorToInt(Location.Y / CellSize)};
+  }
+
+  void AddToCell(const FIntPoint &Cell, int32 Slot);
+
+  void RemoveFromCell(const FIntPoint &Cell, int32 Slot);
+
+  /// Call @a Functor with the slot of every agent in the cells overlapping
+  /// the given rectangle of the XY plane.
+  template <typename F>
+  void ForEachEntryIn(const FVector2D &Min, const FVector2D &Max, F &&Functor) const;
+
+  const float CellSize;
+
+  /// Agents and their entries share the same slot.
+  TArray<UAgentComponent *> Agents;
+
+  TArray<FEntry> Entries;
+
+  /// Agent id to its slot.
+  TMap<uint32, int32> SlotById;
+
+  /// Cell to the slots of the agents inside.
+  TMap<FIntPoint, TArray<int32>> Cells;
+};
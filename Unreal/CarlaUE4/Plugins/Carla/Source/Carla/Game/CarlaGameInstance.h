@@ -10,6 +10,7 @@
 
 #include "Game/CarlaGameControllerBase.h"
 #include "Game/DataRouter.h"
+#include "Game/TickScheduler.h"
 
 #include "CarlaGameInstance.generated.h"
 
@@ -62,6 +63,11 @@ public:
     return DataRouter;
   }
 
+  FTickScheduler &GetTickScheduler()
+  {
+    return TickScheduler;
+  }
+
 private:
 
   UPROPERTY(Category = "CARLA Settings", EditAnywhere)
@@ -69,5 +75,7 @@ private:
 
   FDataRouter DataRouter;
 
+  FTickScheduler TickScheduler;
+
   TUniquePtr<ICarlaGameControllerBase> GameController;
 };
@@ -16,6 +16,8 @@
 #include "Sensor/SensorFactory.h"
 #include "Settings/CarlaSettings.h"
 #include "Settings/CarlaSettingsDelegate.h"
+#include "Settings/SensorDescription.h"
+#include "Traffic/TrafficLightBase.h"
 #include "Util/RandomEngine.h"
 #include "Vehicle/CarlaVehicleController.h"
 
@@ -23,7 +25,9 @@
 #include "Engine/PlayerStartPIE.h"
 #include "EngineUtils.h"
 #include "GameFramework/PlayerStart.h"
+#include "Misc/App.h"
 #include "SceneViewport.h"
+#include "UObject/UObjectGlobals.h"
 
 ACarlaGameModeBase::ACarlaGameModeBase(const FObjectInitializer& ObjectInitializer) :
   Super(ObjectInitializer),
@@ -55,6 +59,7 @@ void ACarlaGameModeBase::InitGame(
       TEXT("GameInstance is not a UCarlaGameInstance, did you forget to set it in the project settings?"));
 
   GameInstance->InitializeGameControllerIfNotPresent(MockGameControllerSettings);
+  GameInstance->GetDataRouter().ResetAgentIds();
   GameController = &GameInstance->GetGameController();
   auto &CarlaSettings = GameInstance->GetCarlaSettings();
   UWorld *world = GetWorld();
@@ -118,8 +123,8 @@ void ACarlaGameModeBase::InitGame(
     WalkerSpawner = world->SpawnActor<AWalkerSpawnerBase>(WalkerSpawnerClass);
   }
 
-
-
+  // Before any agent begins play and registers with the scheduler.
+  ApplyTickSchedule(CarlaSettings);
 }
 
 void ACarlaGameModeBase::RestartPlayer(AController* NewPlayer)
@@ -155,7 +160,158 @@ void ACarlaGameModeBase::BeginPlay()
     TaggerDelegate->SetSemanticSegmentationEnabled();
   }
 
-  // Change weather.
+  ApplyTimeStep(CarlaSettings);
+  ChangeWeather(CarlaSettings);
+
+  // Find road map.
+  TActorIterator<ACityMapGenerator> It(GetWorld());
+  URoadMap *RoadMap = (It ? It->GetRoadMap() : nullptr);
+
+  if (PlayerController != nullptr) {
+    PlayerController->SetRoadMap(RoadMap);
+  } else {
+    UE_LOG(LogCarla, Error, TEXT("Player controller is not a AWheeledVehicleAIController!"));
+  }
+
+  if (VehicleSpawner != nullptr) {
+    VehicleSpawner->SetRoadMap(RoadMap);
+  }
+
+  SetupSpawners(CarlaSettings);
+
+  PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(
+      this,
+      &ACarlaGameModeBase::OnPreGarbageCollect);
+  PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+      this,
+      &ACarlaGameModeBase::OnPostGarbageCollect);
+
+  GameController->BeginPlay();
+}
+
+void ACarlaGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+  FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+  FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+  if (GarbageCollectCount > 0u) {
+    UE_LOG(
+        LogCarla,
+        Log,
+        TEXT("%u garbage collections during play, %.2f ms in total"),
+        GarbageCollectCount,
+        1e3 * GarbageCollectTotalTime);
+  }
+  GameInstance->GetTickScheduler().LogStats();
+  GameInstance->GetTickScheduler().ResetStats();
+	Super::EndPlay(EndPlayReason);
+	if (CarlaSettingsDelegate != nullptr && EndPlayReason!=EEndPlayReason::EndPlayInEditor)
+	{
+	  CarlaSettingsDelegate->Reset();
+	}
+}
+
+void ACarlaGameModeBase::Tick(float DeltaSeconds)
+{
+  Super::Tick(DeltaSeconds);
+  GetDataRouter().UpdateAgentSpatialIndex();
+  if (WalkerSpawner != nullptr) {
+    WalkerSpawner->UpdateVehicleConflicts();
+  }
+  GameController->Tick(DeltaSeconds);
+}
+
+bool ACarlaGameModeBase::SoftResetEpisode()
+{
+  check(GameController != nullptr);
+  APawn *Pawn = (PlayerController != nullptr ? PlayerController->GetPawn() : nullptr);
+  if (Pawn == nullptr) {
+    UE_LOG(LogCarla, Warning, TEXT("Cannot soft reset the episode without a player pawn"));
+    return false;
+  }
+  const double StartTime = FPlatformTime::Seconds();
+
+  auto &CarlaSettings = GameInstance->GetCarlaSettings();
+  CarlaSettings.ValidateWeatherId();
+  CarlaSettings.LogSettings();
+
+  // Remove non-player agents so they don't occupy the start spots.
+  if (VehicleSpawner != nullptr) {
+    VehicleSpawner->ReleaseVehicles();
+  }
+  if (WalkerSpawner != nullptr) {
+    WalkerSpawner->ReleaseWalkers();
+  }
+  // Agents spawned from now on get the same ids as in a fresh episode.
+  GameInstance->GetDataRouter().ResetAgentIds();
+
+  // The player shouldn't occupy a start spot either.
+  TArray<APlayerStart *> UnOccupiedStartPoints;
+  Pawn->SetActorEnableCollision(false);
+  FindUnOccupiedStartPoints(PlayerController, UnOccupiedStartPoints);
+  Pawn->SetActorEnableCollision(true);
+  if (UnOccupiedStartPoints.Num() == 0) {
+    UE_LOG(LogCarla, Warning, TEXT("Cannot soft reset the episode, no start spot found"));
+    return false;
+  }
+
+  // Move the player to the start spot chosen by the client.
+  APlayerStart *StartSpot = GameController->ChoosePlayerStart(UnOccupiedStartPoints);
+  check(StartSpot != nullptr);
+  Pawn->SetActorLocationAndRotation(
+      StartSpot->GetActorLocation(),
+      StartSpot->GetActorRotation(),
+      false,
+      nullptr,
+      ETeleportType::TeleportPhysics);
+  auto *Root = Cast<UPrimitiveComponent>(Pawn->GetRootComponent());
+  if (Root != nullptr) {
+    Root->SetPhysicsLinearVelocity(FVector::ZeroVector);
+    Root->SetPhysicsAngularVelocity(FVector::ZeroVector);
+  }
+  if (PlayerController->IsPossessingAVehicle()) {
+    PlayerController->GetPossessedVehicle()->ApplyVehicleControl(FVehicleControl());
+  }
+  auto *PlayerState = Cast<ACarlaPlayerState>(PlayerController->PlayerState);
+  if (PlayerState != nullptr) {
+    PlayerState->Reset();
+  }
+
+  // Sensors were created for the previous weather, adjust the new
+  // descriptions the same way (see UCarlaSettings::CanSoftReset).
+  const auto *Weather = CarlaSettings.GetActiveWeatherDescription();
+  if (Weather != nullptr) {
+    for (auto &Item : CarlaSettings.SensorDescriptions) {
+      check(Item.Value != nullptr);
+      Item.Value->AdjustToWeather(*Weather);
+    }
+  }
+  ApplyTimeStep(CarlaSettings);
+  ChangeWeather(CarlaSettings);
+  GameInstance->GetTickScheduler().LogStats();
+  GameInstance->GetTickScheduler().ResetStats();
+  ApplyTickSchedule(CarlaSettings);
+
+  // Respawn non-player agents with the new settings.
+  SetupSpawners(CarlaSettings);
+  if (VehicleSpawner != nullptr) {
+    VehicleSpawner->SpawnVehicles();
+  }
+  if (WalkerSpawner != nullptr) {
+    WalkerSpawner->QueueInitialWalkers();
+  }
+
+  GameController->BeginPlay();
+
+  UE_LOG(
+      LogCarla,
+      Log,
+      TEXT("Episode soft reset in %.2f ms"),
+      1e3 * (FPlatformTime::Seconds() - StartTime));
+  return true;
+}
+
+void ACarlaGameModeBase::ChangeWeather(const UCarlaSettings &CarlaSettings)
+{
   if (DynamicWeather != nullptr) {
     const auto *Weather = CarlaSettings.GetActiveWeatherDescription();
     if (Weather != nullptr) {
@@ -166,22 +322,39 @@ void ACarlaGameModeBase::BeginPlay()
   } else {
     UE_LOG(LogCarla, Error, TEXT("Missing dynamic weather actor!"));
   }
+}
 
-  // Find road map.
-  TActorIterator<ACityMapGenerator> It(GetWorld());
-  URoadMap *RoadMap = (It ? It->GetRoadMap() : nullptr);
+void ACarlaGameModeBase::ApplyTimeStep(const UCarlaSettings &CarlaSettings)
+{
+  // The first time we get here FApp holds the command-line values.
+  static const bool bCommandLineUseFixedTimeStep = FApp::UseFixedTimeStep();
+  static const double CommandLineFixedDeltaTime = FApp::GetFixedDeltaTime();
 
-  if (PlayerController != nullptr) {
-    PlayerController->SetRoadMap(RoadMap);
+  if (CarlaSettings.FixedTimeStep > 0.0f) {
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(CarlaSettings.FixedTimeStep);
   } else {
-    UE_LOG(LogCarla, Error, TEXT("Player controller is not a AWheeledVehicleAIController!"));
+    FApp::SetUseFixedTimeStep(bCommandLineUseFixedTimeStep);
+    FApp::SetFixedDeltaTime(CommandLineFixedDeltaTime);
+  }
+
+  if (CarlaSettings.bReproducibleSimulation) {
+    const bool bFixedTimeStep = FApp::UseFixedTimeStep() || FApp::IsBenchmarking();
+    if (!bFixedTimeStep || !CarlaSettings.bSynchronousMode) {
+      UE_LOG(
+          LogCarla,
+          Warning,
+          TEXT("Reproducible simulation requires synchronous mode and a fixed time step"));
+    }
   }
+}
 
+void ACarlaGameModeBase::SetupSpawners(const UCarlaSettings &CarlaSettings)
+{
   // Setup other vehicles.
   if (VehicleSpawner != nullptr) {
     VehicleSpawner->SetNumberOfVehicles(CarlaSettings.NumberOfVehicles);
     VehicleSpawner->SetSeed(CarlaSettings.SeedVehicles);
-    VehicleSpawner->SetRoadMap(RoadMap);
     if (PlayerController != nullptr) {
       PlayerController->GetRandomEngine()->Seed(
           VehicleSpawner->GetRandomEngine()->GenerateSeed());
@@ -194,26 +367,36 @@ void ACarlaGameModeBase::BeginPlay()
   if (WalkerSpawner != nullptr) {
     WalkerSpawner->SetNumberOfWalkers(CarlaSettings.NumberOfPedestrians);
     WalkerSpawner->SetSeed(CarlaSettings.SeedPedestrians);
+    WalkerSpawner->SetReproducible(CarlaSettings.bReproducibleSimulation);
   } else {
     UE_LOG(LogCarla, Error, TEXT("Missing walker spawner actor!"));
   }
-
-  GameController->BeginPlay();
-}
-
-void ACarlaGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
-	Super::EndPlay(EndPlayReason);
-	if (CarlaSettingsDelegate != nullptr && EndPlayReason!=EEndPlayReason::EndPlayInEditor)
-	{
-	  CarlaSettingsDelegate->Reset();
-	}
 }
 
-void ACarlaGameModeBase::Tick(float DeltaSeconds)
+void ACarlaGameModeBase::ApplyTickSchedule(const UCarlaSettings &CarlaSettings)
 {
-  Super::Tick(DeltaSeconds);
-  GameController->Tick(DeltaSeconds);
+  auto &TickScheduler = GameInstance->GetTickScheduler();
+  TickScheduler.Configure(CarlaSettings);
+
+  // Traffic lights and spawners tick as a whole, the actor tick interval is
+  // enough for them.
+  const float TrafficLightTickInterval = TickScheduler.GetTickInterval(ETickSubsystem::TrafficLights);
+  for (TActorIterator<ATrafficLightBase> It(GetWorld()); It; ++It) {
+    It->SetActorTickInterval(TrafficLightTickInterval);
+  }
+  const float SpawnerTickInterval = TickScheduler.GetTickInterval(ETickSubsystem::Spawners);
+  if (VehicleSpawner != nullptr) {
+    VehicleSpawner->SetActorTickInterval(SpawnerTickInterval);
+  }
+  if (WalkerSpawner != nullptr) {
+    WalkerSpawner->SetActorTickInterval(SpawnerTickInterval);
+    const auto *Defaults = WalkerSpawner->GetClass()->GetDefaultObject<AWalkerSpawnerBase>();
+    check(Defaults != nullptr);
+    WalkerSpawner->SetTickBudget(
+        CarlaSettings.SpawnerTickBudget > 0.0f ?
+            1e3f * CarlaSettings.SpawnerTickBudget :
+            Defaults->GetTickBudget());
+  }
 }
 
 void ACarlaGameModeBase::RegisterPlayer(AController &NewPlayer)
@@ -247,6 +430,9 @@ void ACarlaGameModeBase::AttachSensorsToPlayer()
     auto *Sensor = FSensorFactory::Make(SensorDescription, *GetWorld());
     check(Sensor != nullptr);
     Sensor->AttachToActor(PlayerController->GetPawn());
+    // Sensors tick first so their data is already on its way when the
+    // measurements of the same frame are sent.
+    AddTickPrerequisiteActor(Sensor);
     GetDataRouter().RegisterSensor(*Sensor);
   }
 }
@@ -257,6 +443,19 @@ void ACarlaGameModeBase::TagActorsForSemanticSegmentation()
   ATagger::TagActorsInLevel(*GetWorld(), true);
 }
 
+void ACarlaGameModeBase::OnPreGarbageCollect()
+{
+  GarbageCollectStartTime = FPlatformTime::Seconds();
+}
+
+void ACarlaGameModeBase::OnPostGarbageCollect()
+{
+  const double Elapsed = FPlatformTime::Seconds() - GarbageCollectStartTime;
+  GarbageCollectTotalTime += Elapsed;
+  ++GarbageCollectCount;
+  UE_LOG(LogCarla, Log, TEXT("Garbage collection took %.2f ms"), 1e3 * Elapsed);
+}
+
 APlayerStart *ACarlaGameModeBase::FindUnOccupiedStartPoints(
     AController *Player,
     TArray<APlayerStart *> &UnOccupiedStartPoints)
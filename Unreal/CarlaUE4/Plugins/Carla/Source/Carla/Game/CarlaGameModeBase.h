@@ -21,6 +21,7 @@ class ACarlaVehicleController;
 class APlayerStart;
 class ASceneCaptureCamera;
 class UCarlaGameInstance;
+class UCarlaSettings;
 class UTaggerDelegate;
 class UCarlaSettingsDelegate;
 UCLASS(HideCategories=(ActorTick))
@@ -48,6 +49,21 @@ public:
     return GameInstance->GetDataRouter();
   }
 
+  /// Start a new episode without reloading the level, the settings must have
+  /// been already updated (see UCarlaSettings::CanSoftReset). The player is
+  /// moved to the start spot chosen by the client and the non-player agents
+  /// are respawned.
+  ///
+  /// @return false if the episode could not be reset, in which case the level
+  /// should be restarted.
+  bool SoftResetEpisode();
+
+  /// Null if the level has no pedestrian spawner.
+  const AWalkerSpawnerBase *GetWalkerSpawner() const
+  {
+    return WalkerSpawner;
+  }
+
   UFUNCTION(BlueprintPure, Category="CARLA Settings")
   UCarlaSettingsDelegate *GetCARLASettingsDelegate()
   {
@@ -76,10 +92,28 @@ private:
 
   void RegisterPlayer(AController &NewPlayer);
 
+  void ChangeWeather(const UCarlaSettings &CarlaSettings);
+
+  /// Apply the fixed time step requested for this episode, or restore the
+  /// one given in the command-line.
+  void ApplyTimeStep(const UCarlaSettings &CarlaSettings);
+
+  void SetupSpawners(const UCarlaSettings &CarlaSettings);
+
+  /// Configure the tick scheduler for this episode and apply its intervals
+  /// to the actors that tick on their own (traffic lights and spawners).
+  void ApplyTickSchedule(const UCarlaSettings &CarlaSettings);
+
   void AttachSensorsToPlayer();
 
   void TagActorsForSemanticSegmentation();
 
+  /// Log the duration of every garbage collection while playing, so the
+  /// effect of actor churn can be measured on long runs.
+  void OnPreGarbageCollect();
+
+  void OnPostGarbageCollect();
+
   /// Iterate all the APlayerStart present in the world and add the ones with
   /// unoccupied locations to @a UnOccupiedStartPoints.
   ///
@@ -110,4 +144,14 @@ private:
 
   UPROPERTY()
   AWalkerSpawnerBase *WalkerSpawner;
+
+  FDelegateHandle PreGarbageCollectHandle;
+
+  FDelegateHandle PostGarbageCollectHandle;
+
+  double GarbageCollectStartTime = 0.0;
+
+  double GarbageCollectTotalTime = 0.0;
+
+  uint32 GarbageCollectCount = 0u;
 };
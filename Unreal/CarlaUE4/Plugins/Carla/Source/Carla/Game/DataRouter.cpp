@@ -7,6 +7,8 @@
 #include "Carla.h"
 #include "DataRouter.h"
 
+#include "Agent/AgentComponent.h"
+#include "Game/CarlaGameModeBase.h"
 #include "Sensor/Sensor.h"
 
 void FDataRouter::RegisterSensor(ASensor &InSensor)
@@ -21,6 +23,35 @@ void FDataRouter::RegisterSensor(ASensor &InSensor)
   }
 }
 
+void FDataRouter::RegisterAgent(UAgentComponent *Agent)
+{
+  check(Agent != nullptr);
+  SpatialIndex.Add(*Agent);
+}
+
+void FDataRouter::DeregisterAgent(UAgentComponent *Agent)
+{
+  check(Agent != nullptr);
+  SpatialIndex.Remove(*Agent);
+}
+
+void FDataRouter::ResetAgentIds()
+{
+  LastAgentId = 0u;
+  for (const UAgentComponent *Agent : SpatialIndex.GetAgents()) {
+    LastAgentId = FMath::Max(LastAgentId, Agent->GetId());
+  }
+}
+
+void FDataRouter::ApplyAgentControl(const FAgentControl &Controls)
+{
+  for (const auto &Item : Controls.SingleAgentControls) {
+    if (UAgentComponent *Agent = SpatialIndex.FindAgent(Item.Key)) {
+      Agent->ApplyAIControl(Item.Value);
+    }
+  }
+}
+
 void FDataRouter::RestartLevel()
 {
   if (Player != nullptr) {
@@ -33,3 +64,16 @@ void FDataRouter::RestartLevel()
         TEXT("FDataRouter: Trying to restart level but I don't have any player registered"));
   }
 }
+
+bool FDataRouter::SoftResetEpisode()
+{
+  if (Player == nullptr) {
+    UE_LOG(
+        LogCarla,
+        Error,
+        TEXT("FDataRouter: Trying to reset the episode but I don't have any player registered"));
+    return false;
+  }
+  auto *GameMode = Cast<ACarlaGameModeBase>(Player->GetWorld()->GetAuthGameMode());
+  return (GameMode != nullptr) && GameMode->SoftResetEpisode();
+}
@@ -8,6 +8,8 @@
 
 #include "Util/NonCopyable.h"
 
+#include "Game/AgentSpatialIndex.h"
+
 #include "Sensor/SensorDataSink.h"
 
 #include "Vehicle/CarlaVehicleController.h"
@@ -36,17 +38,9 @@ public:
 
   void RegisterSensor(ASensor &InSensor);
 
-  void RegisterAgent(UAgentComponent *Agent)
-  {
-    check(Agent != nullptr);
-    Agents.Emplace(Agent);
-  }
+  void RegisterAgent(UAgentComponent *Agent);
 
-  void DeregisterAgent(UAgentComponent *Agent)
-  {
-    check(Agent != nullptr);
-    Agents.RemoveSwap(Agent);
-  }
+  void DeregisterAgent(UAgentComponent *Agent);
 
   const ACarlaPlayerState &GetPlayerState() const
   {
@@ -56,7 +50,20 @@ public:
 
   const TArray<UAgentComponent *> &GetAgents() const
   {
-    return Agents;
+    return SpatialIndex.GetAgents();
+  }
+
+  /// Spatial index of the registered agents, for neighbor queries.
+  const FAgentSpatialIndex &GetAgentSpatialIndex() const
+  {
+    return SpatialIndex;
+  }
+
+  /// Refresh the location of the agents in the spatial index, should be
+  /// called once per tick.
+  void UpdateAgentSpatialIndex()
+  {
+    SpatialIndex.Update();
   }
 
   void ApplyVehicleControl(const FVehicleControl &VehicleControl)
@@ -65,24 +72,34 @@ public:
     Player->GetPossessedVehicle()->ApplyVehicleControl(VehicleControl);
   }
 
-  void ApplyAgentControl(const FAgentControl &Controls)
+  /// Apply each control to the agent with matching id, controls for unknown
+  /// ids are ignored.
+  void ApplyAgentControl(const FAgentControl &Controls);
+
+  /// Return a new agent id. Ids are sequential from the beginning of the
+  /// level, so they are the same on every run of the same episodes.
+  uint32 GenerateAgentId()
   {
-    if(Controls.SingleAgentControls.Num() <= 0){
-      return;
-    }
-
-    for(int i = 0; i < Agents.Num(); i++){
-      if (const FSingleAgentControl* AgentControl = Controls.SingleAgentControls.Find(Agents[i]->GetId())){
-        Agents[i]->ApplyAIControl(*AgentControl);
-      }
-    }
+    return ++LastAgentId;
   }
 
+  /// Start agent ids from the beginning, or right after the largest id still
+  /// registered (e.g. the player's on a soft reset). Called at the start of
+  /// each episode.
+  void ResetAgentIds();
+
   void RestartLevel();
 
+  /// Start a new episode without reloading the level, see
+  /// ACarlaGameModeBase::SoftResetEpisode.
+  bool SoftResetEpisode();
+
 private:
 
-  TArray<UAgentComponent *> Agents;
+  /// Owns the list of registered agents and their lookup by id.
+  FAgentSpatialIndex SpatialIndex;
+
+  uint32 LastAgentId = 0u;
 
   ACarlaVehicleController *Player = nullptr;
 
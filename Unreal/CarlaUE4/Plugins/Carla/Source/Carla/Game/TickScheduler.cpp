@@ -0,0 +1,152 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "Carla.h"
+#include "TickScheduler.h"
+
+#include "Game/CarlaGameInstance.h"
+#include "Settings/CarlaSettings.h"
+
+/// Default interval of the pedestrian AI, the same as the actor tick interval
+/// of AWalkerAIController.
+static constexpr float WALKER_AI_DEFAULT_TICK_INTERVAL = 0.6f;
+
+/// Tolerance for the accumulated delta times, so an interval multiple of the
+/// time step is not missed by rounding.
+static constexpr float TICK_EPSILON = 1e-4f;
+
+/// Fractional part of the golden ratio, multiples of it modulo one are spread
+/// evenly for any number of members.
+static constexpr float PHASE_STEP = 0.618034f;
+
+static const TCHAR *ToString(ETickSubsystem Subsystem)
+{
+  switch (Subsystem) {
+    case ETickSubsystem::VehicleAI:     return TEXT("Vehicle AI");
+    case ETickSubsystem::WalkerAI:      return TEXT("Walker AI");
+    case ETickSubsystem::TrafficLights: return TEXT("Traffic Lights");
+    case ETickSubsystem::Spawners:      return TEXT("Spawners");
+    default:                            return TEXT("Invalid");
+  }
+}
+
+static float ToTickInterval(const float Rate, const float DefaultInterval)
+{
+  return (Rate > 0.0f ? 1.0f / Rate : DefaultInterval);
+}
+
+// =============================================================================
+// -- FTickScheduler::FScope ---------------------------------------------------
+// =============================================================================
+
+FTickScheduler::FScope::FScope(FTickScheduler &InScheduler, const ETickSubsystem InSubsystem) :
+  Scheduler(InScheduler),
+  Subsystem(InSubsystem),
+  StartTime(FPlatformTime::Seconds()) {}
+
+FTickScheduler::FScope::~FScope()
+{
+  Scheduler.GetForThisFrame(Subsystem).TimeSpent += FPlatformTime::Seconds() - StartTime;
+}
+
+// =============================================================================
+// -- FTickScheduler -----------------------------------------------------------
+// =============================================================================
+
+FTickScheduler *FTickScheduler::Get(UWorld *World)
+{
+  auto *GameInstance = (World != nullptr ? Cast<UCarlaGameInstance>(World->GetGameInstance()) : nullptr);
+  return (GameInstance != nullptr ? &GameInstance->GetTickScheduler() : nullptr);
+}
+
+FTickScheduler::FTickScheduler()
+{
+  GetSubsystem(ETickSubsystem::WalkerAI).TickInterval = WALKER_AI_DEFAULT_TICK_INTERVAL;
+}
+
+void FTickScheduler::Configure(const UCarlaSettings &Settings)
+{
+  auto Set = [&](ETickSubsystem Subsystem, float Rate, float DefaultInterval, float BudgetInMilliseconds) {
+    auto &Item = GetSubsystem(Subsystem);
+    Item.TickInterval = ToTickInterval(Rate, DefaultInterval);
+    // Whether a member fits in the budget depends on wall-clock time.
+    Item.Budget = (Settings.bReproducibleSimulation ? 0.0 : 1e-3 * FMath::Max(BudgetInMilliseconds, 0.0f));
+  };
+  Set(ETickSubsystem::VehicleAI, Settings.VehicleAITickRate, 0.0f, Settings.VehicleAITickBudget);
+  Set(ETickSubsystem::WalkerAI, Settings.WalkerAITickRate, WALKER_AI_DEFAULT_TICK_INTERVAL, Settings.WalkerAITickBudget);
+  // The spawner budget is given to the walker spawner, see ACarlaGameModeBase.
+  Set(ETickSubsystem::TrafficLights, Settings.TrafficLightTickRate, 0.0f, 0.0f);
+  Set(ETickSubsystem::Spawners, Settings.SpawnerTickRate, 0.0f, 0.0f);
+}
+
+void FTickScheduler::Register(const ETickSubsystem Subsystem, FTickState &State)
+{
+  auto &Item = GetSubsystem(Subsystem);
+  const float Phase = FMath::Frac(PHASE_STEP * static_cast<float>(Item.NumberOfMembers++));
+  State.TimeToNextTick = Phase * Item.TickInterval;
+  State.TimeSinceLastTick = 0.0f;
+}
+
+bool FTickScheduler::ShouldTick(
+    const ETickSubsystem Subsystem,
+    FTickState &State,
+    const float DeltaSeconds,
+    float &OutDeltaSeconds)
+{
+  auto &Item = GetForThisFrame(Subsystem);
+  State.TimeSinceLastTick += DeltaSeconds;
+  State.TimeToNextTick -= DeltaSeconds;
+  if (State.TimeToNextTick > TICK_EPSILON) {
+    return false;
+  }
+  if ((Item.Budget > 0.0) && (Item.TimeSpent >= Item.Budget)) {
+    // Stays due, it gets a chance next frame.
+    ++Item.DeferredTicks;
+    return false;
+  }
+  ++Item.Ticks;
+  OutDeltaSeconds = State.TimeSinceLastTick;
+  State.TimeSinceLastTick = 0.0f;
+  // Keep the phase if late by less than an interval, drop the missed ticks
+  // otherwise.
+  State.TimeToNextTick = Item.TickInterval + FMath::Max(State.TimeToNextTick, -Item.TickInterval);
+  return true;
+}
+
+void FTickScheduler::LogStats() const
+{
+  for (uint8 i = 0u; i < static_cast<uint8>(ETickSubsystem::SIZE); ++i) {
+    const auto Subsystem = static_cast<ETickSubsystem>(i);
+    const auto &Item = GetSubsystem(Subsystem);
+    if ((Item.Ticks > 0u) || (Item.DeferredTicks > 0u)) {
+      UE_LOG(
+          LogCarla,
+          Log,
+          TEXT("Tick scheduler: %s ticked %llu times, %llu delayed by the budget"),
+          ToString(Subsystem),
+          Item.Ticks,
+          Item.DeferredTicks);
+    }
+  }
+}
+
+void FTickScheduler::ResetStats()
+{
+  for (auto &Item : Subsystems) {
+    Item.Ticks = 0u;
+    Item.DeferredTicks = 0u;
+  }
+}
+
+FTickScheduler::FSubsystem &FTickScheduler::GetForThisFrame(const ETickSubsystem Subsystem)
+{
+  auto &Item = GetSubsystem(Subsystem);
+  if (Item.Frame != GFrameCounter) {
+    Item.Frame = GFrameCounter;
+    Item.TimeSpent = 0.0;
+  }
+  return Item;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "Util/NonCopyable.h"
+
+class UCarlaSettings;
+class UWorld;
+
+/// Subsystems whose update rate is decided by the FTickScheduler.
+enum class ETickSubsystem : uint8
+{
+  VehicleAI,
+  WalkerAI,
+  TrafficLights,
+  Spawners,
+
+  SIZE
+};
+
+/// Decides when the members of each subsystem update, so large scenes can
+/// run at higher step rates. Each subsystem has a tick interval, with the
+/// members spread evenly across it, and optionally a time budget per frame;
+/// members that don't fit in the budget are delayed to the next frame.
+///
+/// The members keep an FTickState and ask ShouldTick every frame. The
+/// scheduler is owned by the game instance and configured at the beginning
+/// of every episode (see UCarlaSettings for the settings).
+class FTickScheduler : private NonCopyable
+{
+public:
+
+  /// Per-member state of the scheduler.
+  struct FTickState
+  {
+    float TimeToNextTick = 0.0f;
+
+    float TimeSinceLastTick = 0.0f;
+  };
+
+  /// Measures the time spent in a member's update and charges it to the
+  /// budget of its subsystem.
+  class FScope : private NonCopyable
+  {
+  public:
+
+    FScope(FTickScheduler &InScheduler, ETickSubsystem InSubsystem);
+
+    ~FScope();
+
+  private:
+
+    FTickScheduler &Scheduler;
+
+    const ETickSubsystem Subsystem;
+
+    const double StartTime;
+  };
+
+  /// Return the scheduler of the game instance of @a World, or nullptr if
+  /// the game instance is not a UCarlaGameInstance.
+  static FTickScheduler *Get(UWorld *World);
+
+  FTickScheduler();
+
+  /// Take the tick rates and budgets of the settings. Budgets are ignored if
+  /// the simulation is meant to be reproducible.
+  void Configure(const UCarlaSettings &Settings);
+
+  /// Tick interval of the subsystem in seconds, zero for every frame.
+  float GetTickInterval(ETickSubsystem Subsystem) const
+  {
+    return GetSubsystem(Subsystem).TickInterval;
+  }
+
+  /// Add a member to the subsystem, giving it the next phase so consecutive
+  /// members don't update on the same frame.
+  void Register(ETickSubsystem Subsystem, FTickState &State);
+
+  /// Advance the member's state by @a DeltaSeconds and return whether it
+  /// should update this frame. If so, @a OutDeltaSeconds is set to the time
+  /// elapsed since its previous update.
+  bool ShouldTick(
+      ETickSubsystem Subsystem,
+      FTickState &State,
+      float DeltaSeconds,
+      float &OutDeltaSeconds);
+
+  /// Log the number of updates run and delayed per subsystem.
+  void LogStats() const;
+
+  void ResetStats();
+
+private:
+
+  struct FSubsystem
+  {
+    float TickInterval = 0.0f;
+
+    /// Seconds, zero for no limit.
+    double Budget = 0.0;
+
+    double TimeSpent = 0.0;
+
+    uint64 Frame = 0u;
+
+    uint32 NumberOfMembers = 0u;
+
+    uint64 Ticks = 0u;
+
+    uint64 DeferredTicks = 0u;
+  };
+
+  FSubsystem &GetSubsystem(ETickSubsystem Subsystem)
+  {
+    check(Subsystem < ETickSubsystem::SIZE);
+    return Subsystems[static_cast<uint8>(Subsystem)];
+  }
+
+  const FSubsystem &GetSubsystem(ETickSubsystem Subsystem) const
+  {
+    check(Subsystem < ETickSubsystem::SIZE);
+    return Subsystems[static_cast<uint8>(Subsystem)];
+  }
+
+  /// Reset the time spent if this is the first query of the frame.
+  FSubsystem &GetForThisFrame(ETickSubsystem Subsystem);
+
+  FSubsystem Subsystems[static_cast<uint8>(ETickSubsystem::SIZE)];
+};
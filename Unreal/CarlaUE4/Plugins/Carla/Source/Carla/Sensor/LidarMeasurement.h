@@ -53,7 +53,7 @@ public:
 
   void SetFrameNumber(uint64 FrameNumber)
   {
-    std::memcpy(Header.GetData(), reinterpret_cast<const void *>(&FrameNumber), 2u);
+    std::memcpy(Header.GetData(), reinterpret_cast<const void *>(&FrameNumber), sizeof(FrameNumber));
   }
 
   float GetHorizontalAngle() const
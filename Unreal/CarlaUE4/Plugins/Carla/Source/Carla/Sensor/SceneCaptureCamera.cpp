@@ -60,6 +60,13 @@ static void RemoveShowFlags(FEngineShowFlags &ShowFlags);
 
 uint32 ASceneCaptureCamera::NumSceneCapture = 0;
 
+FThreadSafeCounter64 ASceneCaptureCamera::ReadbackTime;
+
+float ASceneCaptureCamera::ConsumeReadbackTime()
+{
+  return 1e-3f * static_cast<float>(ReadbackTime.Set(0));
+}
+
 ASceneCaptureCamera::ASceneCaptureCamera(const FObjectInitializer &ObjectInitializer)
   : Super(ObjectInitializer),
     SizeX(720u),
@@ -349,6 +356,7 @@ void ASceneCaptureCamera::WritePixelsNonBlocking(
     CaptureComponent2D->FOVAngle
   };
 
+  const double StartTime = FPlatformTime::Seconds();
   TArray<FColor> Pixels;
   rhi_cmd_list.ReadSurfaceData(
       texture,
@@ -360,6 +368,7 @@ void ASceneCaptureCamera::WritePixelsNonBlocking(
       FReadOnlyBufferView{reinterpret_cast<const void *>(&ImageHeader), sizeof(ImageHeader)},
       FReadOnlyBufferView{Pixels});
   WriteSensorData(DataView);
+  ReadbackTime.Add(static_cast<int64>(1e6 * (FPlatformTime::Seconds() - StartTime)));
 }
 
 void ASceneCaptureCamera::WritePixels(const uint64 FrameNumber) const
@@ -370,6 +379,7 @@ void ASceneCaptureCamera::WritePixels(const uint64 FrameNumber) const
     UE_LOG(LogCarla, Error, TEXT("SceneCaptureCamera: Missing render texture"));
     return;
   }
+  const double StartTime = FPlatformTime::Seconds();
   const uint32 num_bytes_per_pixel = 4;    // PF_R8G8B8A8
   const uint32 width = texture->GetSizeX();
   const uint32 height = texture->GetSizeY();
@@ -411,6 +421,7 @@ void ASceneCaptureCamera::WritePixels(const uint64 FrameNumber) const
 
   WriteSensorData(DataView);
   RHIUnlockTexture2D(texture, 0, false);
+  ReadbackTime.Add(static_cast<int64>(1e6 * (FPlatformTime::Seconds() - StartTime)));
 }
 
 void ASceneCaptureCamera::UpdateDrawFrustum()
@@ -10,6 +10,7 @@
 
 #include "Settings/CameraDescription.h"
 
+#include "HAL/ThreadSafeCounter64.h"
 #include "StaticMeshResources.h"
 
 #include "SceneCaptureCamera.generated.h"
@@ -69,9 +70,18 @@ public:
 
   bool ReadPixels(TArray<FColor> &BitMap) const;
 
+  /// Time in milliseconds the render thread spent reading back the images of
+  /// every camera since the last call.
+  static float ConsumeReadbackTime();
+
 protected:
   static uint32 NumSceneCapture;
 
+private:
+
+  /// Microseconds spent reading back images, written by the render thread.
+  static FThreadSafeCounter64 ReadbackTime;
+
 private:
 
   /// Read the camera buffer and write it to the client with no lock of the
@@ -7,8 +7,12 @@
 #include "Carla.h"
 #include "CarlaServer.h"
 
+#include "Game/CarlaGameModeBase.h"
+#include "Sensor/SceneCaptureCamera.h"
 #include "Server/CarlaEncoder.h"
 
+#include "RenderCore.h"
+
 #include <carla/carla_server.h>
 
 // =============================================================================
@@ -35,11 +39,21 @@ static int32 GetTimeOut(uint32 TimeOut, const bool bBlocking)
 // -- CarlaServer --------------------------------------------------------------
 // =============================================================================
 
-FCarlaServer::FCarlaServer(const uint32 InWorldPort, const uint32 InTimeOut) :
+FCarlaServer::FCarlaServer(
+    const uint32 InWorldPort,
+    const uint32 InTimeOut,
+    const uint32 ObserverPort,
+    const FString &UnixSocketPath) :
   WorldPort(InWorldPort),
   TimeOut(InTimeOut),
   Server(carla_make_server()) {
   check(Server != nullptr);
+  if (CARLA_SERVER_SUCCESS != carla_server_set_observer_port(Server, ObserverPort)) {
+    UE_LOG(LogCarlaServer, Warning, TEXT("Cannot accept observers at port %d"), ObserverPort);
+  }
+  if (!UnixSocketPath.IsEmpty()) {
+    carla_server_set_unix_socket_path(Server, TCHAR_TO_UTF8(*UnixSocketPath));
+  }
 }
 
 FCarlaServer::~FCarlaServer()
@@ -48,6 +62,30 @@ FCarlaServer::~FCarlaServer()
   UE_LOG(LogCarlaServer, Warning, TEXT("Destroying CarlaServer"));
 #endif // CARLA_SERVER_EXTRA_LOG
   carla_free_server(Server);
+  if (!TraceFile.IsEmpty()) {
+    if (CARLA_SERVER_SUCCESS == carla_tracer_dump(TCHAR_TO_UTF8(*TraceFile))) {
+      UE_LOG(LogCarlaServer, Log, TEXT("Trace written to %s"), *TraceFile);
+    } else {
+      UE_LOG(LogCarlaServer, Warning, TEXT("Failed to write trace to %s"), *TraceFile);
+    }
+  }
+}
+
+void FCarlaServer::StartTracing(const FString &InTraceFile)
+{
+  TraceFile = InTraceFile;
+  carla_tracer_set_enabled(true);
+}
+
+FCarlaServer::ErrorCode FCarlaServer::StartRecording(const FString &RecordingFile)
+{
+  auto ec = ParseErrorCode(carla_server_set_recording_file(Server, TCHAR_TO_UTF8(*RecordingFile)));
+  if (Success == ec) {
+    UE_LOG(LogCarlaServer, Log, TEXT("Recording the episodes to %s"), *RecordingFile);
+  } else {
+    UE_LOG(LogCarlaServer, Warning, TEXT("Failed to create recording %s"), *RecordingFile);
+  }
+  return ec;
 }
 
 FCarlaServer::ErrorCode FCarlaServer::Connect()
@@ -115,10 +153,21 @@ FCarlaServer::ErrorCode FCarlaServer::SendEpisodeReady(const bool bBlocking)
   return ParseErrorCode(carla_write_episode_ready(Server, values, GetTimeOut(TimeOut, bBlocking)));
 }
 
-FCarlaServer::ErrorCode FCarlaServer::ReadControl(FVehicleControl &Control, FAgentControl &AgentControl, const bool bBlocking)
+void FCarlaServer::SetSharedMemorySize(const uint64 SizeInBytes)
+{
+  carla_server_set_shared_memory_size(Server, SizeInBytes);
+}
+
+FCarlaServer::ErrorCode FCarlaServer::ReadControl(
+    FVehicleControl &Control,
+    FAgentControl &AgentControl,
+    uint32 &RepeatFrames,
+    const bool bBlocking)
 {
   carla_control values;
+  const double StartTime = FPlatformTime::Seconds();
   auto ec = ParseErrorCode(carla_read_control(Server, values, GetTimeOut(TimeOut, bBlocking)));
+  ReadControlTime += FPlatformTime::Seconds() - StartTime;
   if (Success == ec) {
 #ifdef CARLA_SERVER_EXTRA_LOG
     UE_LOG(
@@ -133,6 +182,7 @@ FCarlaServer::ErrorCode FCarlaServer::ReadControl(FVehicleControl &Control, FAge
         (values.reverse ? TEXT("True") : TEXT("False")));
 #endif // CARLA_SERVER_EXTRA_LOG
     FCarlaEncoder::Decode(values, Control, AgentControl);
+    RepeatFrames = FMath::Max(1u, values.repeat_frames);
   } else if ((!bBlocking) && (TryAgain == ec)) {
     UE_LOG(LogCarlaServer, Warning, TEXT("No control received from the client this frame!"));
   }
@@ -149,7 +199,9 @@ FCarlaServer::ErrorCode FCarlaServer::SendSensorData(const FSensorDataView &Data
 FCarlaServer::ErrorCode FCarlaServer::SendMeasurements(
     const ACarlaPlayerState &PlayerState,
     const TArray<UAgentComponent *> &Agents,
-    const bool bSendNonPlayerAgentsInfo)
+    const bool bSendNonPlayerAgentsInfo,
+    const bool bWaitForSensorData,
+    const bool bSendTelemetry)
 {
   // Encode measurements.
   carla_measurements values;
@@ -161,9 +213,30 @@ FCarlaServer::ErrorCode FCarlaServer::SendMeasurements(
   }
   values.non_player_agents = (AgentsData.Num() > 0 ? AgentsData.GetData() : nullptr);;
   values.number_of_non_player_agents = AgentsData.Num();
+  // Encode telemetry, the encoding time and bytes sent are filled by the
+  // server.
+  carla_telemetry Telemetry = {};
+  values.telemetry = nullptr;
+  if (bSendTelemetry) {
+    Telemetry.game_thread_time = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    Telemetry.sensor_readback_time = ASceneCaptureCamera::ConsumeReadbackTime();
+    Telemetry.read_control_time = static_cast<float>(1e3 * ReadControlTime);
+    const auto *GameMode = Cast<ACarlaGameModeBase>(PlayerState.GetWorld()->GetAuthGameMode());
+    const auto *WalkerSpawner = (GameMode != nullptr ? GameMode->GetWalkerSpawner() : nullptr);
+    if (WalkerSpawner != nullptr) {
+      Telemetry.walkers_pending_spawn = WalkerSpawner->GetNumberOfWalkersPendingSpawn();
+      Telemetry.walkers_spawned = WalkerSpawner->GetNumberOfWalkersSpawnedLastTick();
+      Telemetry.walkers_checked = WalkerSpawner->GetNumberOfWalkersCheckedLastTick();
+      Telemetry.walkers_pooled = WalkerSpawner->GetNumberOfPooledWalkers();
+    }
+    values.telemetry = &Telemetry;
+  }
+  ReadControlTime = 0.0;
   // Send measurements.
 #ifdef CARLA_SERVER_EXTRA_LOG
   UE_LOG(LogCarlaServer, Log, TEXT("Sending data of %d agents"), values.number_of_non_player_agents);
 #endif // CARLA_SERVER_EXTRA_LOG
-  return ParseErrorCode(carla_write_measurements(Server, values));
+  return ParseErrorCode(bWaitForSensorData ?
+      carla_write_measurements_pipelined(Server, values) :
+      carla_write_measurements(Server, values));
 }
@@ -26,10 +26,27 @@ public:
     Error
   };
 
-  explicit FCarlaServer(uint32 WorldPort, uint32 TimeOutInMilliseconds);
+  /// If @a ObserverPort is not zero, read-only observers are accepted at that
+  /// port during the episodes. If @a UnixSocketPath is not empty, the client
+  /// connects through Unix domain sockets instead of TCP.
+  explicit FCarlaServer(
+      uint32 WorldPort,
+      uint32 TimeOutInMilliseconds,
+      uint32 ObserverPort = 0u,
+      const FString &UnixSocketPath = FString());
 
   ~FCarlaServer();
 
+  /// Record a timeline of the server, written to @a TraceFile in Chrome trace
+  /// format when this object is destroyed.
+  void StartTracing(const FString &TraceFile);
+
+  /// Record the episodes sent to the client to @a RecordingFile, including
+  /// everything sent by SendSceneDescription, SendMeasurements and
+  /// SendSensorData and the controls read. The file is written by a separate
+  /// thread and completed when this object is destroyed.
+  ErrorCode StartRecording(const FString &RecordingFile);
+
   /// Connect with the client, block until the client connects or the time-out
   /// is met.
   ErrorCode Connect();
@@ -46,16 +63,33 @@ public:
 
   ErrorCode SendEpisodeReady(bool bBlocking);
 
-  ErrorCode ReadControl(FVehicleControl &Control, FAgentControl &AgentControl, bool bBlocking);
+  /// Size in bytes of the shared memory region for the sensor data of the
+  /// next episode, zero to send the sensor data through the socket. Must be
+  /// set before sending the episode ready.
+  void SetSharedMemorySize(uint64 SizeInBytes);
+
+  /// @a RepeatFrames is set to the number of frames the client requested the
+  /// control to be applied, at least one.
+  ErrorCode ReadControl(
+      FVehicleControl &Control,
+      FAgentControl &AgentControl,
+      uint32 &RepeatFrames,
+      bool bBlocking);
 
   /// Enqueues sensor data to be sent to the client. It is safe to call this
   /// function from a different thread.
   ErrorCode SendSensorData(const FSensorDataView &Data);
 
+  /// If @a bWaitForSensorData is true, the sensor data of the same frame is
+  /// sent along with the measurements as soon as it is ready, otherwise only
+  /// the sensor data already received is sent. If @a bSendTelemetry is true,
+  /// the timings of the server since the previous measurements are attached.
   ErrorCode SendMeasurements(
       const ACarlaPlayerState &PlayerState,
       const TArray<UAgentComponent *> &Agents,
-      bool bSendNonPlayerAgentsInfo);
+      bool bSendNonPlayerAgentsInfo,
+      bool bWaitForSensorData = false,
+      bool bSendTelemetry = false);
 
 private:
 
@@ -64,4 +98,9 @@ private:
   const uint32 TimeOut;
 
   void* const Server;
+
+  FString TraceFile;
+
+  /// Seconds blocked in ReadControl since the last measurements.
+  double ReadControlTime = 0.0;
 };
@@ -10,7 +10,9 @@
 #include "Game/DataRouter.h"
 #include "Server/CarlaServer.h"
 #include "Server/ServerSensorDataSink.h"
+#include "Settings/CameraDescription.h"
 #include "Settings/CarlaSettings.h"
+#include "Settings/LidarDescription.h"
 #include "Private/RenderTargetTemp.h"
 
 using Errc = FCarlaServer::ErrorCode;
@@ -18,6 +20,25 @@ using Errc = FCarlaServer::ErrorCode;
 static constexpr bool BLOCKING = true;
 static constexpr bool NON_BLOCKING = false;
 
+/// Size of the shared memory region needed for the given sensors. The region
+/// is reused in a ring, it holds a few frames so the client has time to read
+/// the data before it is overwritten.
+static uint64 GetSharedMemorySize(const TArray<USensorDescription *> &Sensors)
+{
+  constexpr uint64 HeaderSize = 64u;
+  uint64 FrameSize = 0u;
+  for (const auto *Sensor : Sensors) {
+    if (const auto *Camera = Cast<UCameraDescription>(Sensor)) {
+      FrameSize += HeaderSize + 4u * Camera->ImageSizeX * Camera->ImageSizeY;
+    } else if (const auto *Lidar = Cast<ULidarDescription>(Sensor)) {
+      // Upper bound, at least one second of points.
+      FrameSize += HeaderSize + 4u * Lidar->Channels + 3u * 4u * Lidar->PointsPerSecond;
+    }
+  }
+  constexpr uint64 MinimumSize = 32u * 1024u * 1024u;
+  return FMath::Max(MinimumSize, 4u * FrameSize);
+}
+
 FServerGameController::FServerGameController(FDataRouter &InDataRouter)
   : ICarlaGameControllerBase(InDataRouter),
     DataSink(MakeShared<FServerSensorDataSink>()),
@@ -33,8 +54,18 @@ void FServerGameController::Initialize(UCarlaSettings &InCarlaSettings)
 
   // Initialize server if missing.
   if (!Server.IsValid()) {
-    Server = MakeShared<FCarlaServer>(CarlaSettings->WorldPort, CarlaSettings->ServerTimeOut);
+    Server = MakeShared<FCarlaServer>(
+        CarlaSettings->WorldPort,
+        CarlaSettings->ServerTimeOut,
+        CarlaSettings->ObserverPort,
+        CarlaSettings->UnixSocketPath);
     DataSink->SetServer(Server);
+    if (!CarlaSettings->TraceFile.IsEmpty()) {
+      Server->StartTracing(CarlaSettings->TraceFile);
+    }
+    if (!CarlaSettings->RecordingFile.IsEmpty()) {
+      Server->StartRecording(CarlaSettings->RecordingFile);
+    }
     FString IniFile;
     if ((Errc::Success == Server->Connect()) &&
         (Errc::Success == Server->ReadNewEpisode(IniFile, BLOCKING))) {
@@ -55,6 +86,8 @@ APlayerStart *FServerGameController::ChoosePlayerStart(
     TArray<USensorDescription *> Sensors;
     CarlaSettings->SensorDescriptions.GenerateValueArray(Sensors);
     const auto &MapName = CarlaSettings->MapName;
+    Server->SetSharedMemorySize(
+        CarlaSettings->bSharedMemoryTransport ? GetSharedMemorySize(Sensors) : 0u);
     if (Errc::Success != Server->SendSceneDescription(MapName, AvailableStartSpots, Sensors, BLOCKING)) {
       UE_LOG(LogCarlaServer, Warning, TEXT("Failed to send scene description, server needs restart"));
       Server = nullptr;
@@ -85,6 +118,7 @@ void FServerGameController::RegisterPlayer(AController &NewPlayer)
 
 void FServerGameController::BeginPlay()
 {
+  RemainingRepeatFrames = 0u;
   if (Server.IsValid()) {
     if (Errc::Success != Server->SendEpisodeReady(BLOCKING)) {
       UE_LOG(LogCarlaServer, Warning, TEXT("Failed to read episode start, server needs restart"));
@@ -108,10 +142,15 @@ void FServerGameController::Tick(float DeltaSeconds)
     FString IniFile;
     auto ec = Server->ReadNewEpisode(IniFile, NON_BLOCKING);
     switch (ec) {
-      case Errc::Success:
+      case Errc::Success: {
+        RemainingRepeatFrames = 0u;
+        const bool bCanSoftReset = CarlaSettings->CanSoftReset(IniFile);
         CarlaSettings->LoadSettingsFromString(IniFile);
-        RestartLevel();
+        if (!bCanSoftReset || !DataRouter.SoftResetEpisode()) {
+          RestartLevel();
+        }
         return;
+      }
       case Errc::Error:
         Server = nullptr;
         return;
@@ -120,9 +159,22 @@ void FServerGameController::Tick(float DeltaSeconds)
     }
   }
 
+  // Keep applying the last control until the number of frames requested by
+  // the client is reached, only then the measurements are sent.
+  if (RemainingRepeatFrames > 0u) {
+    --RemainingRepeatFrames;
+    DataRouter.ApplyVehicleControl(RepeatedControl);
+    return;
+  }
+
   // Send measurements.
   {
-    if (CarlaSettings->bSynchronousMode)
+    // In pipelined mode we don't wait for the render thread, the sensor data
+    // of this frame is sent after the measurements as soon as the render
+    // thread writes it.
+    const bool bPipelined =
+        CarlaSettings->bSynchronousMode && CarlaSettings->bPipelinedSynchronousMode;
+    if (CarlaSettings->bSynchronousMode && !bPipelined)
     {
       FlushRenderingCommands();
     }
@@ -130,7 +182,9 @@ void FServerGameController::Tick(float DeltaSeconds)
     if (Errc::Error == Server->SendMeasurements(
             DataRouter.GetPlayerState(),
             DataRouter.GetAgents(),
-            CarlaSettings->bSendNonPlayerAgentsInfo))
+            CarlaSettings->bSendNonPlayerAgentsInfo,
+            bPipelined,
+            CarlaSettings->bSendTelemetry))
     {
       // The error here must be ignored, otherwise we can create a race
       // condition between the different ports.
@@ -143,11 +197,14 @@ void FServerGameController::Tick(float DeltaSeconds)
     const bool bShouldBlock = CarlaSettings->bSynchronousMode;
     FVehicleControl Control;
     FAgentControl AgentControl;
+    uint32 RepeatFrames = 1u;
 
-    if (Errc::Error != Server->ReadControl(Control, AgentControl, bShouldBlock))
+    if (Errc::Error != Server->ReadControl(Control, AgentControl, RepeatFrames, bShouldBlock))
     {
       DataRouter.ApplyVehicleControl(Control);
       DataRouter.ApplyAgentControl(AgentControl);
+      RepeatedControl = Control;
+      RemainingRepeatFrames = RepeatFrames - 1u;
     } // Here we ignore the error too.
   }
 }
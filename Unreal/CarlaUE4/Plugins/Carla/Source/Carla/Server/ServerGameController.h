@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Game/CarlaGameControllerBase.h"
+#include "Vehicle/VehicleControl.h"
 
 class FCarlaServer;
 class FServerSensorDataSink;
@@ -39,4 +40,10 @@ private:
   TSharedPtr<FCarlaServer> Server;
 
   UCarlaSettings *CarlaSettings = nullptr;
+
+  /// Control requested by the client to be applied for several frames.
+  FVehicleControl RepeatedControl;
+
+  /// Frames left to apply RepeatedControl before sending new measurements.
+  uint32 RemainingRepeatFrames = 0u;
 };
@@ -34,6 +34,11 @@ public:
     return PostProcessEffect == EPostProcessEffect::SemanticSegmentation;
   }
 
+  virtual bool RequiresRendering() const final
+  {
+    return true;
+  }
+
   virtual void AdjustToWeather(const FWeatherDescription &WeatherDescription) final;
 
   virtual void Log() const final;
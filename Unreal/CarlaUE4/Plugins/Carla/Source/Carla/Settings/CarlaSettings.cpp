@@ -9,9 +9,11 @@
 #include "DynamicWeather.h"
 #include "Settings/CameraDescription.h"
 #include "Settings/LidarDescription.h"
+#include "Settings/SensorDescription.h"
 #include "Util/IniFile.h"
 #include "Package.h"
 #include "CommandLine.h"
+#include "Misc/App.h"
 #include "UnrealMathUtility.h"
 #include "Engine/Engine.h"
 #include "Kismet/GameplayStatics.h"
@@ -26,6 +28,7 @@
 #define S_CARLA_LEVELSETTINGS          TEXT("CARLA/LevelSettings")
 #define S_CARLA_SENSOR                 TEXT("CARLA/Sensor")
 #define S_CARLA_QUALITYSETTINGS        TEXT("CARLA/QualitySettings")
+#define S_CARLA_TICKSCHEDULER          TEXT("CARLA/TickScheduler")
 
 // =============================================================================
 // -- Static variables & constants ---------------------------------------------
@@ -108,9 +111,19 @@ static void LoadSettingsFromConfig(
     ConfigFile.GetBool(S_CARLA_SERVER, TEXT("UseNetworking"), Settings.bUseNetworking);
     ConfigFile.GetInt(S_CARLA_SERVER, TEXT("WorldPort"), Settings.WorldPort);
     ConfigFile.GetInt(S_CARLA_SERVER, TEXT("ServerTimeOut"), Settings.ServerTimeOut);
+    ConfigFile.GetInt(S_CARLA_SERVER, TEXT("ObserverPort"), Settings.ObserverPort);
+    ConfigFile.GetString(S_CARLA_SERVER, TEXT("UnixSocketPath"), Settings.UnixSocketPath);
+    ConfigFile.GetString(S_CARLA_SERVER, TEXT("TraceFile"), Settings.TraceFile);
+    ConfigFile.GetString(S_CARLA_SERVER, TEXT("RecordingFile"), Settings.RecordingFile);
   }
   ConfigFile.GetBool(S_CARLA_SERVER, TEXT("SynchronousMode"), Settings.bSynchronousMode);
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("PipelinedSynchronousMode"), Settings.bPipelinedSynchronousMode);
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("SharedMemoryTransport"), Settings.bSharedMemoryTransport);
   ConfigFile.GetBool(S_CARLA_SERVER, TEXT("SendNonPlayerAgentsInfo"), Settings.bSendNonPlayerAgentsInfo);
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("SendTelemetry"), Settings.bSendTelemetry);
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("AllowSoftReset"), Settings.bAllowSoftReset);
+  ConfigFile.GetFloat(S_CARLA_SERVER, TEXT("FixedTimeStep"), Settings.FixedTimeStep);
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("ReproducibleSimulation"), Settings.bReproducibleSimulation);
   // LevelSettings.
   ConfigFile.GetString(S_CARLA_LEVELSETTINGS, TEXT("PlayerVehicle"), Settings.PlayerVehicle);
   ConfigFile.GetInt(S_CARLA_LEVELSETTINGS, TEXT("NumberOfVehicles"), Settings.NumberOfVehicles);
@@ -119,11 +132,23 @@ static void LoadSettingsFromConfig(
   ConfigFile.GetInt(S_CARLA_LEVELSETTINGS, TEXT("SeedVehicles"), Settings.SeedVehicles);
   ConfigFile.GetInt(S_CARLA_LEVELSETTINGS, TEXT("SeedPedestrians"), Settings.SeedPedestrians);
   ConfigFile.GetBool(S_CARLA_LEVELSETTINGS, TEXT("DisableTwoWheeledVehicles"), Settings.bDisableTwoWheeledVehicles);
+  // TickScheduler.
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("VehicleAITickRate"), Settings.VehicleAITickRate);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("VehicleAITickBudget"), Settings.VehicleAITickBudget);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("WalkerAITickRate"), Settings.WalkerAITickRate);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("WalkerAITickBudget"), Settings.WalkerAITickBudget);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("TrafficLightTickRate"), Settings.TrafficLightTickRate);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("SpawnerTickRate"), Settings.SpawnerTickRate);
+  ConfigFile.GetFloat(S_CARLA_TICKSCHEDULER, TEXT("SpawnerTickBudget"), Settings.SpawnerTickBudget);
 
   // QualitySettings.
   FString sQualityLevel;
   ConfigFile.GetString(S_CARLA_QUALITYSETTINGS, TEXT("QualityLevel"), sQualityLevel);
   Settings.SetQualitySettingsLevel(UQualitySettings::FromString(sQualityLevel));
+  ConfigFile.GetBool(S_CARLA_QUALITYSETTINGS, TEXT("DisableRendering"), Settings.bDisableRendering);
+  if (!FApp::CanEverRender()) {
+    Settings.bDisableRendering = true;
+  }
 
   // Sensors.
   FString Sensors;
@@ -132,7 +157,9 @@ static void LoadSettingsFromConfig(
   Sensors.ParseIntoArray(SensorNames, TEXT(","), true);
   for (const FString &Name : SensorNames) {
     auto *Sensor = MakeSensor(ConfigFile, &Settings, Name);
-    if (Sensor != nullptr) {
+    if ((Sensor != nullptr) && Settings.bDisableRendering && Sensor->RequiresRendering()) {
+      UE_LOG(LogCarla, Warning, TEXT("Rendering disabled, sensor '%s' ignored"), *Name);
+    } else if (Sensor != nullptr) {
       LoadSensorFromConfig(ConfigFile, *Sensor);
       Sensor->Validate();
       Settings.bSemanticSegmentationEnabled |= Sensor->RequiresSemanticSegmentation();
@@ -141,6 +168,19 @@ static void LoadSettingsFromConfig(
   }
 }
 
+static bool AreEqual(const USensorDescription &Lhs, const USensorDescription &Rhs)
+{
+  if (Lhs.GetClass() != Rhs.GetClass()) {
+    return false;
+  }
+  for (TFieldIterator<UProperty> It(Lhs.GetClass()); It; ++It) {
+    if (!It->Identical_InContainer(&Lhs, &Rhs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static bool GetSettingsFilePathFromCommandLine(FString &Value)
 {
   if (FParse::Value(FCommandLine::Get(), TEXT("-carla-settings="), Value)) {
@@ -202,6 +242,19 @@ void UCarlaSettings::LoadSettings()
       WorldPort = Value;
       bUseNetworking = true;
     }
+    if (FParse::Value(FCommandLine::Get(), TEXT("-carla-observer-port="), Value)) {
+      ObserverPort = Value;
+    }
+    FString Path;
+    if (FParse::Value(FCommandLine::Get(), TEXT("-carla-unix-socket="), Path)) {
+      UnixSocketPath = Path;
+    }
+    if (FParse::Value(FCommandLine::Get(), TEXT("-carla-trace="), Path)) {
+      TraceFile = Path;
+    }
+    if (FParse::Value(FCommandLine::Get(), TEXT("-carla-record="), Path)) {
+      RecordingFile = Path;
+    }
     if (FParse::Param(FCommandLine::Get(), TEXT("carla-no-networking"))) {
       bUseNetworking = false;
     }
@@ -219,6 +272,63 @@ void UCarlaSettings::LoadSettingsFromString(const FString &INIFileContents)
   CurrentFileName = TEXT("<string-provided-by-client>");
 }
 
+bool UCarlaSettings::CanSoftReset(const FString &INIFileContents) const
+{
+  FIniFile ConfigFile;
+  ConfigFile.ProcessInputFileContents(INIFileContents);
+
+  // Read only the settings that require reloading the level, the same way
+  // LoadSettingsFromConfig does, keys not present keep the current value.
+  bool bOtherAllowSoftReset = bAllowSoftReset;
+  ConfigFile.GetBool(S_CARLA_SERVER, TEXT("AllowSoftReset"), bOtherAllowSoftReset);
+  FString OtherPlayerVehicle = PlayerVehicle;
+  ConfigFile.GetString(S_CARLA_LEVELSETTINGS, TEXT("PlayerVehicle"), OtherPlayerVehicle);
+  bool bOtherDisableTwoWheeledVehicles = bDisableTwoWheeledVehicles;
+  ConfigFile.GetBool(S_CARLA_LEVELSETTINGS, TEXT("DisableTwoWheeledVehicles"), bOtherDisableTwoWheeledVehicles);
+  FString OtherQualityLevel;
+  ConfigFile.GetString(S_CARLA_QUALITYSETTINGS, TEXT("QualityLevel"), OtherQualityLevel);
+  bool bOtherDisableRendering = bDisableRendering;
+  ConfigFile.GetBool(S_CARLA_QUALITYSETTINGS, TEXT("DisableRendering"), bOtherDisableRendering);
+  bOtherDisableRendering |= !FApp::CanEverRender();
+  if (!bOtherAllowSoftReset ||
+      (OtherPlayerVehicle != PlayerVehicle) ||
+      (UQualitySettings::FromString(OtherQualityLevel) != QualitySettingsLevel) ||
+      (bOtherDisableRendering != bDisableRendering) ||
+      (bOtherDisableTwoWheeledVehicles != bDisableTwoWheeledVehicles)) {
+    return false;
+  }
+
+  // Our sensors were adjusted to the weather when attached to the player.
+  int32 OtherWeatherId = WeatherId;
+  ConfigFile.GetInt(S_CARLA_LEVELSETTINGS, TEXT("WeatherId"), OtherWeatherId);
+  const FWeatherDescription *Weather =
+      ((OtherWeatherId >= 0) && (OtherWeatherId < WeatherDescriptions.Num()) ?
+          &WeatherDescriptions[OtherWeatherId] :
+          nullptr);
+  FString Sensors;
+  ConfigFile.GetString(S_CARLA_SENSOR, TEXT("Sensors"), Sensors);
+  TArray<FString> SensorNames;
+  Sensors.ParseIntoArray(SensorNames, TEXT(","), true);
+  int32 NumberOfSensors = 0;
+  for (const FString &Name : SensorNames) {
+    auto *Sensor = MakeSensor(ConfigFile, GetTransientPackage(), Name);
+    if ((Sensor == nullptr) || (bOtherDisableRendering && Sensor->RequiresRendering())) {
+      continue;
+    }
+    ++NumberOfSensors;
+    LoadSensorFromConfig(ConfigFile, *Sensor);
+    Sensor->Validate();
+    if (Weather != nullptr) {
+      Sensor->AdjustToWeather(*Weather);
+    }
+    const auto *Current = SensorDescriptions.Find(Name);
+    if ((Current == nullptr) || (*Current == nullptr) || !AreEqual(**Current, *Sensor)) {
+      return false;
+    }
+  }
+  return (NumberOfSensors == SensorDescriptions.Num());
+}
+
 void UCarlaSettings::LoadWeatherDescriptions()
 {
   WeatherDescriptions.Empty();
@@ -243,8 +353,22 @@ void UCarlaSettings::LogSettings() const
   UE_LOG(LogCarla, Log, TEXT("Networking = %s"), EnabledDisabled(bUseNetworking));
   UE_LOG(LogCarla, Log, TEXT("World Port = %d"), WorldPort);
   UE_LOG(LogCarla, Log, TEXT("Server Time-out = %d ms"), ServerTimeOut);
+  UE_LOG(LogCarla, Log, TEXT("Observer Port = %d"), ObserverPort);
+  UE_LOG(LogCarla, Log, TEXT("Unix Socket Path = %s"), (UnixSocketPath.IsEmpty() ? TEXT("Disabled") : *UnixSocketPath));
+  UE_LOG(LogCarla, Log, TEXT("Trace File = %s"), (TraceFile.IsEmpty() ? TEXT("Disabled") : *TraceFile));
+  UE_LOG(LogCarla, Log, TEXT("Recording File = %s"), (RecordingFile.IsEmpty() ? TEXT("Disabled") : *RecordingFile));
   UE_LOG(LogCarla, Log, TEXT("Synchronous Mode = %s"), EnabledDisabled(bSynchronousMode));
+  UE_LOG(LogCarla, Log, TEXT("Pipelined Synchronous Mode = %s"), EnabledDisabled(bPipelinedSynchronousMode));
+  UE_LOG(LogCarla, Log, TEXT("Shared Memory Transport = %s"), EnabledDisabled(bSharedMemoryTransport));
   UE_LOG(LogCarla, Log, TEXT("Send Non-Player Agents Info = %s"), EnabledDisabled(bSendNonPlayerAgentsInfo));
+  UE_LOG(LogCarla, Log, TEXT("Send Telemetry = %s"), EnabledDisabled(bSendTelemetry));
+  UE_LOG(LogCarla, Log, TEXT("Soft Reset = %s"), EnabledDisabled(bAllowSoftReset));
+  if (FixedTimeStep > 0.0f) {
+    UE_LOG(LogCarla, Log, TEXT("Fixed Time Step = %.4f s"), FixedTimeStep);
+  } else {
+    UE_LOG(LogCarla, Log, TEXT("Fixed Time Step = Command-line"));
+  }
+  UE_LOG(LogCarla, Log, TEXT("Reproducible Simulation = %s"), EnabledDisabled(bReproducibleSimulation));
   UE_LOG(LogCarla, Log, TEXT("[%s]"), S_CARLA_LEVELSETTINGS);
   UE_LOG(LogCarla, Log, TEXT("Player Vehicle        = %s"), (PlayerVehicle.IsEmpty() ? TEXT("Default") : *PlayerVehicle));
   UE_LOG(LogCarla, Log, TEXT("Number Of Vehicles    = %d"), NumberOfVehicles);
@@ -258,8 +382,31 @@ void UCarlaSettings::LogSettings() const
   {
     UE_LOG(LogCarla, Log, TEXT("  * %d - %s"), i, *WeatherDescriptions[i].Name);
   }
+  UE_LOG(LogCarla, Log, TEXT("[%s]"), S_CARLA_TICKSCHEDULER);
+  auto LogTickRate = [](const TCHAR *Name, float Rate) {
+    if (Rate > 0.0f) {
+      UE_LOG(LogCarla, Log, TEXT("%s Tick Rate = %.2f Hz"), Name, Rate);
+    } else {
+      UE_LOG(LogCarla, Log, TEXT("%s Tick Rate = Default"), Name);
+    }
+  };
+  auto LogTickBudget = [](const TCHAR *Name, float Budget) {
+    if (Budget > 0.0f) {
+      UE_LOG(LogCarla, Log, TEXT("%s Tick Budget = %.2f ms"), Name, Budget);
+    } else {
+      UE_LOG(LogCarla, Log, TEXT("%s Tick Budget = Default"), Name);
+    }
+  };
+  LogTickRate(TEXT("Vehicle AI"), VehicleAITickRate);
+  LogTickBudget(TEXT("Vehicle AI"), VehicleAITickBudget);
+  LogTickRate(TEXT("Walker AI"), WalkerAITickRate);
+  LogTickBudget(TEXT("Walker AI"), WalkerAITickBudget);
+  LogTickRate(TEXT("Traffic Light"), TrafficLightTickRate);
+  LogTickRate(TEXT("Spawner"), SpawnerTickRate);
+  LogTickBudget(TEXT("Spawner"), SpawnerTickBudget);
   UE_LOG(LogCarla, Log, TEXT("[%s]"), S_CARLA_QUALITYSETTINGS);
   UE_LOG(LogCarla, Log, TEXT("Quality Settings = %s"), *UQualitySettings::ToString(QualitySettingsLevel));
+  UE_LOG(LogCarla, Log, TEXT("Rendering = %s"), EnabledDisabled(!bDisableRendering));
 
   UE_LOG(LogCarla, Log, TEXT("[%s]"), S_CARLA_SENSOR);
   UE_LOG(LogCarla, Log, TEXT("Added %d sensors."), SensorDescriptions.Num());
@@ -70,6 +70,13 @@ public:
   /** Load the settings from the given string (formatted as INI). CarlaServer section is ignored. */
   void LoadSettingsFromString(const FString &INIFileContents);
 
+  /** Whether a new episode with the given settings (formatted as INI) can be
+    * started without reloading the level. That is the case if soft reset is
+    * allowed and the player vehicle, quality level, rendering and sensors
+    * (adjusted to the weather) are the same as the current ones.
+    */
+  bool CanSoftReset(const FString &INIFileContents) const;
+
   /** Load weather description from config files. (There may be overrides for each map). */
   void LoadWeatherDescriptions();
 
@@ -139,16 +146,85 @@ public:
   UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
   uint32 ServerTimeOut = 10000u;
 
+  /** Port to listen for read-only observers of the episodes, zero to
+    * disable. Observers receive the same measurements and sensor data sent to
+    * the client, dropping frames if they cannot keep up.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  uint32 ObserverPort = 0u;
+
+  /** If not empty, listen for the client at the Unix domain sockets
+    * "<UnixSocketPath>-<port>" instead of the TCP ports. Only for clients
+    * running in the same machine.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  FString UnixSocketPath;
+
+  /** If not empty, record a timeline of the server and write it to this file
+    * in Chrome trace format when the server is disconnected.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  FString TraceFile;
+
+  /** If not empty, record the episodes sent to the client to this file, see
+    * carla_server_set_recording_file.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  FString RecordingFile;
+
   /** In synchronous mode, CARLA waits every tick until the control from the
     * client is received.
     */
   UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
   bool bSynchronousMode = true;
 
+  /** In synchronous mode, send the measurements without waiting for the
+    * render thread to finish the sensor data of the previous tick. The sensor
+    * data is sent as soon as it is ready, tagged with the same frame number
+    * as its measurements, so the render readback overlaps with the client
+    * processing the measurements.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bSynchronousMode))
+  bool bPipelinedSynchronousMode = false;
+
+  /** Write the sensor data to a shared memory region instead of sending it
+    * through the socket, the client must run in the same machine. Only
+    * supported on Linux.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  bool bSharedMemoryTransport = false;
+
   /** Send info about every non-player agent in the scene every frame. */
   UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
   bool bSendNonPlayerAgentsInfo = false;
 
+  /** Attach the timings of the server (game thread, sensor readback,
+    * encoding and time waiting for the control) and the bytes sent to the
+    * measurements every frame.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  bool bSendTelemetry = false;
+
+  /** If possible, start new episodes without reloading the level. The player
+    * is moved to the new start spot and the non-player agents are respawned.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (EditCondition = bUseNetworking))
+  bool bAllowSoftReset = true;
+
+  /** Fixed time step of the simulation in seconds, applied at the beginning
+    * of each episode. If zero, the time step given in the command-line is
+    * used (e.g. "-benchmark -fps=10"), or a variable time step if none.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float FixedTimeStep = 0.0f;
+
+  /** Remove the dependencies of the simulation on wall-clock time, so
+    * repeated episodes with the same seeds and controls produce identical
+    * measurements. Requires synchronous mode and a fixed time step.
+    */
+  UPROPERTY(Category = "CARLA Server", VisibleAnywhere)
+  bool bReproducibleSimulation = false;
+
   /// @}
   // ===========================================================================
   /// @name Level Settings
@@ -192,6 +268,57 @@ public:
   UPROPERTY(Category = "Level Settings", BlueprintReadOnly, VisibleAnywhere)
   bool bDisableTwoWheeledVehicles = false;
 
+  /// @}
+  // ===========================================================================
+  /// @name Tick Scheduler
+  // ===========================================================================
+  /// @{
+public:
+
+  /** Rate at which the autopilot of the non-player vehicles is updated, in
+    * Hz. The last control is applied in between updates. Zero updates them
+    * every frame.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float VehicleAITickRate = 0.0f;
+
+  /** Time budget per frame for updating the autopilot of the non-player
+    * vehicles, in milliseconds. The vehicles left out are updated next frame.
+    * Zero means no limit.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float VehicleAITickBudget = 0.0f;
+
+  /** Rate at which the pedestrian AI is updated, in Hz. Zero keeps the
+    * default of one update every 0.6 seconds.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float WalkerAITickRate = 0.0f;
+
+  /** Time budget per frame for updating the pedestrian AI, in milliseconds.
+    * Zero means no limit.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float WalkerAITickBudget = 0.0f;
+
+  /** Rate at which the traffic lights are updated, in Hz. Zero updates them
+    * every frame.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float TrafficLightTickRate = 0.0f;
+
+  /** Rate at which the vehicle and pedestrian spawners are updated, in Hz.
+    * Zero updates them every frame.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float SpawnerTickRate = 0.0f;
+
+  /** Time budget per update of the pedestrian spawner, in milliseconds. Zero
+    * keeps the budget of the spawner class.
+    */
+  UPROPERTY(Category = "Tick Scheduler", VisibleAnywhere, meta = (ClampMin = "0.0"))
+  float SpawnerTickBudget = 0.0f;
+
   /// @}
 
   // ===========================================================================
@@ -206,6 +333,14 @@ private:
 
 public:
 
+  /** Run only the physics, the AI controllers and the server, for clients
+    * that only need the measurements. Cameras are not spawned, the world is
+    * not rendered to the viewport and the rendering-only features are turned
+    * off. Always set if the simulator cannot render (e.g. "-nullrhi").
+    */
+  UPROPERTY(Category = "Quality Settings", VisibleAnywhere)
+  bool bDisableRendering = false;
+
   /** @TODO : Move Low quality vars to a generic map of structs with the quality level as key*/
 
   /** Low quality Road Materials.
@@ -9,6 +9,10 @@
 #include "Engine/DirectionalLight.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/PostProcessVolume.h"
+#include "Engine/GameViewportClient.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "Particles/ParticleSystemComponent.h"
 #include "Async.h"
 #include "Landscape.h"
 #include "InstancedFoliageActor.h"
@@ -42,6 +46,10 @@ void UCarlaSettingsDelegate::OnActorSpawned(AActor* InActor)
 	  !InActor->ActorHasTag(UCarlaSettings::CARLA_SKY_TAG)
   ){
 	 TArray<UActorComponent*> components = InActor->GetComponentsByClass(UPrimitiveComponent::StaticClass());
+	 if(CarlaSettings->bDisableRendering)
+	 {
+		 DisableRenderingOnlyComponents(InActor);
+	 }
 	 switch(CarlaSettings->GetQualitySettingsLevel())
 	 {
 	 case EQualitySettingsLevel::Low:{
@@ -65,6 +73,9 @@ void UCarlaSettingsDelegate::ApplyQualitySettingsLevelPostRestart()
 {
 	CheckCarlaSettings(nullptr);
 	UWorld *InWorld = CarlaSettings->GetWorld();
+
+	//the level is always reloaded if this setting changes, apply it every time
+	SetRenderingEnabled(InWorld, !CarlaSettings->bDisableRendering);
   
     const EQualitySettingsLevel QualitySettingsLevel = CarlaSettings->GetQualitySettingsLevel();
 	if(AppliedLowPostResetQualitySettingsLevel==QualitySettingsLevel) return;
@@ -293,6 +304,57 @@ void UCarlaSettingsDelegate::SetPostProcessEffectsEnabled(UWorld* world, const b
 }
 
 
+void UCarlaSettingsDelegate::SetRenderingEnabled(UWorld* world, const bool enabled) const
+{
+  if(!world||!IsValid(world)||world->IsPendingKill()) return;
+  UGameViewportClient* viewport = world->GetGameViewport();
+  if(viewport)
+  {
+    viewport->bDisableWorldRendering = !enabled;
+  }
+  if(enabled) return;
+  UE_LOG(LogCarla, Log, TEXT("Rendering disabled, running physics, AI controllers and server only"));
+  SetPostProcessEffectsEnabled(world, false);
+  AsyncTask(ENamedThreads::GameThread, [=](){
+    if(!world||!IsValid(world)||world->IsPendingKill()) return;
+    TArray<AActor*> actors;
+    UGameplayStatics::GetAllActorsOfClass(world, AActor::StaticClass(), actors);
+    for(int32 i=0; i<actors.Num(); i++)
+    {
+      if(!IsValid(actors[i]) || actors[i]->IsPendingKill()) continue;
+      DisableRenderingOnlyComponents(actors[i]);
+    }
+  });
+}
+
+void UCarlaSettingsDelegate::DisableRenderingOnlyComponents(AActor* actor) const
+{
+  if(!actor) return;
+  //particles (rain, smoke...) are only visual, stop simulating them
+  TArray<UActorComponent*> particles = actor->GetComponentsByClass(UParticleSystemComponent::StaticClass());
+  for(int32 j=0; j<particles.Num(); j++)
+  {
+    UParticleSystemComponent* particlesystem = Cast<UParticleSystemComponent>(particles[j]);
+    if(IsValid(particlesystem))
+    {
+      particlesystem->DeactivateSystem();
+      particlesystem->SetComponentTickEnabled(false);
+    }
+  }
+  //the pose of the pedestrians is only visual, they move with their capsule.
+  //Vehicles are left alone, their wheels are driven by the skeletal mesh.
+  if(!actor->IsA<ACharacter>()) return;
+  TArray<UActorComponent*> meshes = actor->GetComponentsByClass(USkeletalMeshComponent::StaticClass());
+  for(int32 j=0; j<meshes.Num(); j++)
+  {
+    USkeletalMeshComponent* skeletalmesh = Cast<USkeletalMeshComponent>(meshes[j]);
+    if(IsValid(skeletalmesh))
+    {
+      skeletalmesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered;
+    }
+  }
+}
+
 void UCarlaSettingsDelegate::LaunchEpicQualityCommands(UWorld* world) const
 {
   if(!world) return ;
@@ -56,6 +56,12 @@ private:
 
   /** */
   void SetPostProcessEffectsEnabled(UWorld* world, const bool enabled) const;
+
+  /** Enable or disable rendering the world to the viewport, if disabled turn off the features only needed for rendering too */
+  void SetRenderingEnabled(UWorld* world, const bool enabled) const;
+
+  /** Turn off the components of the actor that only matter when rendering (particles, animation of characters) */
+  void DisableRenderingOnlyComponents(AActor* actor) const;
   
   /** Execute engine commands to apply the epic quality settings to the world */
   void LaunchEpicQualityCommands(UWorld* world) const;
@@ -37,6 +37,14 @@ public:
     return false;
   }
 
+  /** Whether the sensor captures rendered images, these sensors are not
+    * available with rendering disabled.
+    */
+  virtual bool RequiresRendering() const
+  {
+    return false;
+  }
+
   virtual void AdjustToWeather(const FWeatherDescription &) {}
 
   virtual void Log() const;
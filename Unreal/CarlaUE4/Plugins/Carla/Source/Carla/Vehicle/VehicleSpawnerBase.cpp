@@ -7,6 +7,7 @@
 #include "Carla.h"
 #include "VehicleSpawnerBase.h"
 
+#include "Agent/AgentComponent.h"
 #include "Util/RandomEngine.h"
 #include "Vehicle/CarlaWheeledVehicle.h"
 #include "Vehicle/WheeledVehicleAIController.h"
@@ -32,6 +33,35 @@ static AWheeledVehicleAIController *GetController(ACarlaWheeledVehicle *Vehicle)
   return (VehicleIsValid(Vehicle) ? Cast<AWheeledVehicleAIController>(Vehicle->GetController()) : nullptr);
 }
 
+/// Enable or disable a pooled vehicle: visibility, collision, physics,
+/// controller tick, and agent registration.
+static void SetVehicleActive(ACarlaWheeledVehicle &Vehicle, const bool bActive)
+{
+  auto *Mesh = Vehicle.GetMesh();
+  check(Mesh != nullptr);
+  if (!bActive) {
+    Mesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+    Mesh->SetPhysicsAngularVelocity(FVector::ZeroVector);
+  }
+  Mesh->SetSimulatePhysics(bActive);
+  Vehicle.SetActorHiddenInGame(!bActive);
+  Vehicle.SetActorEnableCollision(bActive);
+  Vehicle.ApplyVehicleControl(FVehicleControl());
+  auto *Controller = Vehicle.GetController();
+  if (Controller != nullptr) {
+    Controller->SetActorTickEnabled(bActive);
+  }
+  TArray<UAgentComponent *> Agents;
+  Vehicle.GetComponents(Agents);
+  for (auto *Agent : Agents) {
+    if (bActive) {
+      Agent->RegisterAgentComponent();
+    } else {
+      Agent->DeregisterAgentComponent();
+    }
+  }
+}
+
 // =============================================================================
 // -- AVehicleSpawnerBase ------------------------------------------------------
 // =============================================================================
@@ -75,6 +105,16 @@ void AVehicleSpawnerBase::BeginPlay()
 	}
   }
   
+  SpawnVehicles();
+}
+
+void AVehicleSpawnerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+}
+
+void AVehicleSpawnerBase::SpawnVehicles()
+{
   if(NumberOfVehicles==0||SpawnPoints.Num()==0) bSpawnVehicles = false;
 
   if (bSpawnVehicles) 
@@ -119,9 +159,25 @@ void AVehicleSpawnerBase::BeginPlay()
   }
 }
 
-void AVehicleSpawnerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void AVehicleSpawnerBase::ReleaseVehicles()
 {
-	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+  GetWorld()->GetTimerManager().ClearTimer(AttemptTimerHandle);
+  for (auto *Vehicle : Vehicles) {
+    if (!VehicleIsValid(Vehicle)) {
+      continue;
+    }
+    auto *Controller = Vehicle->GetController();
+    if (bPoolVehicles && (Controller != nullptr)) {
+      SetVehicleActive(*Vehicle, false);
+      VehiclesPool.Add(Vehicle);
+    } else {
+      Vehicle->Destroy();
+      if (Controller != nullptr) {
+        Controller->Destroy();
+      }
+    }
+  }
+  Vehicles.Empty();
 }
 
 void AVehicleSpawnerBase::SetNumberOfVehicles(const int32 Count)
@@ -149,6 +205,15 @@ void AVehicleSpawnerBase::TryToSpawnRandomVehicle()
 ACarlaWheeledVehicle* AVehicleSpawnerBase::SpawnVehicleAtSpawnPoint(
     const APlayerStart &SpawnPoint)
 {
+  if (VehiclesPool.Num() > 0)
+  {
+    auto *PooledVehicle = TryToReuseVehicleAt(SpawnPoint.GetActorTransform());
+    if (PooledVehicle != nullptr)
+    {
+      return PooledVehicle;
+    }
+    // The pooled vehicle did not fit, try with a new actor instead.
+  }
   ACarlaWheeledVehicle *Vehicle;
   SpawnVehicle(SpawnPoint.GetActorTransform(), Vehicle);
   if ((Vehicle != nullptr) && !Vehicle->IsPendingKill())
@@ -171,6 +236,42 @@ ACarlaWheeledVehicle* AVehicleSpawnerBase::SpawnVehicleAtSpawnPoint(
   return Vehicle;
 }
 
+ACarlaWheeledVehicle* AVehicleSpawnerBase::TryToReuseVehicleAt(
+    const FTransform &Transform)
+{
+  ACarlaWheeledVehicle *Vehicle = nullptr;
+  while ((Vehicle == nullptr) && (VehiclesPool.Num() > 0))
+  {
+    Vehicle = VehiclesPool.Pop(false);
+    if (GetController(Vehicle) == nullptr)
+    {
+      // Destroyed while in the pool (e.g. by the level).
+      Vehicle = nullptr;
+    }
+  }
+  if (Vehicle == nullptr)
+  {
+    return nullptr;
+  }
+  const FVector Location = Transform.GetLocation();
+  const FRotator Rotation = Transform.Rotator();
+  Vehicle->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+  SetVehicleActive(*Vehicle, true);
+  if (GetWorld()->EncroachingBlockingGeometry(Vehicle, Location, Rotation))
+  {
+    SetVehicleActive(*Vehicle, false);
+    VehiclesPool.Add(Vehicle);
+    return nullptr;
+  }
+  auto Controller = GetController(Vehicle);
+  Controller->GetRandomEngine()->Seed(GetRandomEngine()->GenerateSeed());
+  Controller->SetRoadMap(GetRoadMap());
+  Controller->ResetAutopilot();
+  Controller->SetAutopilot(true);
+  Vehicles.Add(Vehicle);
+  return Vehicle;
+}
+
 void AVehicleSpawnerBase::SpawnVehicleAttempt()
 {
 	if(Vehicles.Num()>=NumberOfVehicles) 
@@ -41,6 +41,19 @@ public:
 
   void SetNumberOfVehicles(int32 Count);
 
+  /// Spawn the requested number of vehicles at random spawn points. Vehicles
+  /// that don't fit are spawned later on a timer. Called at begin play.
+  void SpawnVehicles();
+
+  /// Remove every vehicle spawned and cancel pending spawns. Vehicles are
+  /// kept in the pool if bPoolVehicles is set, destroyed otherwise.
+  void ReleaseVehicles();
+
+  int32 GetNumberOfPooledVehicles() const
+  {
+    return VehiclesPool.Num();
+  }
+
   int32 GetNumberOfSpawnedVehicles() const
   {
     return Vehicles.Num();
@@ -70,6 +83,10 @@ protected:
 
   ACarlaWheeledVehicle* SpawnVehicleAtSpawnPoint(const APlayerStart &SpawnPoint);
 
+  /// Take a vehicle from the pool and place it at @a Transform, return
+  /// nullptr if the pool is empty or the location is occupied.
+  ACarlaWheeledVehicle* TryToReuseVehicleAt(const FTransform &Transform);
+
   UPROPERTY()
   URoadMap *RoadMap = nullptr;
 
@@ -87,6 +104,15 @@ protected:
   UPROPERTY(Category = "Vehicle Spawner", BlueprintReadOnly, VisibleAnywhere, AdvancedDisplay)
   TArray<ACarlaWheeledVehicle *> Vehicles;
 
+  /** If true, removed vehicles are deactivated and kept in a pool, and new
+    * vehicles are taken from the pool before spawning new actors. */
+  UPROPERTY(Category = "Vehicle Spawner", EditAnywhere, meta = (EditCondition = bSpawnVehicles))
+  bool bPoolVehicles = true;
+
+  /** Inactive vehicles available for reuse. */
+  UPROPERTY(Category = "Vehicle Spawner", VisibleAnywhere, AdvancedDisplay)
+  TArray<ACarlaWheeledVehicle *> VehiclesPool;
+
   /** Time to spawn new vehicles after begin play if there was not enough spawn points at the moment */
   UPROPERTY(Category = "Vehicle Spawner", BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.1", ClampMax = "1000.0", UIMin = "0.1", UIMax = "1000.0"))
   float TimeBetweenSpawnAttemptsAfterBegin = 3.0f;
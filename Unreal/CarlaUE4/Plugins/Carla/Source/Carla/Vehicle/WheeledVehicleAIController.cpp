@@ -7,6 +7,8 @@
 #include "Carla.h"
 #include "WheeledVehicleAIController.h"
 
+#include "Agent/AgentComponent.h"
+#include "Game/CarlaGameInstance.h"
 #include "MapGen/RoadMap.h"
 #include "Vehicle/CarlaWheeledVehicle.h"
 
@@ -18,45 +20,31 @@
 // -- Static local methods -----------------------------------------------------
 // =============================================================================
 
-static bool RayTrace(const AActor &Actor, const FVector &Start, const FVector &End) {
-  FHitResult OutHit;
+/// Margin added around the obstacle traces when looking for agents in the
+/// spatial index, agents are indexed by the center of their actor and their
+/// location may be a frame old.
+static constexpr float OBSTACLE_AGENT_MARGIN = 400.0f;
+
+static FTraceHandle AsyncRayTrace(const AActor &Actor, const FVector &Start, const FVector &End) {
   static FName TraceTag = FName(TEXT("VehicleTrace"));
   FCollisionQueryParams CollisionParams(TraceTag, true);
   CollisionParams.AddIgnoredActor(&Actor);
 
-  const bool Success = Actor.GetWorld()->LineTraceSingleByObjectType(
-        OutHit,
-        Start,
-        End,
-        FCollisionObjectQueryParams(FCollisionObjectQueryParams::AllDynamicObjects),
-        CollisionParams);
-
-  return Success && OutHit.bBlockingHit;
+  return Actor.GetWorld()->AsyncLineTraceByObjectType(
+      EAsyncTraceType::Single,
+      Start,
+      End,
+      FCollisionObjectQueryParams(FCollisionObjectQueryParams::AllDynamicObjects),
+      CollisionParams);
 }
 
-static bool IsThereAnObstacleAhead(
-    const ACarlaWheeledVehicle &Vehicle,
-    const float Speed,
-    const FVector &Direction)
-{
-  const auto ForwardVector = Vehicle.GetVehicleOrientation();
-  const auto VehicleBounds = Vehicle.GetVehicleBoundingBoxExtent();
-
-  const float Distance = std::max(50.0f, Speed * Speed); // why?
-
-  const FVector StartCenter = Vehicle.GetActorLocation() + (ForwardVector * (250.0f + VehicleBounds.X / 2.0f)) + FVector(0.0f, 0.0f, 50.0f);
-  const FVector EndCenter = StartCenter + Direction * (Distance + VehicleBounds.X / 2.0f);
-
-  const FVector StartRight = StartCenter + (FVector(ForwardVector.Y, -ForwardVector.X, ForwardVector.Z) * 100.0f);
-  const FVector EndRight = StartRight + Direction * (Distance + VehicleBounds.X / 2.0f);
-
-  const FVector StartLeft = StartCenter + (FVector(-ForwardVector.Y, ForwardVector.X, ForwardVector.Z) * 100.0f);
-  const FVector EndLeft = StartLeft + Direction * (Distance + VehicleBounds.X / 2.0f);
-
-  return
-      RayTrace(Vehicle, StartCenter, EndCenter) ||
-      RayTrace(Vehicle, StartRight, EndRight) ||
-      RayTrace(Vehicle, StartLeft, EndLeft);
+static bool HasBlockingHit(const FTraceDatum &TraceData) {
+  for (auto &Hit : TraceData.OutHits) {
+    if (Hit.bBlockingHit) {
+      return true;
+    }
+  }
+  return false;
 }
 
 template <typename T>
@@ -100,13 +88,43 @@ void AWheeledVehicleAIController::Possess(APawn *aPawn)
   ConfigureAutopilot(bAutopilotEnabled);
 }
 
+void AWheeledVehicleAIController::BeginPlay()
+{
+  Super::BeginPlay();
+
+  auto *GameInstance = Cast<UCarlaGameInstance>(GetGameInstance());
+  if (GameInstance != nullptr) {
+    AgentSpatialIndex = &GameInstance->GetDataRouter().GetAgentSpatialIndex();
+  }
+
+  // The player's autopilot runs every frame, it drives the measurements sent
+  // to the client.
+  if (!IsPossessingThePlayer()) {
+    TickScheduler = FTickScheduler::Get(GetWorld());
+    if (TickScheduler != nullptr) {
+      TickScheduler->Register(ETickSubsystem::VehicleAI, TickState);
+    }
+  }
+}
+
 void AWheeledVehicleAIController::Tick(const float DeltaTime)
 {
   Super::Tick(DeltaTime);
 
-
   if (bAutopilotEnabled) {
-    TickAutopilotController();
+    if (TickScheduler == nullptr) {
+      TickAutopilotController();
+    } else {
+      // The trace results are only kept for a frame, collect them even if
+      // the autopilot is not updated this frame.
+      CollectObstacleTraces();
+      float AutopilotDeltaTime;
+      if (TickScheduler->ShouldTick(ETickSubsystem::VehicleAI, TickState, DeltaTime, AutopilotDeltaTime)) {
+        FTickScheduler::FScope Scope(*TickScheduler, ETickSubsystem::VehicleAI);
+        TickAutopilotController();
+      }
+    }
+    // In between updates the last control is kept.
     Vehicle->ApplyVehicleControl(AutopilotControl);
   }
 }
@@ -125,6 +143,8 @@ void AWheeledVehicleAIController::ConfigureAutopilot(const bool Enable)
   Vehicle->SetReverse(false);
   Vehicle->SetHandbrakeInput(false);
   TrafficLightState = ETrafficLightState::Green;
+  bObstacleAhead = false;
+  bObstacleTracesCollected = false;
   ClearQueue(TargetLocations);
   Vehicle->SetAIVehicleState(
       bAutopilotEnabled ?
@@ -184,7 +204,7 @@ void AWheeledVehicleAIController::TickAutopilotController()
   if (TrafficLightState != ETrafficLightState::Green) {
     Vehicle->SetAIVehicleState(ECarlaWheeledVehicleState::WaitingForRedLight);
     Throttle = Stop(Speed);
-  } else if (IsThereAnObstacleAhead(*Vehicle, Speed, Direction)) {
+  } else if (IsThereAnObstacleAhead(Speed, Direction)) {
     Vehicle->SetAIVehicleState(ECarlaWheeledVehicleState::ObstacleAhead);
     Throttle = Stop(Speed);
   } else {
@@ -345,6 +365,96 @@ float AWheeledVehicleAIController::CalcStreeringValue(FVector &direction)
   return steering;
 }
 
+bool AWheeledVehicleAIController::IsThereAnObstacleAhead(
+    const float Speed,
+    const FVector &Direction)
+{
+  CollectObstacleTraces();
+
+  // Without traces from the previous update (e.g., we were waiting at a red
+  // light, or the autopilot was just enabled) the last result may be stale,
+  // we'd rather wait one more tick than drive into something.
+  const bool bBlocked = (!bObstacleTracesCollected || bObstacleAhead);
+  bObstacleTracesCollected = false;
+
+  const auto ForwardVector = Vehicle->GetVehicleOrientation();
+  const auto VehicleBounds = Vehicle->GetVehicleBoundingBoxExtent();
+
+  const float Distance = std::max(50.0f, Speed * Speed); // why?
+  const float TraceLength = Distance + VehicleBounds.X / 2.0f;
+
+  const FVector StartCenter = Vehicle->GetActorLocation() + (ForwardVector * (250.0f + VehicleBounds.X / 2.0f)) + FVector(0.0f, 0.0f, 50.0f);
+  const FVector EndCenter = StartCenter + Direction * TraceLength;
+
+  if (!IsThereAnAgentAlong(StartCenter, Direction, TraceLength)) {
+    // Nothing to trace against, the way is clear now and on the next tick.
+    bObstacleAhead = false;
+    bObstacleTracesCollected = true;
+    return false;
+  }
+
+  // Request the traces for this tick, the physics scene resolves them in a
+  // batch and the results are read on the next tick.
+
+  const FVector StartRight = StartCenter + (FVector(ForwardVector.Y, -ForwardVector.X, ForwardVector.Z) * 100.0f);
+  const FVector EndRight = StartRight + Direction * TraceLength;
+
+  const FVector StartLeft = StartCenter + (FVector(-ForwardVector.Y, ForwardVector.X, ForwardVector.Z) * 100.0f);
+  const FVector EndLeft = StartLeft + Direction * TraceLength;
+
+  ObstacleTraceHandles[0u] = AsyncRayTrace(*Vehicle, StartCenter, EndCenter);
+  ObstacleTraceHandles[1u] = AsyncRayTrace(*Vehicle, StartRight, EndRight);
+  ObstacleTraceHandles[2u] = AsyncRayTrace(*Vehicle, StartLeft, EndLeft);
+
+  return bBlocked;
+}
+
+bool AWheeledVehicleAIController::IsThereAnAgentAlong(
+    const FVector &Start,
+    const FVector &Direction,
+    const float Length) const
+{
+  if (AgentSpatialIndex == nullptr) {
+    return true;
+  }
+  const FTransform Box(Direction.Rotation(), Start + Direction * (Length / 2.0f));
+  const FVector Extent(
+      Length / 2.0f + OBSTACLE_AGENT_MARGIN,
+      100.0f + OBSTACLE_AGENT_MARGIN,
+      OBSTACLE_AGENT_MARGIN);
+  TArray<UAgentComponent *> Agents;
+  AgentSpatialIndex->FindInBox(Box, Extent, Agents);
+  for (const auto *Agent : Agents) {
+    if (Agent->GetOwner() != Vehicle) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AWheeledVehicleAIController::CollectObstacleTraces()
+{
+  UWorld *World = GetWorld();
+  check(World != nullptr);
+
+  // Collect the results of the traces requested on the previous tick, if
+  // any.
+  bool bAnyResult = false;
+  bool bHit = false;
+  for (auto &Handle : ObstacleTraceHandles) {
+    FTraceDatum TraceData;
+    if (World->QueryTraceData(Handle, TraceData)) {
+      bAnyResult = true;
+      bHit |= HasBlockingHit(TraceData);
+    }
+    Handle = FTraceHandle();
+  }
+  if (bAnyResult) {
+    bObstacleAhead = bHit;
+    bObstacleTracesCollected = true;
+  }
+}
+
 float AWheeledVehicleAIController::Stop(const float Speed) {
   return (Speed >= 1.0f ? -Speed / SpeedLimit : 0.0f);
 }
@@ -10,13 +10,16 @@
 
 #include "Engine/EngineTypes.h"
 #include "GameFramework/PlayerController.h"
+#include "WorldCollision.h"
 
+#include "Game/TickScheduler.h"
 #include "Traffic/TrafficLightState.h"
 #include "Vehicle/VehicleControl.h"
 
 #include "WheeledVehicleAIController.generated.h"
 
 class ACarlaWheeledVehicle;
+class FAgentSpatialIndex;
 class URandomEngine;
 class URoadMap;
 
@@ -36,6 +39,15 @@ public:
 
   ~AWheeledVehicleAIController();
 
+  /// @}
+  // ===========================================================================
+  /// @name AActor overrides
+  // ===========================================================================
+  /// @{
+public:
+
+  virtual void BeginPlay() override;
+
   /// @}
   // ===========================================================================
   /// @name APlayerController overrides
@@ -138,6 +150,16 @@ public:
     ConfigureAutopilot(!bAutopilotEnabled);
   }
 
+  /// Clear the route and the traffic state keeping the autopilot mode, used
+  /// when the possessed vehicle is taken back from a pool. Unlike
+  /// APlayerController::Reset, the vehicle stays possessed.
+  void ResetAutopilot()
+  {
+    if (IsPossessingAVehicle()) {
+      ConfigureAutopilot(bAutopilotEnabled);
+    }
+  }
+
 private:
 
   void ConfigureAutopilot(bool Enable);
@@ -203,6 +225,20 @@ private:
   /// Returns steering value.
   float CalcStreeringValue(FVector &Direction);
 
+  /// Returns whether an obstacle was found ahead. The traces are requested
+  /// asynchronously, so the result corresponds to the previous tick; if no
+  /// traces were requested on the previous tick the way is considered
+  /// blocked.
+  bool IsThereAnObstacleAhead(float Speed, const FVector &Direction);
+
+  /// Whether any other agent is close to the segment of @a Length from
+  /// @a Start along @a Direction, according to the agent spatial index. Used
+  /// to skip the obstacle traces on an empty road.
+  bool IsThereAnAgentAlong(const FVector &Start, const FVector &Direction, float Length) const;
+
+  /// Read the results of the obstacle traces requested on the previous tick.
+  void CollectObstacleTraces();
+
   /// Returns throttle value.
   float Stop(float Speed);
 
@@ -242,4 +278,20 @@ private:
   FVehicleControl AutopilotControl;
 
   std::queue<FVector> TargetLocations;
+
+  /// Async traces requested on the previous tick for obstacle detection.
+  FTraceHandle ObstacleTraceHandles[3u];
+
+  bool bObstacleAhead = false;
+
+  /// Whether bObstacleAhead comes from traces not yet used by the autopilot.
+  bool bObstacleTracesCollected = false;
+
+  /// Null if the CARLA game instance is not present.
+  const FAgentSpatialIndex *AgentSpatialIndex = nullptr;
+
+  /// Null for the player, its autopilot is not scheduled.
+  FTickScheduler *TickScheduler = nullptr;
+
+  FTickScheduler::FTickState TickState;
 };
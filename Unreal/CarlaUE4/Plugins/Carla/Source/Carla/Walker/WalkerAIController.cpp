@@ -7,9 +7,13 @@
 #include "Carla.h"
 #include "WalkerAIController.h"
 
+#include "Agent/VehicleAgentComponent.h"
+#include "Agent/WalkerAgentComponent.h"
+#include "Game/AgentSpatialIndex.h"
 #include "Navigation/CrowdFollowingComponent.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISenseConfig_Sight.h"
+#include "GameFramework/Character.h"
 #include "WheeledVehicle.h"
 #include "WheeledVehicleMovementComponent.h"
 #include "AI/Navigation/NavigationSystem.h"
@@ -30,6 +34,7 @@ static constexpr float WALKER_SIGHT_RADIUS = 100.0f;
 static constexpr float WALKER_SPEED_DAMPING = 4.0f;
 static constexpr float WALKER_PERIPHERAL_VISION_ANGLE_IN_DEGREES = 60.0f;
 static constexpr float WALKER_MAX_TIME_PAUSED = 5.0f;
+static constexpr float WALKER_PATH_LENGTH = WALKER_SPEED_DAMPING * WALKER_SIGHT_RADIUS;
 static constexpr float VEHICLE_SAFETY_RADIUS = 600.0f;
 
 // =============================================================================
@@ -37,6 +42,8 @@ static constexpr float VEHICLE_SAFETY_RADIUS = 600.0f;
 // =============================================================================
 
 class PawnPath {
+  friend class AWalkerAIController;
+
   private:
   static FVector GetLocation(const AActor& Actor)
   {
@@ -73,7 +80,7 @@ class PawnPath {
   private:
   explicit PawnPath(const APawn& Walker)
       : Start(GetLocation(Walker))
-      , End(GetLocation(Walker) + GetForwardVector(Walker) * WALKER_SPEED_DAMPING * WALKER_SIGHT_RADIUS)
+      , End(GetLocation(Walker) + GetForwardVector(Walker) * WALKER_PATH_LENGTH)
   {
   }
 
@@ -173,7 +180,32 @@ void AWalkerAIController::Possess(APawn* aPawn)
   aPawn->OnTakeAnyDamage.AddDynamic(this, &AWalkerAIController::OnPawnTookDamage);
 }
 
+void AWalkerAIController::BeginPlay()
+{
+  Super::BeginPlay();
+  TickScheduler = FTickScheduler::Get(GetWorld());
+  if (TickScheduler != nullptr) {
+    // The scheduler decides the interval, with the walkers spread across it.
+    SetActorTickInterval(0.0f);
+    TickScheduler->Register(ETickSubsystem::WalkerAI, TickState);
+  }
+}
+
 void AWalkerAIController::Tick(float DeltaSeconds)
+{
+  if (TickScheduler != nullptr) {
+    float ScheduledDeltaSeconds;
+    if (!TickScheduler->ShouldTick(ETickSubsystem::WalkerAI, TickState, DeltaSeconds, ScheduledDeltaSeconds)) {
+      return;
+    }
+    FTickScheduler::FScope Scope(*TickScheduler, ETickSubsystem::WalkerAI);
+    TickWalker(ScheduledDeltaSeconds);
+  } else {
+    TickWalker(DeltaSeconds);
+  }
+}
+
+void AWalkerAIController::TickWalker(float DeltaSeconds)
 {
   Super::Tick(DeltaSeconds);
   TimeInState += DeltaSeconds;
@@ -200,6 +232,17 @@ void AWalkerAIController::Tick(float DeltaSeconds)
   }
 }
 
+void AWalkerAIController::Reset()
+{
+  Super::Reset();
+  StopMovement();
+  ControlWaypoints.Empty();
+  bClientControlled = false;
+  bPausedByVehicleConflict = false;
+  ChangeStatus(EWalkerStatus::Unknown);
+  TimeInState = 0.0f;
+}
+
 FPathFollowingRequestResult AWalkerAIController::MoveTo(
     const FAIMoveRequest& MoveRequest,
     FNavPathSharedPtr* OutPath)
@@ -306,6 +349,74 @@ void AWalkerAIController::SenseActors(TArray<AActor*> Actors)
   }
 }
 
+void AWalkerAIController::DisablePerception()
+{
+  auto* Perception = GetPerceptionComponent();
+  if (Perception != nullptr) {
+    Perception->OnPerceptionUpdated.RemoveDynamic(this, &AWalkerAIController::SenseActors);
+    Perception->UnregisterComponent();
+  }
+}
+
+void AWalkerAIController::UpdateVehicleConflicts(
+    const TArray<ACharacter*>& Walkers,
+    const FAgentSpatialIndex& AgentSpatialIndex)
+{
+  TSet<const AActor*> WalkersInConflict;
+  TArray<UAgentComponent*> NearbyAgents;
+  for (const auto* Agent : AgentSpatialIndex.GetAgents()) {
+    const auto* Vehicle =
+        (Agent->IsA<UVehicleAgentComponent>() ? Cast<AWheeledVehicle>(Agent->GetOwner()) : nullptr);
+    if (Vehicle == nullptr) {
+      continue;
+    }
+    // Any walker whose path may cross the vehicle's starts inside this box,
+    // the vehicle path plus a walker path on every side.
+    const PawnPath VehiclePath(*Vehicle);
+    const FVector Segment = VehiclePath.End - VehiclePath.Start;
+    const FTransform Box(Segment.Rotation(), (VehiclePath.Start + VehiclePath.End) / 2.0f);
+    const FVector Extent(Segment.Size() / 2.0f + WALKER_PATH_LENGTH, WALKER_PATH_LENGTH, WORLD_MAX);
+    NearbyAgents.Reset();
+    AgentSpatialIndex.FindInBox(Box, Extent, NearbyAgents);
+    for (const auto* NearbyAgent : NearbyAgents) {
+      const auto* Walker =
+          (NearbyAgent->IsA<UWalkerAgentComponent>() ? Cast<APawn>(NearbyAgent->GetOwner()) : nullptr);
+      if ((Walker != nullptr) &&
+          !WalkersInConflict.Contains(Walker) &&
+          PawnPath::Intersect(PawnPath(*Walker), VehiclePath, Walker->GetWorld())) {
+        WalkersInConflict.Add(Walker);
+      }
+    }
+  }
+  for (auto* Walker : Walkers) {
+    if ((Walker != nullptr) && !Walker->IsPendingKill()) {
+      auto* Controller = Cast<AWalkerAIController>(Walker->GetController());
+      if (Controller != nullptr) {
+        Controller->SetVehicleConflict(WalkersInConflict.Contains(Walker));
+      }
+    }
+  }
+}
+
+void AWalkerAIController::SetVehicleConflict(const bool bConflict)
+{
+  if (IsClientControlled()) {
+    return;
+  }
+  if (bConflict) {
+    if (Status == EWalkerStatus::Moving) {
+      TryPauseMovement();
+      bPausedByVehicleConflict = (Status == EWalkerStatus::Paused);
+    }
+  } else if (bPausedByVehicleConflict) {
+    bPausedByVehicleConflict = false;
+    if (Status == EWalkerStatus::Paused) {
+      LOG_AI_WALKER(Log, "vehicle conflict is clear, resuming movement");
+      TryResumeMovement();
+    }
+  }
+}
+
 void AWalkerAIController::TrySetMovement(bool paused)
 {
   if (paused)
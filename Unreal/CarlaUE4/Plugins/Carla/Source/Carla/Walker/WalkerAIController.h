@@ -9,9 +9,11 @@
 
 #include "AIController.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Game/TickScheduler.h"
 #include "WalkerAIController.generated.h"
 
 
+class FAgentSpatialIndex;
 class UAISenseConfig_Sight;
 
 UENUM(BlueprintType)
@@ -35,10 +37,15 @@ public:
 
   AWalkerAIController(const FObjectInitializer& ObjectInitializer);
 
+  virtual void BeginPlay() override;
+
   virtual void Possess(APawn *aPawn) override;
 
   virtual void Tick(float DeltaSeconds) override;
 
+  /// Stop moving and forget any client control, used when the possessed
+  /// walker is taken back from a pool.
+  virtual void Reset() override;
 
   virtual FPathFollowingRequestResult MoveTo(
       const FAIMoveRequest& MoveRequest,
@@ -67,7 +74,26 @@ public:
     return bClientControlled;
   }
 
+  /// Stop listening to AI perception. Vehicles are then expected to be
+  /// checked by UpdateVehicleConflicts.
+  void DisablePerception();
+
+  /// Check the forward path of each walker in @a Walkers against the
+  /// predicted path of every vehicle agent. Walkers in conflict are paused,
+  /// and walkers paused by a previous conflict that is now clear are resumed.
+  ///
+  /// Each vehicle is only tested against the walker agents that
+  /// @a AgentSpatialIndex finds around its path.
+  static void UpdateVehicleConflicts(
+      const TArray<ACharacter *> &Walkers,
+      const FAgentSpatialIndex &AgentSpatialIndex);
+
 private:
+  /// Update the walker, @a DeltaSeconds since its previous update.
+  void TickWalker(float DeltaSeconds);
+
+  void SetVehicleConflict(bool bConflict);
+
   void ChangeStatus(EWalkerStatus status);
   void TryResumeMovement();
   void RetryMovement();
@@ -87,5 +113,14 @@ private:
   float TimeInState=0.0f;
 
   bool bClientControlled=false;
+
+  /** Whether the walker was paused by UpdateVehicleConflicts. */
+  bool bPausedByVehicleConflict = false;
   TQueue<TPair<float, FVector>> ControlWaypoints;
+
+  /** Null if the CARLA game instance is not present, the actor tick
+    * interval is used instead. */
+  FTickScheduler *TickScheduler = nullptr;
+
+  FTickScheduler::FTickState TickState;
 };
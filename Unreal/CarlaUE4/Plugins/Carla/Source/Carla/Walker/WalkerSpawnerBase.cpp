@@ -7,9 +7,12 @@
 #include "Carla.h"
 #include "WalkerSpawnerBase.h"
 
+#include "Agent/AgentComponent.h"
 #include "Components/BoxComponent.h"
 #include "EngineUtils.h"
+#include "Game/CarlaGameInstance.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Util/RandomEngine.h"
 #include "Walker/WalkerAIController.h"
@@ -29,6 +32,32 @@ static AWalkerAIController* GetController(ACharacter* Walker)
   return (WalkerIsValid(Walker) ? Cast<AWalkerAIController>(Walker->GetController()) : nullptr);
 }
 
+/// Enable or disable a pooled walker: visibility, collision, movement,
+/// controller tick, and agent registration.
+static void SetWalkerActive(ACharacter& Walker, const bool bActive)
+{
+  auto* Movement = Walker.GetCharacterMovement();
+  check(Movement != nullptr);
+  Movement->StopMovementImmediately();
+  Movement->SetComponentTickEnabled(bActive);
+  Walker.SetActorHiddenInGame(!bActive);
+  Walker.SetActorEnableCollision(bActive);
+  auto* Controller = GetController(&Walker);
+  if (Controller != nullptr) {
+    Controller->Reset();
+    Controller->SetActorTickEnabled(bActive);
+  }
+  TArray<UAgentComponent*> Agents;
+  Walker.GetComponents(Agents);
+  for (auto* Agent : Agents) {
+    if (bActive) {
+      Agent->RegisterAgentComponent();
+    } else {
+      Agent->DeregisterAgentComponent();
+    }
+  }
+}
+
 static float GetDistance(const FVector& Location0, const FVector& Location1)
 {
   return FMath::Abs((Location0 - Location1).Size());
@@ -97,18 +126,8 @@ void AWalkerSpawnerBase::BeginPlay()
 #endif
   }
 
-  GetRandomEngine()->Shuffle(BeginSpawnPoints);
-
-  if (bSpawnWalkers && bSpawnWalkersAtBeginPlay) {
-    uint32 Count = 0u;
-    for (auto i = 0; i < NumberOfWalkers; ++i) {
-      if (TryToSpawnWalkerAt(*BeginSpawnPoints[i % BeginSpawnPoints.Num()])) {
-        ++Count;
-      }
-    }
-#ifdef CARLA_AI_WALKERS_EXTRA_LOG
-    UE_LOG(LogCarla, Log, TEXT("Spawned %d walkers at begin play."), Count);
-#endif
+  if (bSpawnWalkersAtBeginPlay) {
+    QueueInitialWalkers();
   }
 }
 
@@ -116,98 +135,179 @@ void AWalkerSpawnerBase::Tick(float DeltaTime)
 {
   Super::Tick(DeltaTime);
 
-  if (bSpawnWalkers && (NumberOfWalkers > GetCurrentNumberOfWalkers())) {
-    // Try to spawn one walker.
+  const double Deadline = FPlatformTime::Seconds() + 1e-6 * TickBudgetInMicroseconds;
+  auto HasTimeLeft = [this, Deadline]() {
+    return bReproducible || (TickBudgetInMicroseconds <= 0.0f) || (FPlatformTime::Seconds() < Deadline);
+  };
+
+  // Spawn walkers, at least one per tick if needed.
+  WalkersSpawnedLastTick = 0;
+  while (bSpawnWalkers && (NumberOfWalkers > GetCurrentNumberOfWalkers())) {
+    SpawnNextWalker();
+    if ((++WalkersSpawnedLastTick >= MaxWalkersSpawnedPerTick) || !HasTimeLeft()) {
+      break;
+    }
+  }
+
+  // Check the status of the walkers, alternating between black-listed and
+  // white-listed ones. Each walker is checked at most once per tick, walkers
+  // moved to the other list are skipped if already checked.
+  WalkersCheckedLastTick = 0;
+  WalkersCheckedThisTick.Reset();
+  int32 BlackListedToCheck = WalkersBlackList.Num();
+  int32 WhiteListedToCheck = Walkers.Num();
+  while ((BlackListedToCheck > 0) || (WhiteListedToCheck > 0)) {
+    if ((BlackListedToCheck-- > 0) && (WalkersBlackList.Num() > 0) && CheckNextBlackListedWalker()) {
+      ++WalkersCheckedLastTick;
+    }
+    if ((WhiteListedToCheck-- > 0) && (Walkers.Num() > 0) && CheckNextWalker()) {
+      ++WalkersCheckedLastTick;
+    }
+    if ((WalkersCheckedLastTick >= MaxWalkersCheckedPerTick) || !HasTimeLeft()) {
+      break;
+    }
+  }
+
+#ifdef CARLA_AI_WALKERS_EXTRA_LOG
+  UE_LOG(
+      LogCarla,
+      Log,
+      TEXT("Walker spawner: spawned %d, checked %d, pending spawn %d, black-listed %d"),
+      WalkersSpawnedLastTick,
+      WalkersCheckedLastTick,
+      GetNumberOfWalkersPendingSpawn(),
+      WalkersBlackList.Num());
+#endif // CARLA_AI_WALKERS_EXTRA_LOG
+}
+
+void AWalkerSpawnerBase::SpawnNextWalker()
+{
+  if (BeginPlaySpawnPoints.Num() > 0) {
+    TryToSpawnWalkerAt(*BeginPlaySpawnPoints.Pop(false));
+  } else {
     TryToSpawnWalkerAt(GetRandomSpawnPoint());
   }
+}
 
-  if (WalkersBlackList.Num() > 0) {
-    CurrentBlackWalkerIndexToCheck = ++CurrentBlackWalkerIndexToCheck % WalkersBlackList.Num();
-    ACharacter* BlackListedWalker = WalkersBlackList[CurrentBlackWalkerIndexToCheck];
-    AWalkerAIController* controller = BlackListedWalker != nullptr ? Cast<AWalkerAIController>(BlackListedWalker->GetController()) : nullptr;
-    if (BlackListedWalker != nullptr && controller != nullptr && IsValid(BlackListedWalker) && !controller->IsClientControlled()) {
-      const auto Status = GetWalkerStatus(BlackListedWalker);
+bool AWalkerSpawnerBase::CheckNextBlackListedWalker()
+{
+  check(WalkersBlackList.Num() > 0);
+  const int32 Index = CurrentBlackWalkerIndexToCheck % WalkersBlackList.Num();
+  ACharacter* BlackListedWalker = WalkersBlackList[Index];
+  // If the walker leaves the list, the one swapped into its place is next.
+  CurrentBlackWalkerIndexToCheck = Index + 1;
+  auto RemoveFromList = [&]() {
+    WalkersBlackList.RemoveAtSwap(Index);
+    CurrentBlackWalkerIndexToCheck = Index;
+  };
+  if (!MarkAsCheckedThisTick(BlackListedWalker)) {
+    return false;
+  }
+  AWalkerAIController* controller = BlackListedWalker != nullptr ? Cast<AWalkerAIController>(BlackListedWalker->GetController()) : nullptr;
+  if (BlackListedWalker != nullptr && controller != nullptr && IsValid(BlackListedWalker) && !controller->IsClientControlled()) {
+    const auto Status = GetWalkerStatus(BlackListedWalker);
 #ifdef CARLA_AI_WALKERS_EXTRA_LOG
-      UE_LOG(LogCarla, Log, TEXT("Watching walker %s with state %d"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker), (int)Status);
+    UE_LOG(LogCarla, Log, TEXT("Watching walker %s with state %d"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker), (int)Status);
 #endif
-      switch (Status) {
-      case EWalkerStatus::RunOver: {
-        //remove from list and wait for auto-destroy
-        WalkersBlackList.RemoveAtSwap(CurrentBlackWalkerIndexToCheck);
-        break;
-      }
-      case EWalkerStatus::MoveCompleted: {
-        BlackListedWalker->Destroy();
-        break;
-      }
-      default: {
-        switch (controller->GetMoveStatus()) {
-        case EPathFollowingStatus::Idle:
-          if (!controller->IsClientControlled()) {
-            if (!TrySetDestination(*BlackListedWalker)) {
-              if (!SetRandomWalkerDestination(BlackListedWalker)) {
+    switch (Status) {
+    case EWalkerStatus::RunOver: {
+      //remove from list and wait for auto-destroy
+      RemoveFromList();
+      break;
+    }
+    case EWalkerStatus::MoveCompleted: {
+      RemoveFromList();
+      ReleaseWalker(*BlackListedWalker);
+      break;
+    }
+    default: {
+      switch (controller->GetMoveStatus()) {
+      case EPathFollowingStatus::Idle:
+        if (!controller->IsClientControlled()) {
+          if (!TrySetDestination(*BlackListedWalker)) {
+            if (!SetRandomWalkerDestination(BlackListedWalker)) {
 #ifdef CARLA_AI_WALKERS_EXTRA_LOG
-                UE_LOG(LogCarla, Error, TEXT("Could not set a random destination to walker %s"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker));
+              UE_LOG(LogCarla, Error, TEXT("Could not set a random destination to walker %s"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker));
 #endif
-              }
             }
           }
-          break;
-        case EPathFollowingStatus::Waiting:
-          //incomplete path
-          break;
-        case EPathFollowingStatus::Paused:
-          //waiting for blueprint code
-          break;
-        case EPathFollowingStatus::Moving:
-          if (BlackListedWalker->GetVelocity().Size() > 1.0f) {
-            WalkersBlackList.RemoveAtSwap(CurrentBlackWalkerIndexToCheck);
-            Walkers.Add(BlackListedWalker);
-          }
-          break;
-        default:
-          break;
         }
         break;
-      }
-      }
-#ifdef CARLA_AI_WALKERS_EXTRA_LOG
-      UE_LOG(LogCarla, Log, TEXT("New state for walker %s : %d"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker), (int)GetWalkerStatus(BlackListedWalker));
-#endif
-    }
-  }
-
-  if (Walkers.Num() > 0) {
-    // Check one walker, if fails black-list it or kill it.
-    CurrentWalkerIndexToCheck = ++CurrentWalkerIndexToCheck % Walkers.Num();
-    auto Walker = Walkers[CurrentWalkerIndexToCheck];
-    if (Walker == nullptr || !IsValid(Walker)) {
-      Walkers.RemoveAtSwap(CurrentWalkerIndexToCheck);
-    } else {
-      const auto Status = GetWalkerStatus(Walker);
-      switch (Status) {
-      default:
-      case EWalkerStatus::Paused:
-      case EWalkerStatus::Unknown:
+      case EPathFollowingStatus::Waiting:
+        //incomplete path
         break;
-      case EWalkerStatus::RunOver: {
-        Walkers.RemoveAtSwap(CurrentWalkerIndexToCheck);
+      case EPathFollowingStatus::Paused:
+        //waiting for blueprint code
         break;
-      }
-      case EWalkerStatus::MoveCompleted:
-        Walker->Destroy();
+      case EPathFollowingStatus::Moving:
+        if (BlackListedWalker->GetVelocity().Size() > 1.0f) {
+          RemoveFromList();
+          Walkers.Add(BlackListedWalker);
+        }
         break;
-      case EWalkerStatus::Invalid:
-      case EWalkerStatus::Stuck: {
-        //SetRandomWalkerDestination(Walker);
-        // Black-list it and wait for this walker to move
-        WalkersBlackList.Add(Walker);
-        Walkers.RemoveAtSwap(CurrentWalkerIndexToCheck);
+      default:
         break;
       }
-      }
+      break;
+    }
+    }
+#ifdef CARLA_AI_WALKERS_EXTRA_LOG
+    UE_LOG(LogCarla, Log, TEXT("New state for walker %s : %d"), *UKismetSystemLibrary::GetDisplayName(BlackListedWalker), (int)GetWalkerStatus(BlackListedWalker));
+#endif
+  }
+  return true;
+}
+
+bool AWalkerSpawnerBase::CheckNextWalker()
+{
+  // Check one walker, if fails black-list it or kill it.
+  check(Walkers.Num() > 0);
+  const int32 Index = CurrentWalkerIndexToCheck % Walkers.Num();
+  auto Walker = Walkers[Index];
+  // If the walker leaves the list, the one swapped into its place is next.
+  CurrentWalkerIndexToCheck = Index + 1;
+  auto RemoveFromList = [&]() {
+    Walkers.RemoveAtSwap(Index);
+    CurrentWalkerIndexToCheck = Index;
+  };
+  if (!MarkAsCheckedThisTick(Walker)) {
+    return false;
+  }
+  if (Walker == nullptr || !IsValid(Walker)) {
+    RemoveFromList();
+  } else {
+    const auto Status = GetWalkerStatus(Walker);
+    switch (Status) {
+    default:
+    case EWalkerStatus::Paused:
+    case EWalkerStatus::Unknown:
+      break;
+    case EWalkerStatus::RunOver: {
+      RemoveFromList();
+      break;
+    }
+    case EWalkerStatus::MoveCompleted:
+      RemoveFromList();
+      ReleaseWalker(*Walker);
+      break;
+    case EWalkerStatus::Invalid:
+    case EWalkerStatus::Stuck: {
+      //SetRandomWalkerDestination(Walker);
+      // Black-list it and wait for this walker to move
+      WalkersBlackList.Add(Walker);
+      RemoveFromList();
+      break;
+    }
     }
   }
+  return true;
+}
+
+bool AWalkerSpawnerBase::MarkAsCheckedThisTick(ACharacter* Walker)
+{
+  bool bAlreadyChecked = false;
+  WalkersCheckedThisTick.Add(Walker, &bAlreadyChecked);
+  return !bAlreadyChecked;
 }
 
 bool AWalkerSpawnerBase::SetRandomWalkerDestination(ACharacter* Walker)
@@ -246,6 +346,69 @@ bool AWalkerSpawnerBase::SetRandomWalkerDestination(ACharacter* Walker)
 // -- Other member functions ---------------------------------------------------
 // =============================================================================
 
+void AWalkerSpawnerBase::QueueInitialWalkers()
+{
+  if (SpawnPoints.Num() < 2) {
+    // Spawning may have been enabled again by SetNumberOfWalkers.
+    bSpawnWalkers = false;
+  }
+
+  TArray<AWalkerSpawnPointBase*> BeginSpawnPoints;
+  for (TActorIterator<AWalkerSpawnPointBase> It(GetWorld()); It; ++It) {
+    BeginSpawnPoints.Add(*It);
+  }
+
+  GetRandomEngine()->Shuffle(BeginSpawnPoints);
+
+  // These walkers are spawned in batches during the next ticks, see
+  // SpawnNextWalker.
+  BeginPlaySpawnPoints.Reset();
+  if (bSpawnWalkers && (BeginSpawnPoints.Num() > 0)) {
+    // Spawn points are popped from the back, add them in reverse order.
+    BeginPlaySpawnPoints.Reserve(NumberOfWalkers);
+    for (auto i = NumberOfWalkers - 1; i >= 0; --i) {
+      BeginPlaySpawnPoints.Add(BeginSpawnPoints[i % BeginSpawnPoints.Num()]);
+    }
+  }
+}
+
+void AWalkerSpawnerBase::ReleaseWalkers()
+{
+  auto ReleaseAll = [this](TArray<ACharacter*>& List) {
+    // Empty the list first, ReleaseWalker expects the walkers removed.
+    const auto Released = MoveTemp(List);
+    List.Reset();
+    for (auto* Walker : Released) {
+      if (WalkerIsValid(Walker)) {
+        ReleaseWalker(*Walker);
+      }
+    }
+  };
+  ReleaseAll(Walkers);
+  ReleaseAll(WalkersBlackList);
+  BeginPlaySpawnPoints.Reset();
+  CurrentWalkerIndexToCheck = 0;
+  CurrentBlackWalkerIndexToCheck = 0;
+}
+
+void AWalkerSpawnerBase::ReleaseWalker(ACharacter& Walker)
+{
+  auto* Controller = GetController(&Walker);
+  const bool bCanBePooled =
+      bPoolWalkers &&
+      (Controller != nullptr) &&
+      (Controller->GetWalkerStatus() != EWalkerStatus::RunOver);
+  if (bCanBePooled) {
+    SetWalkerActive(Walker, false);
+    WalkersPool.Add(&Walker);
+  } else {
+    Walker.Destroy();
+    if (Controller != nullptr) {
+      Controller->Destroy();
+    }
+  }
+}
+
 void AWalkerSpawnerBase::SetNumberOfWalkers(const int32 Count)
 {
   if (Count > 0) {
@@ -279,11 +442,30 @@ bool AWalkerSpawnerBase::TryToSpawnWalkerAt(const AWalkerSpawnPointBase& SpawnPo
     return false;
   }
 
+  // Reuse a pooled walker, or spawn a new one if the pool is empty.
+  ACharacter* Walker = (WalkersPool.Num() > 0 ?
+      TryToReuseWalkerAt(SpawnPoint.GetActorTransform()) :
+      SpawnNewWalkerAt(SpawnPoint.GetActorTransform()));
+  auto Controller = GetController(Walker);
+  if (Controller == nullptr) {
+    return false;
+  }
+
+  // Add walker and set destination.
+  Walkers.Add(Walker);
+  if (Controller->MoveToLocation(Destination, -1.0f, false, true, true, true, nullptr, true) != EPathFollowingRequestResult::Type::RequestSuccessful) {
+    SetRandomWalkerDestination(Walker);
+  }
+  return true;
+}
+
+ACharacter* AWalkerSpawnerBase::SpawnNewWalkerAt(const FTransform& Transform)
+{
   // Spawn walker.
   ACharacter* Walker;
-  SpawnWalker(SpawnPoint.GetActorTransform(), Walker);
+  SpawnWalker(Transform, Walker);
   if (!WalkerIsValid(Walker)) {
-    return false;
+    return nullptr;
   }
 
   // Assign controller.
@@ -293,15 +475,58 @@ bool AWalkerSpawnerBase::TryToSpawnWalkerAt(const AWalkerSpawnPointBase& SpawnPo
   if (Controller == nullptr) { // Sometimes fails...
     UE_LOG(LogCarla, Error, TEXT("Something went wrong creating the controller for the new walker"));
     Walker->Destroy();
-    return false;
+    return nullptr;
   }
 
-  // Add walker and set destination.
-  Walkers.Add(Walker);
-  if (Controller->MoveToLocation(Destination, -1.0f, false, true, true, true, nullptr, true) != EPathFollowingRequestResult::Type::RequestSuccessful) {
-    SetRandomWalkerDestination(Walker);
+  if (bCheckVehicleConflictsPerCrowd || bReproducible) {
+    Controller->DisablePerception();
   }
-  return true;
+  return Walker;
+}
+
+ACharacter* AWalkerSpawnerBase::TryToReuseWalkerAt(const FTransform& Transform)
+{
+  ACharacter* Walker = nullptr;
+  while ((Walker == nullptr) && (WalkersPool.Num() > 0)) {
+    Walker = WalkersPool.Pop(false);
+    if (GetController(Walker) == nullptr) {
+      // Destroyed while in the pool (e.g. by the level).
+      Walker = nullptr;
+    }
+  }
+  if (Walker == nullptr) {
+    return nullptr;
+  }
+  // TeleportTo moves the walker out of the way of other actors if needed,
+  // and fails if no free spot is found nearby.
+  SetWalkerActive(*Walker, true);
+  if (!Walker->TeleportTo(Transform.GetLocation(), Transform.Rotator())) {
+    SetWalkerActive(*Walker, false);
+    WalkersPool.Add(Walker);
+    return nullptr;
+  }
+  if (bCheckVehicleConflictsPerCrowd || bReproducible) {
+    GetController(Walker)->DisablePerception();
+  }
+  return Walker;
+}
+
+void AWalkerSpawnerBase::UpdateVehicleConflicts()
+{
+  if (!bCheckVehicleConflictsPerCrowd && !bReproducible) {
+    return;
+  }
+  auto* GameInstance = Cast<UCarlaGameInstance>(GetGameInstance());
+  if (GameInstance == nullptr) {
+    return;
+  }
+  TArray<ACharacter*> Crowd;
+  Crowd.Reserve(GetCurrentNumberOfWalkers());
+  Crowd.Append(Walkers);
+  Crowd.Append(WalkersBlackList);
+  AWalkerAIController::UpdateVehicleConflicts(
+      Crowd,
+      GameInstance->GetDataRouter().GetAgentSpatialIndex());
 }
 
 bool AWalkerSpawnerBase::TrySetDestination(ACharacter& Walker)
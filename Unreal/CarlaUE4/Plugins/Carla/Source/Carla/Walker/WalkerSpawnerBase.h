@@ -65,6 +65,39 @@ public:
 
   void SetNumberOfWalkers(int32 Count);
 
+  /// Pause the walkers of the crowd whose path crosses a vehicle's, and
+  /// resume those no longer in conflict. Does nothing if the walkers use AI
+  /// perception instead. Called every tick by the game mode, so the checks
+  /// are not throttled with the spawner tick (see FTickScheduler).
+  void UpdateVehicleConflicts();
+
+  /// If true, the walkers do not depend on wall-clock time: the tick time
+  /// budget is ignored, and vehicle conflicts are checked per crowd instead
+  /// of with the (time-sliced) AI perception.
+  void SetReproducible(bool bInReproducible)
+  {
+    bReproducible = bInReproducible;
+  }
+
+  /// Time budget per tick in microseconds, see TickBudgetInMicroseconds.
+  float GetTickBudget() const
+  {
+    return TickBudgetInMicroseconds;
+  }
+
+  void SetTickBudget(float InTickBudgetInMicroseconds)
+  {
+    TickBudgetInMicroseconds = InTickBudgetInMicroseconds;
+  }
+
+  /// Queue the walkers to be present at begin play at random spawn points,
+  /// they are spawned in batches during the next ticks.
+  void QueueInitialWalkers();
+
+  /// Remove every walker spawned and cancel pending spawns. Walkers are kept
+  /// in the pool if bPoolWalkers is set, destroyed otherwise.
+  void ReleaseWalkers();
+
   int32 GetCurrentNumberOfWalkers() const
   {
     return Walkers.Num() + WalkersBlackList.Num();
@@ -78,6 +111,27 @@ public:
     return WalkersBlackList;
   }
 
+  /// Number of walkers missing to reach the requested number of walkers.
+  int32 GetNumberOfWalkersPendingSpawn() const
+  {
+    return FMath::Max(0, NumberOfWalkers - GetCurrentNumberOfWalkers());
+  }
+
+  int32 GetNumberOfWalkersSpawnedLastTick() const
+  {
+    return WalkersSpawnedLastTick;
+  }
+
+  int32 GetNumberOfWalkersCheckedLastTick() const
+  {
+    return WalkersCheckedLastTick;
+  }
+
+  int32 GetNumberOfPooledWalkers() const
+  {
+    return WalkersPool.Num();
+  }
+
 private:
 
   const AWalkerSpawnPointBase &GetRandomSpawnPoint();
@@ -86,9 +140,33 @@ private:
 
   bool TryToSpawnWalkerAt(const AWalkerSpawnPointBase &SpawnPoint);
 
+  /// Spawn a new walker with its controller, return nullptr on failure.
+  ACharacter *SpawnNewWalkerAt(const FTransform &Transform);
+
+  /// Take a walker from the pool and place it at @a Transform, return
+  /// nullptr if the pool is empty or the walker does not fit there.
+  ACharacter *TryToReuseWalkerAt(const FTransform &Transform);
+
+  /// Return @a Walker to the pool, or destroy it if pooling is disabled. The
+  /// walker must have been removed from the lists already.
+  void ReleaseWalker(ACharacter &Walker);
+
   bool TrySetDestination(ACharacter &Walker);
 
   bool SetRandomWalkerDestination(ACharacter * Walker);
+
+  void SpawnNextWalker();
+
+  /// Check the status of the black-listed walker under the cursor and move
+  /// the cursor forward. Return false if the walker was already checked
+  /// this tick.
+  bool CheckNextBlackListedWalker();
+
+  /// Same as CheckNextBlackListedWalker for the white-listed walkers.
+  bool CheckNextWalker();
+
+  /// Return false if @a Walker was already checked this tick.
+  bool MarkAsCheckedThisTick(ACharacter *Walker);
   /// @}
 
 private:
@@ -105,6 +183,31 @@ private:
   UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (EditCondition = bSpawnWalkers, ClampMin = "1"))
   int32 NumberOfWalkers = 10;
 
+  /** If true, spawned walkers don't use AI perception, instead the paths of
+    * all the walkers are checked against the vehicles once per tick. */
+  UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (EditCondition = bSpawnWalkers))
+  bool bCheckVehicleConflictsPerCrowd = true;
+
+  /** If true, walkers that complete their move are deactivated and kept in
+    * a pool, and new walkers are taken from the pool before spawning new
+    * actors. */
+  UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (EditCondition = bSpawnWalkers))
+  bool bPoolWalkers = true;
+
+  /** Maximum number of walkers spawned each tick. */
+  UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (EditCondition = bSpawnWalkers, ClampMin = "1"))
+  int32 MaxWalkersSpawnedPerTick = 10;
+
+  /** Maximum number of walkers whose status is checked each tick. */
+  UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (ClampMin = "1"))
+  int32 MaxWalkersCheckedPerTick = 100;
+
+  /** Time budget per tick for spawning walkers and checking their status, in
+    * microseconds. At least one walker is spawned and checked each tick. Set
+    * to zero to only apply the maximums above (e.g. for reproducible runs). */
+  UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (ClampMin = "0.0"))
+  float TickBudgetInMicroseconds = 1000.0f;
+
   /** Minimum walk distance in centimeters. */
   UPROPERTY(Category = "Walker Spawner", EditAnywhere, meta = (EditCondition = bSpawnWalkers))
   float MinimumWalkDistance = 1500.0f;
@@ -118,7 +221,27 @@ private:
   UPROPERTY(Category = "Walker Spawner", VisibleAnywhere, AdvancedDisplay)
   TArray<ACharacter *> WalkersBlackList;
 
-  uint32 CurrentWalkerIndexToCheck = 0u;
+  /** Inactive walkers available for reuse. */
+  UPROPERTY(Category = "Walker Spawner", VisibleAnywhere, AdvancedDisplay)
+  TArray<ACharacter *> WalkersPool;
+
+  /** Spawn points of the walkers to be present at begin play not yet
+    * spawned. */
+  UPROPERTY(Category = "Walker Spawner", VisibleAnywhere, AdvancedDisplay)
+  TArray<AWalkerSpawnPointBase *> BeginPlaySpawnPoints;
+
+  UPROPERTY(Category = "Walker Spawner", VisibleAnywhere, AdvancedDisplay)
+  int32 WalkersSpawnedLastTick = 0;
+
+  UPROPERTY(Category = "Walker Spawner", VisibleAnywhere, AdvancedDisplay)
+  int32 WalkersCheckedLastTick = 0;
+
+  bool bReproducible = false;
+
+  /** Index of the next walker to check in each list. */
+  int32 CurrentWalkerIndexToCheck = 0;
+
+  int32 CurrentBlackWalkerIndexToCheck = 0;
 
-  uint32 CurrentBlackWalkerIndexToCheck = 0u;
+  TSet<ACharacter *> WalkersCheckedThisTick;
 };
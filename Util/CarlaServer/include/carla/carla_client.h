@@ -0,0 +1,125 @@
+/* Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+ * de Barcelona (UAB).
+ *
+ * This work is licensed under the terms of the MIT license.
+ * For a copy, see <https://opensource.org/licenses/MIT>.
+ */
+
+#ifndef CARLA_CARLACLIENT_H
+#define CARLA_CARLACLIENT_H
+
+#include <stdint.h>
+
+#include <carla/carla_server.h>
+
+#ifndef CARLA_CLIENT_API
+#  define CARLA_CLIENT_API extern
+#endif // CARLA_CLIENT_API
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* ======================================================================== */
+  /* -- CARLA client -------------------------------------------------------- */
+  /* ======================================================================== */
+
+  /** CARLA Client
+    *
+    * Native counterpart of the Python CarlaClient, the messages are exchanged
+    * using the same types as the server API.
+    *
+    * int32_t as return type indicates the error code of the operation, it
+    * matches boost::asio::error::basic_errors. A value of 0 indicates success.
+    *
+    * Every function blocks until the operation is completed or the time-out
+    * given on connection is met.
+    *
+    * The data returned points into the buffers of the client (or the shared
+    * memory region of the server), it is valid until the next call to the
+    * same function.
+    */
+
+  typedef void* CarlaClientPtr;
+
+  CARLA_CLIENT_API const int32_t CARLA_CLIENT_SUCCESS;
+  CARLA_CLIENT_API const int32_t CARLA_CLIENT_TIMED_OUT;
+  CARLA_CLIENT_API const int32_t CARLA_CLIENT_OPERATION_ABORTED;
+
+  /* -- Creation and destruction -------------------------------------------- */
+
+  CARLA_CLIENT_API CarlaClientPtr carla_make_client();
+
+  /** Destroy a CARLA client instance, disconnecting it if necessary. */
+  CARLA_CLIENT_API void carla_free_client(CarlaClientPtr self);
+
+  /* -- Connecting and disconnecting ---------------------------------------- */
+
+  /** Connect to the world port of the server at @a host, retrying until the
+    * time-out if the server is not listening yet. If @a host is
+    * "unix://<path>", connect instead to the Unix domain sockets of the server
+    * (see carla_server_set_unix_socket_path).
+    *
+    * The time-out sets the time-out used for all the subsequent networking
+    * communications with the given instance.
+    */
+  CARLA_CLIENT_API int32_t carla_client_connect(
+      CarlaClientPtr self,
+      const char *host,
+      uint32_t world_port,
+      uint32_t timeout_milliseconds);
+
+  CARLA_CLIENT_API void carla_client_disconnect(CarlaClientPtr self);
+
+  /* -- Episodes ------------------------------------------------------------ */
+
+  /** Request a new episode with the contents of a CarlaSettings.ini file and
+    * wait for the scene description of the new episode.
+    */
+  CARLA_CLIENT_API int32_t carla_client_load_settings(
+      CarlaClientPtr self,
+      const char *ini_file,
+      struct carla_scene_description *scene);
+
+  /** Start the episode requested at the player start of index
+    * @a player_start_index of the scene description, and wait until the
+    * server is ready.
+    *
+    * Return values:
+    *   CARLA_CLIENT_SUCCESS The episode is ready, frames can be read.
+    *   CARLA_CLIENT_OPERATION_ABORTED The server failed to start the episode.
+    */
+  CARLA_CLIENT_API int32_t carla_client_start_episode(
+      CarlaClientPtr self,
+      uint32_t player_start_index);
+
+  /* -- Write and read functions -------------------------------------------- */
+
+  /** Read the measurements and the sensor data sent by the server this frame.
+    *
+    * The data of each sensor is given as sent by the server, the header is
+    * the sensor specific header (e.g. frame number, width, height, type and
+    * field of view of a camera image) followed by the data. With the shared
+    * memory transport the header and data point directly into the shared
+    * memory region, which is overwritten a few frames later. If the data of
+    * a sensor was already overwritten because the client lags behind, the
+    * read fails with ENOBUFS (no buffer space).
+    */
+  CARLA_CLIENT_API int32_t carla_client_read_data(
+      CarlaClientPtr self,
+      const struct carla_measurements **measurements,
+      const struct carla_sensor_data **sensor_data,
+      uint32_t *number_of_sensor_data);
+
+  /** Send the control to be applied this frame. In synchronous mode, the
+    * server waits for it before simulating the next frame.
+    */
+  CARLA_CLIENT_API int32_t carla_client_send_control(
+      CarlaClientPtr self,
+      const struct carla_control *control);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CARLA_CARLACLIENT_H */
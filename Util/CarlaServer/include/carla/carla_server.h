@@ -185,6 +185,9 @@ extern "C" {
     bool reverse;
     uint32_t number_of_agent_controls;
     struct carla_agent_control agent_controls[MAX_CONTROL_AGENTS];
+    /** Number of frames to apply this control before sending the next
+      * measurements, zero is the same as one. */
+    uint32_t repeat_frames;
   };
 
   /* ======================================================================== */
@@ -218,6 +221,33 @@ extern "C" {
   /* -- carla_measurements -------------------------------------------------- */
   /* ======================================================================== */
 
+  /** Timings of the server in milliseconds, measured since the previous
+    * measurements were sent.
+    */
+  struct carla_telemetry {
+    /** Time spent by the game thread in the last frame. */
+    float game_thread_time;
+    /** Time spent reading back the sensor data from the GPU. */
+    float sensor_readback_time;
+    /** Time blocked waiting for the control of the client. */
+    float read_control_time;
+    /** Filled by the server, the value given is ignored. Time spent encoding
+      * the previous measurements. */
+    float encode_time;
+    /** Filled by the server, the value given is ignored. Bytes of the
+      * previous measurements and sensor data sent to the client. */
+    uint64_t bytes_sent;
+    /** Pedestrians missing to reach the number requested. */
+    uint32_t walkers_pending_spawn;
+    /** Pedestrians spawned in the last update of the spawner. */
+    uint32_t walkers_spawned;
+    /** Pedestrians whose status was checked in the last update of the
+      * spawner. */
+    uint32_t walkers_checked;
+    /** Inactive pedestrians kept by the spawner for reuse. */
+    uint32_t walkers_pooled;
+  };
+
   struct carla_measurements {
     /** Frame counter. */
     uint32_t frame_number;
@@ -230,6 +260,8 @@ extern "C" {
     /** Non-player agents. */
     const struct carla_agent *non_player_agents;
     uint32_t number_of_non_player_agents;
+    /** Timings sent along with the measurements, null to send none. */
+    const struct carla_telemetry *telemetry;
   };
 
   /* ======================================================================== */
@@ -255,7 +287,9 @@ extern "C" {
 
   /* -- Creation and destruction -------------------------------------------- */
 
-  /** Create a CARLA server instance. */
+  /** Create a CARLA server instance. Several instances can be used in the
+    * same process if they are connected to different ports, including their
+    * observer ports. */
   CARLA_SERVER_API CarlaServerPtr carla_make_server();
 
   /** Destroy a CARLA server instance (disconnects all running servers
@@ -282,6 +316,54 @@ extern "C" {
       uint32_t world_port,
       uint32_t server_timeout_milliseconds);
 
+  /** Accept read-only observers at @a observer_port during the episodes,
+    * zero to disable (default). Observers receive the scene description
+    * followed by the same measurements and sensor data sent to the client,
+    * frames are dropped for observers that cannot keep up. Applies from the
+    * next episode on.
+    *
+    * @return CARLA_SERVER_SUCCESS or an error code if the port is invalid or
+    * already used by a CarlaServer instance of this process.
+    */
+  CARLA_SERVER_API int32_t carla_server_set_observer_port(
+      CarlaServerPtr self,
+      uint32_t observer_port);
+
+  /** Listen at the Unix domain sockets "<path>-<port>" instead of the TCP
+    * ports (e.g. "/tmp/carla-2000", "/tmp/carla-2001" and "/tmp/carla-2002"
+    * for @a path "/tmp/carla" and world port 2000), null or empty to use TCP
+    * (default). Observers always connect through TCP. Must be called before
+    * connecting. Only supported on Unix.
+    */
+  CARLA_SERVER_API void carla_server_set_unix_socket_path(
+      CarlaServerPtr self,
+      const char *path);
+
+  /** Write the sensor data to a shared memory region of @a size_in_bytes
+    * named "/carla-server-<port + 1>", zero to disable (default). The
+    * messages sent to the client reference the data in the region instead of
+    * containing it. The region is reused in a ring, it must hold a few frames
+    * of data. Only supported on Linux. Applies from the next episode on.
+    */
+  CARLA_SERVER_API void carla_server_set_shared_memory_size(
+      CarlaServerPtr self,
+      uint64_t size_in_bytes);
+
+  /** Record the scene description, the frames sent (with the sensor data
+    * inline) and the controls received to the file at @a path, null or empty
+    * to stop recording (default). Every episode goes to the same file, which
+    * is written by a separate thread and completed once the recording is
+    * stopped and its last episode has ended, or the server is freed.
+    * Recordings can be streamed again to a client with replay_carlaserver.
+    * Applies from the next episode on.
+    *
+    * @return CARLA_SERVER_SUCCESS or an error code if the file cannot be
+    * created.
+    */
+  CARLA_SERVER_API int32_t carla_server_set_recording_file(
+      CarlaServerPtr self,
+      const char *path);
+
   /** Signal the world server to disconnect. */
   CARLA_SERVER_API void carla_disconnect_server(CarlaServerPtr self);
 
@@ -337,6 +419,82 @@ extern "C" {
       CarlaServerPtr self,
       const carla_measurements &values);
 
+  /** Same as carla_write_measurements, but the sensor data does not need to
+    * be written beforehand. The sensor data with the same frame number as the
+    * measurements is sent along as soon as it is written, older sensor data
+    * is discarded.
+    *
+    * Return values:
+    *   CARLA_SERVER_SUCCESS Value was posted for sending.
+    *   CARLA_SERVER_OPERATION_ABORTED Agent server is missing.
+    */
+  CARLA_SERVER_API int32_t carla_write_measurements_pipelined(
+      CarlaServerPtr self,
+      const carla_measurements &values);
+
+  /* ======================================================================== */
+  /* -- Profiler ------------------------------------------------------------ */
+  /* ======================================================================== */
+
+  /** Statistics of a profiled scope, durations in nanoseconds. */
+  struct carla_profiler_scope {
+    /** "<context>.<name>", statically allocated. */
+    const char *name;
+    /** Number of times the scope was profiled. */
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    /** Percentiles 50, 99 and 99.9, within 6.25% of the exact value. */
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+  };
+
+  /** Copy the statistics of the profiled scopes of the process into
+    * @a scopes, at most @a size of them. Returns the number of scopes, which
+    * may be greater than @a size (call with a size of 0 to query it). Can be
+    * called from any thread.
+    */
+  CARLA_SERVER_API uint32_t carla_profiler_snapshot(
+      struct carla_profiler_scope *scopes,
+      uint32_t size);
+
+  /* ======================================================================== */
+  /* -- Tracer -------------------------------------------------------------- */
+  /* ======================================================================== */
+
+  /** Start or stop recording the timeline of the server, disabled by
+    * default. The last events of each thread are kept in memory, a few
+    * hundred kilobytes per thread.
+    */
+  CARLA_SERVER_API void carla_tracer_set_enabled(bool enabled);
+
+  /** Write the recorded events to the file at @a path in the Chrome trace
+    * event format (JSON), it can be opened with chrome://tracing or Perfetto.
+    * Can be called from any thread.
+    *
+    * Return values:
+    *   CARLA_SERVER_SUCCESS The file was written.
+    *   Any other value if the file could not be written.
+    */
+  CARLA_SERVER_API int32_t carla_tracer_dump(const char *path);
+
+  /* ======================================================================== */
+  /* -- Logging ------------------------------------------------------------- */
+  /* ======================================================================== */
+
+  /** Discard the log messages below @a level: 10 debug, 20 info, 30 warning,
+    * 40 error, 50 critical, 100 none. Levels below the one the library was
+    * compiled with have no effect.
+    */
+  CARLA_SERVER_API void carla_logging_set_level(int32_t level);
+
+  /** Log at most @a messages_per_second, the rest are dropped and counted.
+    * Zero (default) for no limit.
+    */
+  CARLA_SERVER_API void carla_logging_set_rate_limit(uint32_t messages_per_second);
+
 #ifdef __cplusplus
 }
 #endif
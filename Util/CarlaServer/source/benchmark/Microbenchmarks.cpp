@@ -0,0 +1,86 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+// Microbenchmarks of the costs paid on the server's hot paths. Wall-clock
+// measurements depend on the machine, so they are reported here instead of
+// being asserted by the unit tests.
+
+#include "Microbenchmarks.h"
+
+#include "carla/Logging.h"
+#include "carla/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename F>
+static double NanosecondsPerIteration(const uint64_t iterations, F &&function) {
+  const auto start = clock_type::now();
+  for (auto i = 0u; i < iterations; ++i) {
+    function();
+  }
+  const auto elapsed = clock_type::now() - start;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+      static_cast<double>(iterations);
+}
+
+/// Overhead of profiling an empty scope.
+static void ProfilerOverhead() {
+  const double ns_per_scope = NanosecondsPerIteration(10000000u, []() {
+    CARLA_PROFILE_SCOPE(Benchmark, Empty);
+  });
+  std::cout << "profiler overhead: " << ns_per_scope << " ns per scope" << std::endl;
+}
+
+/// Latency of a log call with several threads logging at the same time.
+static void LoggingLatencyWithContention() {
+  constexpr size_t number_of_threads = 4u;
+  constexpr size_t records_per_thread = 100000u;
+  std::ostream null_stream(nullptr);
+  carla::logging::SetOutput(null_stream, null_stream);
+  std::vector<std::vector<uint64_t>> latencies(number_of_threads);
+  std::vector<std::thread> threads;
+  for (auto i = 0u; i < number_of_threads; ++i) {
+    threads.emplace_back([i, &latencies]() {
+      auto &result = latencies[i];
+      result.reserve(records_per_thread);
+      for (auto j = 0u; j < records_per_thread; ++j) {
+        const auto start = clock_type::now();
+        carla::log_error("tcpserver", 2000, ": error reading message:", j);
+        const auto elapsed = clock_type::now() - start;
+        result.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  carla::logging::SetOutput(std::cout, std::cerr);
+
+  std::vector<uint64_t> all;
+  for (auto &result : latencies) {
+    all.insert(all.end(), result.begin(), result.end());
+  }
+  std::sort(all.begin(), all.end());
+  const auto percentile = [&all](double p) {
+    return all[static_cast<size_t>(p * static_cast<double>(all.size() - 1u))];
+  };
+  std::cout << "log call latency with " << number_of_threads << " threads: p50 = "
+            << percentile(0.5) << " ns, p99 = " << percentile(0.99) << " ns, p99.9 = "
+            << percentile(0.999) << " ns" << std::endl;
+}
+
+void RunMicrobenchmarks() {
+  ProfilerOverhead();
+  LoggingLatencyWithContention();
+}
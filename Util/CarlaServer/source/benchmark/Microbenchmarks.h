@@ -0,0 +1,11 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+/// Run the microbenchmarks of the instrumentation used by the server and
+/// print their results.
+void RunMicrobenchmarks();
@@ -0,0 +1,329 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+// End-to-end benchmark of the carla_server API. A fake game loop runs the
+// synchronous mode protocol against an in-process client (carla_client.h) on
+// loopback, and the frame rate, throughput and latency seen by the client are
+// reported. With --micro, the microbenchmarks of Microbenchmarks.cpp are run
+// instead.
+
+#include "Microbenchmarks.h"
+
+#include <carla/carla_client.h>
+#include <carla/carla_server.h>
+
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+static constexpr uint32_t TIMEOUT = 10u * 1000u;
+
+/// Frames not included in the statistics.
+static constexpr uint32_t WARM_UP_FRAMES = 10u;
+
+// =============================================================================
+// -- Options ------------------------------------------------------------------
+// =============================================================================
+
+struct Options {
+  uint32_t frames = 1000u;
+  uint32_t agents = 30u;
+  uint32_t sensors = 4u;
+  uint32_t width = 800u;
+  uint32_t height = 600u;
+  uint32_t port = 5300u;
+  uint64_t shared_memory_size = 0u;
+  std::string unix_socket_path;
+  bool micro = false;
+
+  uint64_t image_size() const {
+    return 4u * static_cast<uint64_t>(width) * height;
+  }
+};
+
+static void PrintUsage(const char *program) {
+  const Options defaults;
+  std::cout
+      << "Usage: " << program << " [options]\n"
+      << "  --frames=N         frames to run (default " << defaults.frames << ")\n"
+      << "  --agents=N         non-player agents in the measurements (default " << defaults.agents << ")\n"
+      << "  --sensors=N        cameras sending an image every frame (default " << defaults.sensors << ")\n"
+      << "  --width=N          width of the images (default " << defaults.width << ")\n"
+      << "  --height=N         height of the images (default " << defaults.height << ")\n"
+      << "  --port=N           world port, the next two are used too (default " << defaults.port << ")\n"
+      << "  --shared-memory=N  send the images through a shared memory region of N MiB\n"
+      << "  --unix-socket=PATH use Unix domain sockets \"PATH-<port>\" instead of TCP\n"
+      << "  --micro            run the microbenchmarks instead\n";
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+  for (auto i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0u, equal);
+    const auto value = (equal != std::string::npos ? arg.substr(equal + 1u) : "");
+    const auto number = [&]() { return static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)); };
+    if (name == "--frames") {
+      options.frames = number();
+    } else if (name == "--agents") {
+      options.agents = number();
+    } else if (name == "--sensors") {
+      options.sensors = number();
+    } else if (name == "--width") {
+      options.width = number();
+    } else if (name == "--height") {
+      options.height = number();
+    } else if (name == "--port") {
+      options.port = number();
+    } else if (name == "--shared-memory") {
+      options.shared_memory_size = uint64_t(number()) * 1024u * 1024u;
+    } else if (name == "--unix-socket") {
+      options.unix_socket_path = value;
+    } else if (name == "--micro") {
+      options.micro = true;
+    } else {
+      return false;
+    }
+  }
+  return (options.frames > WARM_UP_FRAMES) && (options.width > 0u) && (options.height > 0u);
+}
+
+// =============================================================================
+// -- Fake game and client -----------------------------------------------------
+// =============================================================================
+
+static bool Check(const char *operation, const int32_t ec) {
+  if (ec != 0) {
+    std::cerr << "benchmark: " << operation << " failed with error " << ec << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock_type::now().time_since_epoch()).count();
+}
+
+/// Time each frame is started by the game, read by the client.
+using Timeline = std::vector<std::atomic<int64_t>>;
+
+/// Same layout as the header of the images sent by ASceneCaptureCamera.
+struct ImageHeader {
+  uint64_t frame_number;
+  uint32_t width;
+  uint32_t height;
+  uint32_t type;
+  float fov;
+};
+
+/// Runs the synchronous mode protocol as the game does: every frame the
+/// measurements and the images are sent, and the game waits for the control.
+static bool RunGame(CarlaServerPtr server, const Options &options, Timeline &timeline) {
+  if (!Check("server connect", carla_server_connect(server, options.port, TIMEOUT))) {
+    return false;
+  }
+  carla_request_new_episode new_episode;
+  if (!Check("read new episode", carla_read_request_new_episode(server, new_episode, TIMEOUT))) {
+    return false;
+  }
+  std::vector<std::string> names(options.sensors);
+  std::vector<carla_sensor_definition> sensors(options.sensors);
+  for (auto i = 0u; i < options.sensors; ++i) {
+    names[i] = "Camera" + std::to_string(i);
+    sensors[i] = {i, CARLA_SERVER_CAMERA, names[i].c_str()};
+  }
+  const carla_transform start_spot = {};
+  const carla_scene_description scene = {
+      "BenchmarkTown", &start_spot, 1u, sensors.data(), options.sensors};
+  if (!Check("write scene description", carla_write_scene_description(server, scene, TIMEOUT))) {
+    return false;
+  }
+  carla_episode_start episode_start;
+  if (!Check("read episode start", carla_read_episode_start(server, episode_start, TIMEOUT))) {
+    return false;
+  }
+  if (!Check("write episode ready", carla_write_episode_ready(server, {true}, TIMEOUT))) {
+    return false;
+  }
+
+  std::vector<carla_agent> agents(options.agents);
+  for (auto i = 0u; i < options.agents; ++i) {
+    agents[i] = {};
+    agents[i].id = i;
+    agents[i].type = CARLA_SERVER_AGENT_VEHICLE;
+    agents[i].forward_speed = 10.0f;
+  }
+  // The server fills the encoding time and bytes sent.
+  const carla_telemetry telemetry = {};
+  std::vector<unsigned char> image(options.image_size());
+  for (auto i = 0u; i < image.size(); ++i) {
+    image[i] = static_cast<unsigned char>(i);
+  }
+  // Too big for the stack.
+  auto measurements = std::make_unique<carla_measurements>();
+  auto control = std::make_unique<carla_control>();
+  *measurements = {};
+  measurements->non_player_agents = agents.data();
+  measurements->number_of_non_player_agents = options.agents;
+  measurements->telemetry = &telemetry;
+
+  for (auto frame = 1u; frame <= options.frames; ++frame) {
+    timeline[frame] = Now();
+    measurements->frame_number = frame;
+    if (!Check("write measurements", carla_write_measurements_pipelined(server, *measurements))) {
+      return false;
+    }
+    const ImageHeader header = {frame, options.width, options.height, 1u, 90.0f};
+    for (auto i = 0u; i < options.sensors; ++i) {
+      const carla_sensor_data data = {
+          i, &header, sizeof(header), image.data(), static_cast<uint32_t>(image.size())};
+      if (!Check("write sensor data", carla_write_sensor_data(server, data))) {
+        return false;
+      }
+    }
+    if (!Check("read control", carla_read_control(server, *control, TIMEOUT))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Results {
+  std::vector<int64_t> latencies;
+  int64_t begin = 0;
+  int64_t end = 0;
+  uint64_t bytes_sent = 0u;
+};
+
+static bool RunClient(CarlaClientPtr client, const Options &options, const Timeline &timeline, Results &results) {
+  const std::string host = (options.unix_socket_path.empty() ?
+      std::string("127.0.0.1") :
+      "unix://" + options.unix_socket_path);
+  if (!Check("client connect", carla_client_connect(client, host.c_str(), options.port, TIMEOUT))) {
+    return false;
+  }
+  const std::string ini_file =
+      "[CARLA/Server]\nSynchronousMode=true\nSendTelemetry=true\n";
+  carla_scene_description scene;
+  if (!Check("load settings", carla_client_load_settings(client, ini_file.c_str(), &scene))) {
+    return false;
+  }
+  if (!Check("start episode", carla_client_start_episode(client, 0u))) {
+    return false;
+  }
+  auto control = std::make_unique<carla_control>();
+  *control = {};
+  control->throttle = 1.0f;
+  results.latencies.reserve(options.frames);
+  for (auto frame = 1u; frame <= options.frames; ++frame) {
+    const carla_measurements *measurements;
+    const carla_sensor_data *sensor_data;
+    uint32_t number_of_sensor_data;
+    if (!Check("read data", carla_client_read_data(client, &measurements, &sensor_data, &number_of_sensor_data))) {
+      return false;
+    }
+    const auto now = Now();
+    if ((measurements->frame_number != frame) || (number_of_sensor_data != options.sensors)) {
+      std::cerr << "benchmark: unexpected data at frame " << frame << std::endl;
+      return false;
+    }
+    if (frame == WARM_UP_FRAMES) {
+      results.begin = now;
+    } else if (frame > WARM_UP_FRAMES) {
+      results.latencies.push_back(now - timeline[frame]);
+      // Bytes sent with the previous frame.
+      results.bytes_sent += (measurements->telemetry != nullptr ? measurements->telemetry->bytes_sent : 0u);
+      results.end = now;
+    }
+    if (!Check("send control", carla_client_send_control(client, control.get()))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============================================================================
+// -- main ---------------------------------------------------------------------
+// =============================================================================
+
+static void PrintResults(const Options &options, Results &results) {
+  const auto frames = results.latencies.size();
+  const double seconds = 1e-9 * static_cast<double>(results.end - results.begin);
+  const double frames_per_second = static_cast<double>(frames) / seconds;
+  const double payload = static_cast<double>(options.sensors) *
+      static_cast<double>(sizeof(ImageHeader) + options.image_size());
+  std::sort(results.latencies.begin(), results.latencies.end());
+  const auto percentile = [&](double p) {
+    const auto &all = results.latencies;
+    return 1e-3 * static_cast<double>(all[static_cast<size_t>(p * static_cast<double>(all.size() - 1u))]);
+  };
+  std::cout
+      << "frames: " << frames << " (" << options.agents << " agents, "
+      << options.sensors << " images of " << options.width << 'x' << options.height << ")\n"
+      << "frame rate: " << frames_per_second << " frames/s\n"
+      << "sensor data: " << 1e-6 * payload * frames_per_second << " MB/s\n"
+      << "sent: " << 1e-6 * static_cast<double>(results.bytes_sent) / seconds
+      << " MB/s through the sockets\n"
+      << "latency from frame start to frame read: p50 = " << percentile(0.5)
+      << " us, p99 = " << percentile(0.99) << " us, max = " << percentile(1.0) << " us"
+      << std::endl;
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  carla_logging_set_level(CARLA_SERVER_LOG_LEVEL_WARNING);
+
+  if (options.micro) {
+    RunMicrobenchmarks();
+    return EXIT_SUCCESS;
+  }
+
+  auto server = carla_make_server();
+  if (options.shared_memory_size > 0u) {
+    carla_server_set_shared_memory_size(server, options.shared_memory_size);
+  }
+  if (!options.unix_socket_path.empty()) {
+    carla_server_set_unix_socket_path(server, options.unix_socket_path.c_str());
+  }
+  auto client = carla_make_client();
+
+  Timeline timeline(options.frames + 1u);
+  auto game = std::async(std::launch::async, [&]() {
+    return RunGame(server, options, timeline);
+  });
+  Results results;
+  const bool client_succeeded = RunClient(client, options, timeline, results);
+  // The client disconnects only once the game is done.
+  if (!client_succeeded) {
+    carla_client_disconnect(client);
+  }
+  const bool game_succeeded = game.get();
+  // Close the connections from the client side first, the server would wait
+  // for the client otherwise.
+  carla_free_client(client);
+  carla_free_server(server);
+
+  if (!client_succeeded || !game_succeeded) {
+    return EXIT_FAILURE;
+  }
+  PrintResults(options, results);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,374 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/Logging.h"
+
+#include "carla/NonCopyable.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace carla {
+namespace logging {
+
+namespace detail {
+
+  std::atomic<int> LEVEL{CARLA_SERVER_LOG_LEVEL};
+
+  std::atomic<uint32_t> RATE_LIMIT{0u};
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    /// Fixed size buffer of a stream, the characters that do not fit are
+    /// discarded.
+    class RecordBuffer : public std::streambuf {
+    public:
+
+      RecordBuffer() {
+        Reset();
+      }
+
+      void Reset() {
+        setp(_data.data(), _data.data() + _data.size());
+        _truncated = false;
+      }
+
+      const char *data() const {
+        return pbase();
+      }
+
+      /// The line is terminated with "...\n" if truncated.
+      size_t size() {
+        if (_truncated) {
+          std::memcpy(epptr() - 4, "...\n", 4u);
+        }
+        return static_cast<size_t>(pptr() - pbase());
+      }
+
+    protected:
+
+      int_type overflow(int_type ch) override {
+        _truncated = true;
+        return traits_type::not_eof(ch);
+      }
+
+    private:
+
+      std::array<char, MaxRecordSize> _data;
+
+      bool _truncated;
+    };
+
+    class RecordStream : private NonCopyable {
+    public:
+
+      RecordStream() : _stream(&_buffer), _flags(_stream.flags()) {}
+
+      std::ostream &Begin() {
+        _buffer.Reset();
+        _stream.flags(_flags);
+        return _stream;
+      }
+
+      RecordBuffer &GetBuffer() {
+        return _buffer;
+      }
+
+    private:
+
+      RecordBuffer _buffer;
+
+      std::ostream _stream;
+
+      const std::ios_base::fmtflags _flags;
+    };
+
+    thread_local RecordStream RECORD_STREAM;
+
+    struct Record {
+      std::atomic<uint64_t> sequence;
+      int level;
+      uint32_t size;
+      char data[MaxRecordSize];
+    };
+
+    /// Bounded multi-producer single-consumer queue, the slots are claimed
+    /// with a compare-and-swap and published with the sequence number of each
+    /// slot.
+    class RecordQueue : private NonCopyable {
+    public:
+
+      RecordQueue() {
+        for (auto i = 0u; i < QueueSize; ++i) {
+          _records[i].sequence.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      /// Returns false if the queue is full.
+      bool TryPush(const int level, const char *data, const size_t size) {
+        auto position = _tail.load(std::memory_order_relaxed);
+        Record *record;
+        for (;;) {
+          record = &_records[position % QueueSize];
+          const auto sequence = record->sequence.load(std::memory_order_acquire);
+          const auto difference = static_cast<int64_t>(sequence - position);
+          if (difference == 0) {
+            if (_tail.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+              break;
+            }
+          } else if (difference < 0) {
+            return false;
+          } else {
+            position = _tail.load(std::memory_order_relaxed);
+          }
+        }
+        record->level = level;
+        record->size = static_cast<uint32_t>(size);
+        std::memcpy(record->data, data, size);
+        record->sequence.store(position + 1u, std::memory_order_release);
+        return true;
+      }
+
+      /// Only called by the consumer.
+      const Record *TryFront() const {
+        const auto &record = _records[_head % QueueSize];
+        const auto sequence = record.sequence.load(std::memory_order_acquire);
+        return (sequence == _head + 1u ? &record : nullptr);
+      }
+
+      /// Only called by the consumer, after TryFront succeeds.
+      void Pop() {
+        _records[_head % QueueSize].sequence.store(_head + QueueSize, std::memory_order_release);
+        ++_head;
+      }
+
+      uint64_t GetTail() const {
+        return _tail.load(std::memory_order_relaxed);
+      }
+
+      uint64_t GetHead() const {
+        return _head;
+      }
+
+    private:
+
+      std::atomic<uint64_t> _tail{0u};
+
+      uint64_t _head = 0u;
+
+      std::array<Record, QueueSize> _records;
+    };
+
+    /// Drains the queue into the output streams in a background thread.
+    /// Leaked so the static objects can still log during destruction.
+    class Logger : private NonCopyable {
+    public:
+
+      static Logger &Get() {
+        static Logger *logger = new Logger;
+        return *logger;
+      }
+
+      void Push(const int level, const char *data, const size_t size) {
+        if (!_queue.TryPush(level, data, size)) {
+          _dropped.fetch_add(1u, std::memory_order_relaxed);
+        }
+        WakeUp();
+      }
+
+      bool TakeToken() {
+        const auto now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        auto window = _window.load(std::memory_order_relaxed);
+        if ((window != now) && _window.compare_exchange_strong(window, now)) {
+          _records_in_window.store(0u, std::memory_order_relaxed);
+        }
+        const auto limit = detail::RATE_LIMIT.load(std::memory_order_relaxed);
+        if (_records_in_window.fetch_add(1u, std::memory_order_relaxed) < limit) {
+          return true;
+        }
+        _suppressed.fetch_add(1u, std::memory_order_relaxed);
+        WakeUp();
+        return false;
+      }
+
+      /// Start a new window, the records of the previous limit don't count.
+      void ResetRateLimit() {
+        _records_in_window.store(0u, std::memory_order_relaxed);
+      }
+
+      void Flush() {
+        const auto target = _queue.GetTail();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake_up.notify_one();
+        _flushed.wait_for(lock, std::chrono::seconds(1), [&]() {
+          // The records discarded so far are reported too.
+          return (_written >= target) &&
+                 (_dropped.load(std::memory_order_relaxed) == 0u) &&
+                 (_suppressed.load(std::memory_order_relaxed) == 0u);
+        });
+      }
+
+      void SetOutput(std::ostream &out, std::ostream &err) {
+        Flush();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _out = &out;
+        _err = &err;
+      }
+
+    private:
+
+      Logger() {
+        std::thread([this]() { Run(); }).detach();
+      }
+
+      void Run() {
+        for (;;) {
+          std::unique_lock<std::mutex> lock(_mutex);
+          if (!WriteRecords()) {
+            // Check again once the producers can see we are going to sleep,
+            // a record published before that would not wake us up.
+            _sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasPendingRecords()) {
+              _wake_up.wait(lock);
+            }
+            _sleeping.store(false, std::memory_order_relaxed);
+          }
+        }
+      }
+
+      /// Called by the producers after publishing a record or a counter. Only
+      /// the first one after the background thread went to sleep takes the
+      /// mutex.
+      void WakeUp() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleeping.load(std::memory_order_relaxed) &&
+            _sleeping.exchange(false, std::memory_order_relaxed)) {
+          // The background thread holds the mutex until it waits.
+          std::lock_guard<std::mutex> lock(_mutex);
+          _wake_up.notify_one();
+        }
+      }
+
+      bool HasPendingRecords() const {
+        return (_queue.TryFront() != nullptr) ||
+               (_dropped.load(std::memory_order_relaxed) > 0u) ||
+               (_suppressed.load(std::memory_order_relaxed) > 0u);
+      }
+
+      /// Returns false if there was nothing to write.
+      bool WriteRecords() {
+        bool written = false;
+        const Record *record;
+        while ((record = _queue.TryFront()) != nullptr) {
+          auto &stream = (record->level < CARLA_SERVER_LOG_LEVEL_WARNING ? *_out : *_err);
+          stream.write(record->data, record->size);
+          _queue.Pop();
+          written = true;
+        }
+        written |= ReportDiscarded(_dropped, "dropped, the queue is full");
+        written |= ReportDiscarded(_suppressed, "suppressed by the rate limit");
+        if (written) {
+          _out->flush();
+          _err->flush();
+        }
+        _written = _queue.GetHead();
+        _flushed.notify_all();
+        return written;
+      }
+
+      bool ReportDiscarded(std::atomic<uint64_t> &counter, const char *reason) {
+        const auto count = counter.exchange(0u, std::memory_order_relaxed);
+        if (count > 0u) {
+          *_err << "WARNING: " << count << " log messages " << reason << '\n';
+        }
+        return (count > 0u);
+      }
+
+      RecordQueue _queue;
+
+      std::atomic<uint64_t> _dropped{0u};
+
+      std::atomic<uint64_t> _suppressed{0u};
+
+      std::atomic<uint64_t> _window{0u};
+
+      std::atomic<uint32_t> _records_in_window{0u};
+
+      /// Whether the background thread is waiting, or about to wait, for
+      /// records.
+      std::atomic<bool> _sleeping{false};
+
+      /// Protects the members below, only locked by the background thread,
+      /// the functions that wait for it and the producer waking it up.
+      std::mutex _mutex;
+
+      std::condition_variable _wake_up;
+
+      std::condition_variable _flushed;
+
+      uint64_t _written = 0u;
+
+      std::ostream *_out = &std::cout;
+
+      std::ostream *_err = &std::cerr;
+    };
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Logging ----------------------------------------------------------------
+  // ===========================================================================
+
+namespace detail {
+
+  bool TakeToken() {
+    return Logger::Get().TakeToken();
+  }
+
+  std::ostream &BeginRecord() {
+    return RECORD_STREAM.Begin();
+  }
+
+  void EndRecord(const int level) {
+    auto &buffer = RECORD_STREAM.GetBuffer();
+    const auto size = buffer.size();
+    Logger::Get().Push(level, buffer.data(), size);
+  }
+
+} // namespace detail
+
+  void SetLevel(const int level) {
+    detail::LEVEL = level;
+  }
+
+  void SetRateLimit(const uint32_t records_per_second) {
+    detail::RATE_LIMIT = records_per_second;
+    Logger::Get().ResetRateLimit();
+  }
+
+  void Flush() {
+    Logger::Get().Flush();
+  }
+
+  void SetOutput(std::ostream &out, std::ostream &err) {
+    Logger::Get().SetOutput(out, err);
+  }
+
+} // namespace logging
+} // namespace carla
@@ -33,17 +33,70 @@
 //
 //  * LOG_DEBUG_ONLY(/* code here */)
 //  * LOG_INFO_ONLY(/* code here */)
+//
+// The records are formatted in a buffer of the calling thread and queued, a
+// background thread writes them to stdout (debug and info) or stderr. Logging
+// never blocks, if the queue is full the record is dropped and counted.
+//
+// At runtime the level can be raised with logging::SetLevel and the number of
+// records per second limited with logging::SetRateLimit.
 
 // =============================================================================
 // -- Implementation of log functions ------------------------------------------
 // =============================================================================
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 
 namespace carla {
 
 namespace logging {
 
+  /// Number of records the queue holds.
+  static constexpr size_t QueueSize = 1024u;
+
+  /// Records longer than this are truncated.
+  static constexpr size_t MaxRecordSize = 500u;
+
+namespace detail {
+
+  extern std::atomic<int> LEVEL;
+
+  extern std::atomic<uint32_t> RATE_LIMIT;
+
+  /// Whether the rate limit lets one more record through this second.
+  bool TakeToken();
+
+  /// Clear the stream of the calling thread and return it.
+  std::ostream &BeginRecord();
+
+  /// Queue the record formatted in the stream of the calling thread.
+  void EndRecord(int level);
+
+} // namespace detail
+
+  static inline int GetLevel() {
+    return detail::LEVEL.load(std::memory_order_relaxed);
+  }
+
+  /// Records below @a level are discarded. Levels below
+  /// CARLA_SERVER_LOG_LEVEL have no effect, these are removed at compile
+  /// time.
+  void SetLevel(int level);
+
+  /// Log at most @a records_per_second, the rest are dropped and counted.
+  /// Zero (default) for no limit.
+  void SetRateLimit(uint32_t records_per_second);
+
+  /// Block until the records queued so far are written, or a second passes.
+  void Flush();
+
+  /// Write the records to @a out and @a err instead of stdout and stderr.
+  /// The streams must outlive the logger, or be replaced before destroyed.
+  void SetOutput(std::ostream &out, std::ostream &err);
+
   // https://stackoverflow.com/a/27375675
   template <typename Arg, typename ... Args>
   static void print(std::ostream &out, Arg &&arg, Args &&... args) {
@@ -52,13 +105,23 @@ namespace logging {
     (void)expander{0, (void(out << ' ' << std::forward<Args>(args)),0)...};
   }
 
+  template <typename ... Args>
+  static inline void write(const int level, Args &&... args) {
+    if ((level < GetLevel()) ||
+        ((detail::RATE_LIMIT.load(std::memory_order_relaxed) != 0u) && !detail::TakeToken())) {
+      return;
+    }
+    print(detail::BeginRecord(), std::forward<Args>(args)...);
+    detail::EndRecord(level);
+  }
+
 } // namespace logging
 
 #if CARLA_SERVER_LOG_LEVEL <= CARLA_SERVER_LOG_LEVEL_DEBUG
 
   template <typename ... Args>
   static inline void log_debug(Args &&... args) {
-    logging::print(std::cout, "DEBUG:", std::forward<Args>(args)..., '\n');
+    logging::write(CARLA_SERVER_LOG_LEVEL_DEBUG, "DEBUG:", std::forward<Args>(args)..., '\n');
   }
 
 #else
@@ -72,7 +135,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_info(Args &&... args) {
-    logging::print(std::cout, "INFO: ", std::forward<Args>(args)..., '\n');
+    logging::write(CARLA_SERVER_LOG_LEVEL_INFO, "INFO: ", std::forward<Args>(args)..., '\n');
   }
 
 #else
@@ -86,7 +149,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_warning(Args &&... args) {
-    logging::print(std::cerr, "WARNING:", std::forward<Args>(args)..., '\n');
+    logging::write(CARLA_SERVER_LOG_LEVEL_WARNING, "WARNING:", std::forward<Args>(args)..., '\n');
   }
 
 #else
@@ -100,7 +163,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_error(Args &&... args) {
-    logging::print(std::cerr, "ERROR:", std::forward<Args>(args)..., '\n');
+    logging::write(CARLA_SERVER_LOG_LEVEL_ERROR, "ERROR:", std::forward<Args>(args)..., '\n');
   }
 
 #else
@@ -114,7 +177,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_critical(Args &&... args) {
-    logging::print(std::cerr, "CRITICAL:", std::forward<Args>(args)..., '\n');
+    logging::write(CARLA_SERVER_LOG_LEVEL_CRITICAL, "CRITICAL:", std::forward<Args>(args)..., '\n');
   }
 
 #else
@@ -0,0 +1,196 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+namespace carla {
+namespace profiler {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    /// Time-stamps taken together at start-up to calibrate the clock.
+    struct ClockOrigin {
+      const std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+      const Clock::rep ticks = Clock::Now();
+    };
+
+    const ClockOrigin &GetClockOrigin() {
+      static ClockOrigin origin;
+      return origin;
+    }
+
+    /// Registry of the scopes, leaked so they outlive the static objects that
+    /// may still profile during destruction.
+    class Registry {
+    public:
+
+      static Registry &Get() {
+        static Registry *registry = new Registry;
+        return *registry;
+      }
+
+      Registry() {
+        // Take the origin of the clock with the first scope, not with the
+        // first snapshot.
+        GetClockOrigin();
+      }
+
+      Scope &GetScope(const char *name) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto &scope = _scopes[name];
+        if (scope == nullptr) {
+          scope = std::make_unique<Scope>(name);
+          _ordered_scopes.push_back(scope.get());
+        }
+        return *scope;
+      }
+
+      std::vector<ScopeStatistics> GetStatistics() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<ScopeStatistics> result;
+        result.reserve(_ordered_scopes.size());
+        for (auto *scope : _ordered_scopes) {
+          result.push_back(scope->GetStatistics());
+        }
+        return result;
+      }
+
+    private:
+
+      std::mutex _mutex;
+
+      std::unordered_map<std::string, std::unique_ptr<Scope>> _scopes;
+
+      /// In order of registration.
+      std::vector<Scope *> _ordered_scopes;
+    };
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Clock ------------------------------------------------------------------
+  // ===========================================================================
+
+  double Clock::GetNanosecondsPerTick() {
+#ifdef CARLA_PROFILER_WITH_TSC
+    const auto &origin = GetClockOrigin();
+    const auto ticks = Now() - origin.ticks;
+    const auto elapsed = std::chrono::steady_clock::now() - origin.time;
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return ((ticks > 0u) && (nanoseconds > 0)) ?
+        static_cast<double>(nanoseconds) / static_cast<double>(ticks) :
+        1.0;
+#else
+    using period = std::chrono::steady_clock::period;
+    return 1e9 * static_cast<double>(period::num) / static_cast<double>(period::den);
+#endif // CARLA_PROFILER_WITH_TSC
+  }
+
+  // ===========================================================================
+  // -- Histogram --------------------------------------------------------------
+  // ===========================================================================
+
+  constexpr size_t Histogram::SubBucketBits;
+  constexpr size_t Histogram::SubBuckets;
+  constexpr size_t Histogram::NumberOfBuckets;
+
+  uint64_t Histogram::GetBucketUpperBound(const size_t index) {
+    if (index < SubBuckets) {
+      return index;
+    }
+    const size_t shift = index / SubBuckets - 1u;
+    const uint64_t lower_bound = (SubBuckets + index % SubBuckets) << shift;
+    return lower_bound + ((uint64_t(1u) << shift) - 1u);
+  }
+
+  // ===========================================================================
+  // -- Scope ------------------------------------------------------------------
+  // ===========================================================================
+
+  Histogram &Scope::MakeThreadHistogram() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _histograms.emplace_back(std::make_unique<Histogram>());
+    return *_histograms.back();
+  }
+
+  ScopeStatistics Scope::GetStatistics() const {
+    uint64_t count = 0u;
+    uint64_t total = 0u;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0u;
+    std::vector<uint64_t> buckets(Histogram::NumberOfBuckets, 0u);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (auto &histogram : _histograms) {
+        count += histogram->GetCount();
+        total += histogram->GetTotal();
+        min = std::min(min, histogram->GetMinimum());
+        max = std::max(max, histogram->GetMaximum());
+        for (auto i = 0u; i < buckets.size(); ++i) {
+          buckets[i] += histogram->GetBucket(i);
+        }
+      }
+    }
+
+    // The counters are read while the threads keep writing, the buckets may
+    // not add up exactly to the count.
+    uint64_t recorded = 0u;
+    for (auto bucket : buckets) {
+      recorded += bucket;
+    }
+
+    const auto percentile = [&](const double quantile) -> uint64_t {
+      const auto rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(recorded)));
+      uint64_t accumulated = 0u;
+      for (auto i = 0u; i < buckets.size(); ++i) {
+        accumulated += buckets[i];
+        if ((accumulated > 0u) && (accumulated >= rank)) {
+          return std::min(Histogram::GetBucketUpperBound(i), max);
+        }
+      }
+      return max;
+    };
+
+    const double ns_per_tick = Clock::GetNanosecondsPerTick();
+    const auto to_ns = [ns_per_tick](const uint64_t ticks) {
+      return static_cast<uint64_t>(std::llround(ns_per_tick * static_cast<double>(ticks)));
+    };
+
+    ScopeStatistics result;
+    result.name = _name.c_str();
+    result.count = count;
+    result.total = to_ns(total);
+    result.min = (count > 0u ? to_ns(min) : 0u);
+    result.max = to_ns(max);
+    result.p50 = (recorded > 0u ? to_ns(percentile(0.5)) : 0u);
+    result.p99 = (recorded > 0u ? to_ns(percentile(0.99)) : 0u);
+    result.p999 = (recorded > 0u ? to_ns(percentile(0.999)) : 0u);
+    return result;
+  }
+
+  // ===========================================================================
+  // -- Registry ---------------------------------------------------------------
+  // ===========================================================================
+
+  Scope &GetScope(const char *name) {
+    return Registry::Get().GetScope(name);
+  }
+
+  std::vector<ScopeStatistics> GetStatistics() {
+    return Registry::Get().GetStatistics();
+  }
+
+} // namespace profiler
+} // namespace carla
@@ -6,132 +6,236 @@
 
 #pragma once
 
-// #define CARLA_WITH_PROFILER
+#include "carla/NonCopyable.h"
 
-#ifdef CARLA_WITH_PROFILER
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif // _MSC_VER
+#  define CARLA_PROFILER_WITH_TSC
+#else
+#  include <chrono>
+#endif
 
-#include <algorithm>
-#include <iomanip>
-#include <iostream>
+namespace carla {
+namespace profiler {
 
-#include "carla/Logging.h"
-#include "carla/NonCopyable.h"
-#include "carla/StopWatch.h"
+  /// Clock of the profiler. Reads the time-stamp counter of the CPU where
+  /// available, it is cheaper than the steady clock and the ticks are only
+  /// converted to nanoseconds when taking a snapshot.
+  class Clock {
+  public:
 
-namespace carla {
+    using rep = uint64_t;
+
+    static inline rep Now() {
+#ifdef CARLA_PROFILER_WITH_TSC
+      return __rdtsc();
+#else
+      return static_cast<rep>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif // CARLA_PROFILER_WITH_TSC
+    }
 
-  template <typename ... Args>
-  static inline void log_profiler(Args &&... args) {
-    logging::print(std::cout, "PROFILER:", std::forward<Args>(args)..., '\n');
-  }
+    /// Nanoseconds per tick, calibrated against the steady clock since the
+    /// start of the process.
+    static double GetNanosecondsPerTick();
+  };
 
-  class ProfilerData : private NonCopyable {
+  /// Log-linear histogram of durations, in the spirit of HdrHistogram. Each
+  /// power of two is split in 16 buckets, so every value is recorded with a
+  /// relative error below 6.25%.
+  ///
+  /// Written by a single thread and read by any, recording a value takes no
+  /// lock and no atomic read-modify-write.
+  class Histogram : private NonCopyable {
   public:
 
-    explicit ProfilerData(std::string name, bool show_fps = false)
-      : _name(std::move(name)),
-        _show_fps(show_fps) {}
-
-    ~ProfilerData() {
-      log_profiler(_name, ':', "annotated", _count, "times", std::fixed, std::setprecision(3));
-      if (_count > 0u) {
-        if (_show_fps) {
-          log_profiler(_name, ':', "average =", fps(Average()), "FPS");
-          log_profiler(_name, ':', "maximum =", fps(Minimum()), "FPS");
-          log_profiler(_name, ':', "minimum =", fps(Maximum()), "FPS");
-        } else {
-          log_profiler(_name, ':', "average =", Average(), "ms");
-          log_profiler(_name, ':', "maximum =", Maximum(), "ms");
-          log_profiler(_name, ':', "minimum =", Minimum(), "ms");
-        }
+    static constexpr size_t SubBucketBits = 4u;
+
+    static constexpr size_t SubBuckets = 1u << SubBucketBits;
+
+    static constexpr size_t NumberOfBuckets = (64u - SubBucketBits + 1u) * SubBuckets;
+
+    static inline size_t GetBucketIndex(uint64_t value) {
+      if (value < SubBuckets) {
+        return static_cast<size_t>(value);
+      }
+      const size_t shift = MostSignificantBit(value) - SubBucketBits;
+      return (shift + 1u) * SubBuckets + static_cast<size_t>((value >> shift) & (SubBuckets - 1u));
+    }
+
+    /// Highest value recorded in the bucket at @a index.
+    static uint64_t GetBucketUpperBound(size_t index);
+
+    void Record(uint64_t value) {
+      Add(_buckets[GetBucketIndex(value)], 1u);
+      Add(_count, 1u);
+      Add(_total, value);
+      if (value < _min.load(std::memory_order_relaxed)) {
+        _min.store(value, std::memory_order_relaxed);
       }
+      if (value > _max.load(std::memory_order_relaxed)) {
+        _max.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    uint64_t GetCount() const {
+      return _count.load(std::memory_order_relaxed);
     }
 
-    void Annotate(const StopWatch &stop_watch) {
-      size_t elapsed_microseconds = stop_watch.GetElapsedTime<std::chrono::microseconds>();
-      ++_count;
-      _total_microseconds += elapsed_microseconds;
-      _max_elapsed = std::max(elapsed_microseconds, _max_elapsed);
-      _min_elapsed = std::min(elapsed_microseconds, _min_elapsed);
+    uint64_t GetTotal() const {
+      return _total.load(std::memory_order_relaxed);
     }
 
-    float Average() const {
-      return ms(_total_microseconds) / static_cast<float>(_count);
+    uint64_t GetMinimum() const {
+      return _min.load(std::memory_order_relaxed);
     }
 
-    float Maximum() const {
-      return ms(_max_elapsed);
+    uint64_t GetMaximum() const {
+      return _max.load(std::memory_order_relaxed);
     }
 
-    float Minimum() const {
-      return ms(_min_elapsed);
+    uint64_t GetBucket(size_t index) const {
+      return _buckets[index].load(std::memory_order_relaxed);
     }
 
   private:
 
-    static inline float ms(size_t microseconds) {
-      return 1e-3f * static_cast<float>(microseconds);
+    static inline size_t MostSignificantBit(uint64_t value) {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanReverse64(&index, value);
+      return static_cast<size_t>(index);
+#else
+      return 63u - static_cast<size_t>(__builtin_clzll(value));
+#endif // _MSC_VER
     }
 
-    static inline float fps(float milliseconds) {
-      return 1e3f / milliseconds;
+    /// Only the owner thread writes, a plain load and store suffice.
+    static inline void Add(std::atomic<uint64_t> &counter, uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> _count{0u};
+
+    std::atomic<uint64_t> _total{0u};
+
+    std::atomic<uint64_t> _min{UINT64_MAX};
+
+    std::atomic<uint64_t> _max{0u};
+
+    std::array<std::atomic<uint64_t>, NumberOfBuckets> _buckets{};
+  };
+
+  /// Statistics of a scope merged across threads, durations in nanoseconds.
+  struct ScopeStatistics {
+    const char *name;
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+  };
+
+  /// A profiled scope, with a histogram per thread that executes it.
+  class Scope : private NonCopyable {
+  public:
+
+    explicit Scope(std::string name) : _name(std::move(name)) {}
+
+    const std::string &GetName() const {
+      return _name;
     }
 
+    /// Histogram to be written only by the calling thread. It is kept after
+    /// the thread exits.
+    Histogram &MakeThreadHistogram();
+
+    ScopeStatistics GetStatistics() const;
+
+  private:
+
     const std::string _name;
 
-    const bool _show_fps;
+    mutable std::mutex _mutex;
+
+    std::vector<std::unique_ptr<Histogram>> _histograms;
+  };
+
+  /// Scope registered with @a name, created on first use and never destroyed.
+  /// Scopes with the same name are merged.
+  Scope &GetScope(const char *name);
+
+  /// Snapshot of the statistics of every registered scope. Thread-safe.
+  std::vector<ScopeStatistics> GetStatistics();
+
+  /// Records the time spent until destruction.
+  class ScopedTimer : private NonCopyable {
+  public:
+
+    explicit ScopedTimer(Histogram &histogram)
+      : _histogram(histogram),
+        _start(Clock::Now()) {}
 
-    size_t _count = 0u;
+    ~ScopedTimer() {
+      _histogram.Record(Clock::Now() - _start);
+    }
 
-    size_t _total_microseconds = 0u;
+  private:
 
-    size_t _max_elapsed = 0u;
+    Histogram &_histogram;
 
-    size_t _min_elapsed = -1;
+    const Clock::rep _start;
   };
 
-  class ScopedProfiler {
+  /// Records the time elapsed between consecutive ticks.
+  class IntervalTimer : private NonCopyable {
   public:
 
-    explicit ScopedProfiler(ProfilerData &parent) : _profiler(parent) {}
+    explicit IntervalTimer(Histogram &histogram) : _histogram(histogram) {}
 
-    ~ScopedProfiler() {
-      _stop_watch.Stop();
-      _profiler.Annotate(_stop_watch);
+    void Tick() {
+      const auto now = Clock::Now();
+      if (_last != 0u) {
+        _histogram.Record(now - _last);
+      }
+      _last = now;
     }
 
   private:
 
-    ProfilerData &_profiler;
+    Histogram &_histogram;
 
-    StopWatch _stop_watch;
+    Clock::rep _last = 0u;
   };
 
+} // namespace profiler
 } // namespace carla
 
+/// Profile the time spent in the current scope, registered as
+/// "context.name". See carla_profiler_snapshot.
 #define CARLA_PROFILE_SCOPE(context, name) \
-    static thread_local ::carla::ProfilerData carla_profiler_ ## context ## _ ## name ## _data( \
-        #context "." #name); \
-    ::carla::ScopedProfiler carla_profiler_ ## context ## _ ## name ## _scoped_profiler( \
-        carla_profiler_ ## context ## _ ## name ## _data);
+    static thread_local ::carla::profiler::Histogram &carla_profiler_ ## context ## _ ## name ## _histogram = \
+        ::carla::profiler::GetScope(#context "." #name).MakeThreadHistogram(); \
+    ::carla::profiler::ScopedTimer carla_profiler_ ## context ## _ ## name ## _timer( \
+        carla_profiler_ ## context ## _ ## name ## _histogram);
 
+/// Profile the time elapsed between consecutive calls, i.e. the frame time.
 #define CARLA_PROFILE_FPS(context, name) \
     { \
-      static thread_local ::carla::StopWatch stop_watch; \
-      stop_watch.Stop(); \
-      static thread_local bool first_time = true; \
-      if (!first_time) { \
-        static thread_local ::carla::ProfilerData profiler_data(#context "." #name, true); \
-        profiler_data.Annotate(stop_watch); \
-      } else { \
-        first_time = false; \
-      } \
-      stop_watch.Restart(); \
+      static thread_local ::carla::profiler::IntervalTimer carla_profiler_interval_timer( \
+          ::carla::profiler::GetScope(#context "." #name).MakeThreadHistogram()); \
+      carla_profiler_interval_timer.Tick(); \
     }
-
-#else // CARLA_WITH_PROFILER
-
-#define CARLA_PROFILE_SCOPE(context, name)
-#define CARLA_PROFILE_FPS(context, name)
-
-#endif // CARLA_WITH_PROFILER
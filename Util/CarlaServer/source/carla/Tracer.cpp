@@ -0,0 +1,215 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace tracer {
+
+namespace detail {
+
+  std::atomic_bool ENABLED{false};
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    struct Event {
+      const char *name;
+      Clock::rep begin;
+      Clock::rep end;
+      uint32_t thread_id;
+    };
+
+    /// Ring of the events of one thread. Written by a single thread and read
+    /// by any, the readers discard the events overwritten while reading.
+    class EventBuffer : private NonCopyable {
+    public:
+
+      void Push(const Event &event) {
+        const auto head = _head.load(std::memory_order_relaxed);
+        auto &slot = _events[head % EventsPerThread];
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.begin.store(event.begin, std::memory_order_relaxed);
+        slot.end.store(event.end, std::memory_order_relaxed);
+        slot.thread_id.store(event.thread_id, std::memory_order_relaxed);
+        _head.store(head + 1u, std::memory_order_release);
+      }
+
+      void CopyTo(std::vector<Event> &events) const {
+        const auto head = _head.load(std::memory_order_acquire);
+        const auto first = (head > EventsPerThread ? head - EventsPerThread : 0u);
+        const auto size = events.size();
+        for (auto i = first; i < head; ++i) {
+          auto &slot = _events[i % EventsPerThread];
+          events.push_back({
+              slot.name.load(std::memory_order_relaxed),
+              slot.begin.load(std::memory_order_relaxed),
+              slot.end.load(std::memory_order_relaxed),
+              slot.thread_id.load(std::memory_order_relaxed)});
+        }
+        // Drop the events that the writer may have overwritten meanwhile.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto new_head = _head.load(std::memory_order_relaxed);
+        const auto overwritten = std::min(
+            head - first,
+            (new_head >= first + EventsPerThread ? new_head - first - EventsPerThread + 1u : 0u));
+        events.erase(events.begin() + size, events.begin() + size + overwritten);
+      }
+
+    private:
+
+      struct Slot {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<Clock::rep> begin{0u};
+        std::atomic<Clock::rep> end{0u};
+        std::atomic<uint32_t> thread_id{0u};
+      };
+
+      std::atomic<uint64_t> _head{0u};
+
+      std::array<Slot, EventsPerThread> _events;
+    };
+
+    /// Buffers of every thread, leaked so they outlive the static objects
+    /// that may still trace during destruction.
+    class Registry {
+    public:
+
+      static Registry &Get() {
+        static Registry *registry = new Registry;
+        return *registry;
+      }
+
+      EventBuffer *Acquire() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free_buffers.empty()) {
+          auto *buffer = _free_buffers.back();
+          _free_buffers.pop_back();
+          return buffer;
+        }
+        _buffers.emplace_back(std::make_unique<EventBuffer>());
+        return _buffers.back().get();
+      }
+
+      /// The events of @a buffer are kept until it is reused.
+      void Release(EventBuffer *buffer) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free_buffers.push_back(buffer);
+      }
+
+      std::vector<Event> GetEvents() {
+        std::vector<Event> events;
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto &buffer : _buffers) {
+          buffer->CopyTo(events);
+        }
+        return events;
+      }
+
+      size_t GetMemoryUsage() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _buffers.size() * sizeof(EventBuffer);
+      }
+
+    private:
+
+      std::mutex _mutex;
+
+      std::vector<std::unique_ptr<EventBuffer>> _buffers;
+
+      std::vector<EventBuffer *> _free_buffers;
+    };
+
+    /// The buffer is only acquired on the first event of the thread.
+    class ThreadState : private NonCopyable {
+    public:
+
+      ThreadState() : _id(NEXT_ID++) {}
+
+      ~ThreadState() {
+        if (_buffer != nullptr) {
+          Registry::Get().Release(_buffer);
+        }
+      }
+
+      void Push(const char *name, Clock::rep begin, Clock::rep end) {
+        if (_buffer == nullptr) {
+          _buffer = Registry::Get().Acquire();
+        }
+        _buffer->Push({name, begin, end, _id});
+      }
+
+    private:
+
+      static std::atomic<uint32_t> NEXT_ID;
+
+      const uint32_t _id;
+
+      EventBuffer *_buffer = nullptr;
+    };
+
+    std::atomic<uint32_t> ThreadState::NEXT_ID{1u};
+
+    thread_local ThreadState THREAD_STATE;
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Tracer -----------------------------------------------------------------
+  // ===========================================================================
+
+  void SetEnabled(const bool enabled) {
+    detail::ENABLED = enabled;
+  }
+
+  void RecordEvent(const char *name, const Clock::rep begin, const Clock::rep end) {
+    THREAD_STATE.Push(name, begin, end);
+  }
+
+  void Dump(std::ostream &out) {
+    const auto events = Registry::Get().GetEvents();
+    const double us_per_tick = 1e-3 * Clock::GetNanosecondsPerTick();
+    Clock::rep origin = 0u;
+    if (!events.empty()) {
+      origin = std::min_element(events.begin(), events.end(), [](const Event &lhs, const Event &rhs) {
+        return lhs.begin < rhs.begin;
+      })->begin;
+    }
+    const auto to_us = [us_per_tick](const Clock::rep ticks) {
+      return us_per_tick * static_cast<double>(ticks);
+    };
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    out << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (auto &event : events) {
+      out << (first ? "\n" : ",\n");
+      first = false;
+      out << "{\"name\":\"" << event.name
+          << "\",\"cat\":\"carla\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread_id
+          << ",\"ts\":" << to_us(event.begin - origin)
+          << ",\"dur\":" << to_us(event.end - event.begin) << '}';
+    }
+    out << "\n]}\n";
+  }
+
+  size_t GetMemoryUsage() {
+    return Registry::Get().GetMemoryUsage();
+  }
+
+} // namespace tracer
+} // namespace carla
@@ -0,0 +1,77 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Profiler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace carla {
+namespace tracer {
+
+  using Clock = profiler::Clock;
+
+  /// Number of events kept per thread, the oldest are overwritten. The
+  /// buffers of the threads that exit are reused by the new ones, so the
+  /// memory is bounded by the number of threads alive at the same time.
+  static constexpr size_t EventsPerThread = 8192u;
+
+namespace detail {
+
+  extern std::atomic_bool ENABLED;
+
+} // namespace detail
+
+  /// Tracing is disabled by default.
+  static inline bool IsEnabled() {
+    return detail::ENABLED.load(std::memory_order_relaxed);
+  }
+
+  void SetEnabled(bool enabled);
+
+  /// Record an event of the calling thread that lasted from @a begin to
+  /// @a end. @a name must be statically allocated.
+  void RecordEvent(const char *name, Clock::rep begin, Clock::rep end);
+
+  /// Write the recorded events in the Chrome trace event format (JSON), it
+  /// can be opened with chrome://tracing or Perfetto.
+  void Dump(std::ostream &out);
+
+  /// Bytes allocated for the events of every thread.
+  size_t GetMemoryUsage();
+
+  /// Records the time spent until destruction, if tracing is enabled.
+  class ScopedEvent : private NonCopyable {
+  public:
+
+    explicit ScopedEvent(const char *name)
+      : _name(name),
+        _begin(IsEnabled() ? Clock::Now() : 0u) {}
+
+    ~ScopedEvent() {
+      if (_begin != 0u) {
+        RecordEvent(_name, _begin, Clock::Now());
+      }
+    }
+
+  private:
+
+    const char *_name;
+
+    const Clock::rep _begin;
+  };
+
+} // namespace tracer
+} // namespace carla
+
+/// Trace the current scope as the event "context.name". See
+/// carla_tracer_dump.
+#define CARLA_TRACE_SCOPE(context, name) \
+    ::carla::tracer::ScopedEvent carla_tracer_ ## context ## _ ## name ## _event(#context "." #name);
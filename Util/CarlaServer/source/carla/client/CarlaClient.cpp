@@ -0,0 +1,302 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/CarlaClient.h"
+
+#include <atomic>
+#include <cstring>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif // __linux__
+
+namespace cs = carla_server;
+
+namespace carla {
+namespace client {
+
+  /// Set on the id of a sensor message whose data is in the shared memory
+  /// region, see server::SensorDataMessage.
+  static constexpr uint32_t SHARED_MEMORY_FLAG = 1u << 31;
+
+  /// Bytes before and after the payload of a slot of the shared memory
+  /// region, see server::SharedMemoryRing.
+  static constexpr uint64_t SLOT_PREFIX_SIZE = 16u;
+
+  static constexpr uint64_t SLOT_SUFFIX_SIZE = 8u;
+
+  static constexpr size_t CAMERA_HEADER_SIZE = 24u;
+
+  static constexpr size_t LIDAR_HEADER_SIZE = 16u;
+
+  static uint32_t ReadUInt32(const unsigned char *data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  static uint64_t ReadUInt64(const unsigned char *data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  /// Size of the sensor specific header at the beginning of @a data.
+  static size_t GetHeaderSize(cs::Sensor::Type type, const_array_view<unsigned char> data) {
+    switch (type) {
+      case cs::Sensor::CAMERA:
+        return CAMERA_HEADER_SIZE;
+      case cs::Sensor::LIDAR_RAY_CAST:
+        // The header is followed by the number of points of each channel.
+        if (data.size() < LIDAR_HEADER_SIZE) {
+          return LIDAR_HEADER_SIZE;
+        }
+        return LIDAR_HEADER_SIZE + sizeof(uint32_t) * ReadUInt32(data.data() + 12u);
+      default:
+        return 0u;
+    }
+  }
+
+  // ===========================================================================
+  // -- CarlaClient ------------------------------------------------------------
+  // ===========================================================================
+
+  CarlaClient::~CarlaClient() {
+    Disconnect();
+  }
+
+  error_code CarlaClient::Connect(
+      const std::string &host,
+      const uint32_t world_port,
+      const time_duration timeout) {
+    Disconnect();
+    _host = host;
+    _world_port = world_port;
+    _timeout = timeout;
+    return _world.Connect(_host, _world_port, _timeout);
+  }
+
+  void CarlaClient::Disconnect() {
+    _control.Disconnect();
+    _stream.Disconnect();
+    _world.Disconnect();
+    _sensor_data.clear();
+    UnmapSharedMemory();
+  }
+
+  error_code CarlaClient::LoadSettings(const std::string &ini_file) {
+    // The server closes the agent connections on a new episode.
+    _control.Disconnect();
+    _stream.Disconnect();
+    _sensor_data.clear();
+    // The server creates a new shared memory region every episode.
+    UnmapSharedMemory();
+    cs::RequestNewEpisode request;
+    request.set_ini_file(ini_file);
+    auto ec = Write(_world, request);
+    if (!ec) {
+      ec = Read(_world, _scene);
+    }
+    return ec;
+  }
+
+  error_code CarlaClient::StartEpisode(const uint32_t player_start_index) {
+    cs::EpisodeStart start;
+    start.set_player_start_spot_index(player_start_index);
+    auto ec = Write(_world, start);
+    if (ec) {
+      return ec;
+    }
+    cs::EpisodeReady ready;
+    ec = Read(_world, ready);
+    if (ec) {
+      return ec;
+    }
+    if (!ready.ready()) {
+      return boost::asio::error::operation_aborted;
+    }
+    ec = _stream.Connect(_host, _world_port + 1u, _timeout);
+    if (!ec) {
+      ec = _control.Connect(_host, _world_port + 2u, _timeout);
+    }
+    return ec;
+  }
+
+  error_code CarlaClient::ReadData() {
+    _sensor_data.clear();
+    _stream.ClearMessages();
+    // Read the whole frame first, the receive buffer may grow meanwhile.
+    Connection::Message measurements;
+    auto ec = _stream.Read(measurements, _timeout);
+    if (ec) {
+      return ec;
+    }
+    _messages.clear();
+    for (;;) {
+      Connection::Message message;
+      ec = _stream.Read(message, _timeout);
+      if (ec) {
+        return ec;
+      }
+      if (message.size == 0u) {
+        break;
+      }
+      _messages.push_back(message);
+    }
+    // Decode.
+    auto view = _stream.GetView(measurements);
+    if (!_measurements.ParseFromArray(view.data(), static_cast<int>(view.size()))) {
+      return boost::system::errc::make_error_code(boost::system::errc::illegal_byte_sequence);
+    }
+    for (auto &message : _messages) {
+      SensorData data;
+      ec = MakeSensorData(_stream.GetView(message), data);
+      if (ec) {
+        return ec;
+      }
+      _sensor_data.push_back(data);
+    }
+    return ec;
+  }
+
+  error_code CarlaClient::SendControl(const cs::Control &control) {
+    return Write(_control, control);
+  }
+
+  error_code CarlaClient::Write(Connection &connection, const google::protobuf::Message &message) {
+    if (!connection.IsConnected()) {
+      return boost::asio::error::not_connected;
+    }
+    message.SerializeToString(&_encoded);
+    return connection.Write(
+        array_view::make_const(reinterpret_cast<const unsigned char *>(_encoded.data()), _encoded.size()),
+        _timeout);
+  }
+
+  error_code CarlaClient::Read(Connection &connection, google::protobuf::Message &message) {
+    if (!connection.IsConnected()) {
+      return boost::asio::error::not_connected;
+    }
+    connection.ClearMessages();
+    Connection::Message location;
+    auto ec = connection.Read(location, _timeout);
+    if (!ec) {
+      auto view = connection.GetView(location);
+      if (!message.ParseFromArray(view.data(), static_cast<int>(view.size()))) {
+        ec = boost::system::errc::make_error_code(boost::system::errc::illegal_byte_sequence);
+      }
+    }
+    return ec;
+  }
+
+  error_code CarlaClient::MakeSensorData(
+      const const_array_view<unsigned char> message,
+      SensorData &data) {
+    const auto illegal_byte_sequence =
+        boost::system::errc::make_error_code(boost::system::errc::illegal_byte_sequence);
+    if (message.size() < sizeof(uint32_t)) {
+      return illegal_byte_sequence;
+    }
+    data.id = ReadUInt32(message.data());
+    const unsigned char *begin = message.data() + sizeof(uint32_t);
+    size_t size = message.size() - sizeof(uint32_t);
+    if (data.id & SHARED_MEMORY_FLAG) {
+      // The message only contains the location of the data in the region.
+      data.id &= ~SHARED_MEMORY_FLAG;
+      if (size != sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t)) {
+        return illegal_byte_sequence;
+      }
+      const uint64_t offset = ReadUInt64(begin);
+      size = ReadUInt32(begin + sizeof(uint64_t));
+      const uint64_t sequence = ReadUInt64(begin + sizeof(uint64_t) + sizeof(uint32_t));
+      auto ec = MapSharedMemory();
+      if (ec) {
+        return ec;
+      }
+      const uint64_t slot_size = SLOT_PREFIX_SIZE + size + SLOT_SUFFIX_SIZE;
+      if ((offset > _shared_memory_size) || (slot_size > _shared_memory_size - offset)) {
+        return illegal_byte_sequence;
+      }
+      // The slot keeps its sequence before and after the payload, if either
+      // changed the client lagged behind and the slot was reused.
+      const auto slot = _shared_memory + offset;
+      const uint64_t after = ReadUInt64(slot + SLOT_PREFIX_SIZE + size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((ReadUInt64(slot) != sequence) || (after != sequence)) {
+        return boost::asio::error::no_buffer_space;
+      }
+      begin = slot + SLOT_PREFIX_SIZE;
+    }
+    data.type = cs::Sensor::UNKNOWN;
+    for (auto &sensor : _scene.sensors()) {
+      if (sensor.id() == data.id) {
+        data.type = sensor.type();
+        break;
+      }
+    }
+    const auto all = array_view::make_const(begin, size);
+    const size_t header_size = GetHeaderSize(data.type, all);
+    if (header_size > size) {
+      return illegal_byte_sequence;
+    }
+    data.header = array_view::make_const(begin, header_size);
+    data.data = array_view::make_const(begin + header_size, size - header_size);
+    return error_code();
+  }
+
+#ifdef __linux__
+
+  error_code CarlaClient::MapSharedMemory() {
+    if (_shared_memory != nullptr) {
+      return error_code();
+    }
+    const auto name = "/carla-server-" + std::to_string(_world_port + 1u);
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return error_code(errno, boost::system::system_category());
+    }
+    error_code ec;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      ec = error_code(errno, boost::system::system_category());
+    } else {
+      const uint64_t size = static_cast<uint64_t>(info.st_size);
+      void *ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        ec = error_code(errno, boost::system::system_category());
+      } else {
+        _shared_memory = static_cast<const unsigned char *>(ptr);
+        _shared_memory_size = size;
+      }
+    }
+    // The mapping stays valid after closing the descriptor.
+    close(fd);
+    return ec;
+  }
+
+  void CarlaClient::UnmapSharedMemory() {
+    if (_shared_memory != nullptr) {
+      munmap(const_cast<unsigned char *>(_shared_memory), _shared_memory_size);
+      _shared_memory = nullptr;
+      _shared_memory_size = 0u;
+    }
+  }
+
+#else
+
+  error_code CarlaClient::MapSharedMemory() {
+    return boost::asio::error::operation_not_supported;
+  }
+
+  void CarlaClient::UnmapSharedMemory() {}
+
+#endif // __linux__
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,116 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ArrayView.h"
+#include "carla/NonCopyable.h"
+#include "carla/client/Connection.h"
+
+#include "carla/server/carla_server.pb.h"
+
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  /// Data of a sensor received this frame. The views point into the receive
+  /// buffer of the client or into the shared memory region of the server.
+  struct SensorData {
+    uint32_t id;
+    carla_server::Sensor::Type type;
+    /// Sensor specific header, e.g. frame number, width, height, type and
+    /// field of view of a camera image.
+    const_array_view<unsigned char> header{nullptr, 0u};
+    const_array_view<unsigned char> data{nullptr, 0u};
+  };
+
+  /// Native counterpart of the Python CarlaClient. Messages are decoded into
+  /// protobuf messages owned by the client, and sensor data is never copied.
+  ///
+  /// Every call blocks until the operation completes or the time-out given on
+  /// connection expires.
+  class CarlaClient : private NonCopyable {
+  public:
+
+    CarlaClient() = default;
+
+    ~CarlaClient();
+
+    error_code Connect(const std::string &host, uint32_t world_port, time_duration timeout);
+
+    void Disconnect();
+
+    /// Request a new episode with the contents of a CarlaSettings.ini file,
+    /// and wait for the scene description.
+    error_code LoadSettings(const std::string &ini_file);
+
+    const carla_server::SceneDescription &GetSceneDescription() const {
+      return _scene;
+    }
+
+    /// Start the episode at the given player start and wait until the server
+    /// is ready. Returns operation_aborted if the server failed to start it.
+    error_code StartEpisode(uint32_t player_start_index);
+
+    /// Read the measurements and the sensor data of the next frame. Data
+    /// returned by the previous call is invalidated.
+    error_code ReadData();
+
+    const carla_server::Measurements &GetMeasurements() const {
+      return _measurements;
+    }
+
+    const std::vector<SensorData> &GetSensorData() const {
+      return _sensor_data;
+    }
+
+    error_code SendControl(const carla_server::Control &control);
+
+  private:
+
+    error_code Write(Connection &connection, const google::protobuf::Message &message);
+
+    error_code Read(Connection &connection, google::protobuf::Message &message);
+
+    /// Locate the data of the sensor message @a message, either inline or in
+    /// the shared memory region.
+    error_code MakeSensorData(const_array_view<unsigned char> message, SensorData &data);
+
+    error_code MapSharedMemory();
+
+    void UnmapSharedMemory();
+
+    std::string _host;
+
+    uint32_t _world_port = 0u;
+
+    time_duration _timeout;
+
+    Connection _world;
+
+    Connection _stream;
+
+    Connection _control;
+
+    carla_server::SceneDescription _scene;
+
+    carla_server::Measurements _measurements;
+
+    std::vector<Connection::Message> _messages;
+
+    std::vector<SensorData> _sensor_data;
+
+    std::string _encoded;
+
+    const unsigned char *_shared_memory = nullptr;
+
+    uint64_t _shared_memory_size = 0u;
+  };
+
+} // namespace client
+} // namespace carla
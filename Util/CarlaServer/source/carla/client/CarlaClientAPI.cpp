@@ -0,0 +1,320 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/CarlaClientAPI.h"
+
+#include "carla/client/CarlaClient.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace cs = carla_server;
+
+using namespace carla;
+using namespace carla::client;
+
+// =============================================================================
+// -- Client and its C-compatible data -----------------------------------------
+// =============================================================================
+
+namespace {
+
+  /// Holds the C structs pointing to the data decoded by the client, they are
+  /// reused between calls to avoid allocations.
+  struct CarlaClientC {
+    CarlaClient client;
+    std::vector<carla_transform> start_spots;
+    std::vector<carla_sensor_definition> sensors;
+    std::vector<carla_agent> agents;
+    std::vector<carla_sensor_data> sensor_data;
+    /// Heap allocated, it is too big for the stack (see carla_control).
+    std::unique_ptr<carla_measurements> measurements = std::make_unique<carla_measurements>();
+    carla_telemetry telemetry;
+    cs::Control control;
+  };
+
+} // namespace
+
+// =============================================================================
+// -- Static local functions ---------------------------------------------------
+// =============================================================================
+
+static inline CarlaClientC *Cast(CarlaClientPtr self) {
+  return static_cast<CarlaClientC*>(self);
+}
+
+static void Set(carla_vector3d &lhs, const cs::Vector3D &rhs) {
+  lhs = {rhs.x(), rhs.y(), rhs.z()};
+}
+
+static void Set(carla_rotation3d &lhs, const cs::Rotation3D &rhs) {
+  lhs = {rhs.pitch(), rhs.yaw(), rhs.roll()};
+}
+
+static void Set(carla_transform &lhs, const cs::Transform &rhs) {
+  Set(lhs.location, rhs.location());
+  Set(lhs.orientation, rhs.orientation());
+  Set(lhs.rotation, rhs.rotation());
+}
+
+static void Set(carla_bounding_box &lhs, const cs::BoundingBox &rhs) {
+  Set(lhs.transform, rhs.transform());
+  Set(lhs.extent, rhs.extent());
+}
+
+static void Set(carla_sensor_definition &lhs, const cs::Sensor &rhs) {
+  lhs.id = rhs.id();
+  lhs.name = rhs.name().c_str();
+  switch (rhs.type()) {
+    case cs::Sensor::CAMERA:         lhs.type = CARLA_SERVER_CAMERA;         break;
+    case cs::Sensor::LIDAR_RAY_CAST: lhs.type = CARLA_SERVER_LIDAR_RAY_CAST; break;
+    default:                         lhs.type = CARLA_SERVER_SENSOR_UNKNOWN; break;
+  }
+}
+
+/// Only the vehicle control, autopilot controls have no agent controls.
+static void Set(carla_control &lhs, const cs::Control &rhs) {
+  lhs.steer = rhs.steer();
+  lhs.throttle = rhs.throttle();
+  lhs.brake = rhs.brake();
+  lhs.hand_brake = rhs.hand_brake();
+  lhs.reverse = rhs.reverse();
+  lhs.number_of_agent_controls = 0u;
+  lhs.repeat_frames = rhs.repeat_frames();
+}
+
+static void Set(carla_agent &lhs, const cs::Agent &rhs) {
+  lhs = {};
+  lhs.id = rhs.id();
+  switch (rhs.agent_case()) {
+    case cs::Agent::kVehicle:
+      lhs.type = CARLA_SERVER_AGENT_VEHICLE;
+      Set(lhs.transform, rhs.vehicle().transform());
+      Set(lhs.bounding_box, rhs.vehicle().bounding_box());
+      lhs.forward_speed = rhs.vehicle().forward_speed();
+      break;
+    case cs::Agent::kPedestrian:
+      lhs.type = CARLA_SERVER_AGENT_PEDESTRIAN;
+      Set(lhs.transform, rhs.pedestrian().transform());
+      Set(lhs.bounding_box, rhs.pedestrian().bounding_box());
+      lhs.forward_speed = rhs.pedestrian().forward_speed();
+      break;
+    case cs::Agent::kSpeedLimitSign:
+      lhs.type = CARLA_SERVER_AGENT_SPEEDLIMITSIGN;
+      Set(lhs.transform, rhs.speed_limit_sign().transform());
+      lhs.forward_speed = rhs.speed_limit_sign().speed_limit();
+      break;
+    case cs::Agent::kTrafficLight:
+      switch (rhs.traffic_light().state()) {
+        case cs::TrafficLight::GREEN:  lhs.type = CARLA_SERVER_AGENT_TRAFFICLIGHT_GREEN;  break;
+        case cs::TrafficLight::YELLOW: lhs.type = CARLA_SERVER_AGENT_TRAFFICLIGHT_YELLOW; break;
+        default:                       lhs.type = CARLA_SERVER_AGENT_TRAFFICLIGHT_RED;    break;
+      }
+      Set(lhs.transform, rhs.traffic_light().transform());
+      break;
+    default:
+      lhs.type = CARLA_SERVER_AGENT_UNKNOWN;
+  }
+}
+
+static void Set(cs::Vector3D *lhs, const carla_vector3d &rhs) {
+  lhs->set_x(rhs.x);
+  lhs->set_y(rhs.y);
+  lhs->set_z(rhs.z);
+}
+
+static void Set(cs::AgentControl *lhs, const carla_agent_control &rhs) {
+  lhs->set_id(rhs.id);
+  const auto &walker = rhs.walker_control;
+  // The server applies the walker control if present, send it only if it
+  // does something.
+  if ((walker.number_of_waypoints > 0u) || walker.reset) {
+    auto *message = lhs->mutable_walker_control();
+    const auto count = std::min(walker.number_of_waypoints, static_cast<uint32_t>(MAX_AGENT_CONTROL_WAYPOINTS));
+    for (auto i = 0u; i < count; ++i) {
+      Set(message->add_waypoints(), walker.waypoints[i]);
+      message->add_waypoint_times(walker.waypoint_times[i]);
+    }
+    message->set_reset(walker.reset);
+  } else {
+    const auto &vehicle = rhs.vehicle_control;
+    auto *message = lhs->mutable_vehicle_control();
+    message->set_steer(vehicle.steer);
+    message->set_throttle(vehicle.throttle);
+    message->set_brake(vehicle.brake);
+    message->set_hand_brake(vehicle.hand_brake);
+    message->set_reverse(vehicle.reverse);
+    message->set_teleport(vehicle.teleport);
+    if (vehicle.teleport) {
+      auto *transform = message->mutable_teleport_params();
+      Set(transform->mutable_location(), vehicle.teleport_params.location);
+      transform->mutable_rotation()->set_yaw(vehicle.teleport_params.rotation.yaw);
+    }
+  }
+}
+
+static void Set(cs::Control &lhs, const carla_control &rhs) {
+  lhs.set_steer(rhs.steer);
+  lhs.set_throttle(rhs.throttle);
+  lhs.set_brake(rhs.brake);
+  lhs.set_hand_brake(rhs.hand_brake);
+  lhs.set_reverse(rhs.reverse);
+  lhs.set_repeat_frames(rhs.repeat_frames);
+  lhs.clear_agent_controls(); // we need to clear as we reuse the message.
+  const auto count = std::min(rhs.number_of_agent_controls, static_cast<uint32_t>(MAX_CONTROL_AGENTS));
+  for (auto i = 0u; i < count; ++i) {
+    Set(lhs.add_agent_controls(), rhs.agent_controls[i]);
+  }
+}
+
+// =============================================================================
+// -- Implementation of the C-interface of CarlaClient -------------------------
+// =============================================================================
+
+const int32_t CARLA_CLIENT_SUCCESS = boost::system::errc::success;
+const int32_t CARLA_CLIENT_TIMED_OUT = boost::asio::error::timed_out;
+const int32_t CARLA_CLIENT_OPERATION_ABORTED = boost::asio::error::operation_aborted;
+
+CarlaClientPtr carla_make_client() {
+  return new CarlaClientC;
+}
+
+void carla_free_client(CarlaClientPtr self) {
+  delete Cast(self);
+}
+
+int32_t carla_client_connect(
+    CarlaClientPtr self,
+    const char *host,
+    const uint32_t world_port,
+    const uint32_t timeout_milliseconds) {
+  return Cast(self)->client.Connect(
+      (host != nullptr ? host : ""),
+      world_port,
+      boost::posix_time::milliseconds(timeout_milliseconds)).value();
+}
+
+void carla_client_disconnect(CarlaClientPtr self) {
+  Cast(self)->client.Disconnect();
+}
+
+int32_t carla_client_load_settings(
+    CarlaClientPtr self,
+    const char *ini_file,
+    carla_scene_description *scene) {
+  auto &c = *Cast(self);
+  auto ec = c.client.LoadSettings(ini_file != nullptr ? ini_file : "");
+  if (ec) {
+    return ec.value();
+  }
+  const auto &message = c.client.GetSceneDescription();
+  c.start_spots.resize(message.player_start_spots_size());
+  for (auto i = 0u; i < c.start_spots.size(); ++i) {
+    Set(c.start_spots[i], message.player_start_spots(i));
+  }
+  c.sensors.resize(message.sensors_size());
+  for (auto i = 0u; i < c.sensors.size(); ++i) {
+    Set(c.sensors[i], message.sensors(i));
+  }
+  if (scene != nullptr) {
+    scene->map_name = message.map_name().c_str();
+    scene->player_start_spots = c.start_spots.data();
+    scene->number_of_player_start_spots = static_cast<uint32_t>(c.start_spots.size());
+    scene->sensors = c.sensors.data();
+    scene->number_of_sensors = static_cast<uint32_t>(c.sensors.size());
+  }
+  return CARLA_CLIENT_SUCCESS;
+}
+
+int32_t carla_client_start_episode(
+    CarlaClientPtr self,
+    const uint32_t player_start_index) {
+  return Cast(self)->client.StartEpisode(player_start_index).value();
+}
+
+int32_t carla_client_read_data(
+    CarlaClientPtr self,
+    const carla_measurements **measurements,
+    const carla_sensor_data **sensor_data,
+    uint32_t *number_of_sensor_data) {
+  auto &c = *Cast(self);
+  auto ec = c.client.ReadData();
+  if (ec) {
+    return ec.value();
+  }
+  // Measurements.
+  const auto &message = c.client.GetMeasurements();
+  auto &values = *c.measurements;
+  values.frame_number = static_cast<uint32_t>(message.frame_number());
+  values.platform_timestamp = message.platform_timestamp();
+  values.game_timestamp = message.game_timestamp();
+  const auto &player = message.player_measurements();
+  Set(values.player_measurements.transform, player.transform());
+  Set(values.player_measurements.bounding_box, player.bounding_box());
+  Set(values.player_measurements.acceleration, player.acceleration());
+  values.player_measurements.forward_speed = player.forward_speed();
+  values.player_measurements.collision_vehicles = player.collision_vehicles();
+  values.player_measurements.collision_pedestrians = player.collision_pedestrians();
+  values.player_measurements.collision_other = player.collision_other();
+  values.player_measurements.intersection_otherlane = player.intersection_otherlane();
+  values.player_measurements.intersection_offroad = player.intersection_offroad();
+  Set(values.player_measurements.autopilot_control, player.autopilot_control());
+  // Non-player agents.
+  c.agents.resize(message.non_player_agents_size());
+  for (auto i = 0u; i < c.agents.size(); ++i) {
+    Set(c.agents[i], message.non_player_agents(i));
+  }
+  values.non_player_agents = c.agents.data();
+  values.number_of_non_player_agents = static_cast<uint32_t>(c.agents.size());
+  // Telemetry.
+  values.telemetry = nullptr;
+  if (message.has_telemetry()) {
+    const auto &telemetry = message.telemetry();
+    c.telemetry.game_thread_time = telemetry.game_thread_time();
+    c.telemetry.sensor_readback_time = telemetry.sensor_readback_time();
+    c.telemetry.read_control_time = telemetry.read_control_time();
+    c.telemetry.encode_time = telemetry.encode_time();
+    c.telemetry.bytes_sent = telemetry.bytes_sent();
+    c.telemetry.walkers_pending_spawn = telemetry.walkers_pending_spawn();
+    c.telemetry.walkers_spawned = telemetry.walkers_spawned();
+    c.telemetry.walkers_checked = telemetry.walkers_checked();
+    c.telemetry.walkers_pooled = telemetry.walkers_pooled();
+    values.telemetry = &c.telemetry;
+  }
+  // Sensor data, pointing into the buffers of the client.
+  const auto &data = c.client.GetSensorData();
+  c.sensor_data.resize(data.size());
+  for (auto i = 0u; i < data.size(); ++i) {
+    c.sensor_data[i] = {
+      data[i].id,
+      data[i].header.data(),
+      static_cast<uint32_t>(data[i].header.size()),
+      data[i].data.data(),
+      static_cast<uint32_t>(data[i].data.size())};
+  }
+  if (measurements != nullptr) {
+    *measurements = &values;
+  }
+  if (sensor_data != nullptr) {
+    *sensor_data = c.sensor_data.data();
+  }
+  if (number_of_sensor_data != nullptr) {
+    *number_of_sensor_data = static_cast<uint32_t>(c.sensor_data.size());
+  }
+  return CARLA_CLIENT_SUCCESS;
+}
+
+int32_t carla_client_send_control(
+    CarlaClientPtr self,
+    const carla_control *control) {
+  auto &c = *Cast(self);
+  if (control == nullptr) {
+    return boost::asio::error::invalid_argument;
+  }
+  Set(c.control, *control);
+  return c.client.SendControl(c.control).value();
+}
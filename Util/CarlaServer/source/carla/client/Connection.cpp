@@ -0,0 +1,209 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/Connection.h"
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace boost::asio::ip;
+
+namespace carla {
+namespace client {
+
+  static const std::string UNIX_SCHEME = "unix://";
+
+  // ===========================================================================
+  // -- Connection -------------------------------------------------------------
+  // ===========================================================================
+
+  Connection::Connection()
+    : _service(),
+      _socket(_service),
+      _timer(_service) {}
+
+  Connection::~Connection() {
+    Disconnect();
+  }
+
+  error_code Connection::Connect(
+      const std::string &host,
+      const uint32_t port,
+      const time_duration timeout) {
+    Disconnect();
+    _size = 0u;
+    _read = 0u;
+
+    // Resolve the endpoint.
+    protocol_type::endpoint endpoint;
+    if (host.compare(0u, UNIX_SCHEME.size(), UNIX_SCHEME) == 0) {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+      endpoint = boost::asio::local::stream_protocol::endpoint(
+          host.substr(UNIX_SCHEME.size()) + '-' + std::to_string(port));
+#else
+      return boost::asio::error::operation_not_supported;
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+    } else {
+      error_code ec;
+      tcp::resolver resolver(_service);
+      auto it = resolver.resolve(tcp::resolver::query(tcp::v4(), host, std::to_string(port)), ec);
+      if (ec) {
+        return ec;
+      }
+      endpoint = it->endpoint();
+    }
+
+    // Retry while the server is not listening yet.
+    const auto deadline =
+        boost::posix_time::microsec_clock::universal_time() + timeout;
+    for (;;) {
+      const auto remaining = deadline - boost::posix_time::microsec_clock::universal_time();
+      auto ec = RunWithTimeout(remaining, [&](auto &&handler) {
+        _socket.async_connect(endpoint, handler);
+      });
+      if (!ec) {
+        if (endpoint.protocol().family() != AF_UNIX) {
+          _socket.set_option(tcp::no_delay(true), ec);
+        }
+        // Reads and writes are tried first without the io_service.
+        _socket.non_blocking(true, ec);
+        return ec;
+      }
+      _socket.close();
+      // A Unix socket does not exist until the server listens.
+      if ((ec != boost::asio::error::connection_refused) &&
+          (ec != boost::system::errc::no_such_file_or_directory)) {
+        return ec;
+      }
+      if (boost::posix_time::microsec_clock::universal_time() >= deadline) {
+        return boost::asio::error::timed_out;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  void Connection::Disconnect() {
+    if (_socket.is_open()) {
+      error_code ec;
+      _socket.shutdown(boost::asio::socket_base::shutdown_both, ec);
+      _socket.close(ec);
+    }
+  }
+
+  error_code Connection::Write(
+      const const_array_view<unsigned char> message,
+      const time_duration timeout) {
+    const uint32_t size = static_cast<uint32_t>(message.size());
+    std::array<boost::asio::const_buffer, 2u> buffers = {
+      boost::asio::buffer(&size, sizeof(size)),
+      boost::asio::buffer(message.data(), message.size())};
+    // Control messages always fit in the socket's send buffer.
+    error_code ec;
+    const auto written = boost::asio::write(_socket, buffers, ec);
+    if (ec != boost::asio::error::would_block) {
+      return ec;
+    }
+    std::vector<unsigned char> remaining(sizeof(size) + message.size());
+    std::memcpy(remaining.data(), &size, sizeof(size));
+    std::memcpy(remaining.data() + sizeof(size), message.data(), message.size());
+    remaining.erase(remaining.begin(), remaining.begin() + written);
+    return RunWithTimeout(timeout, [&](auto &&handler) {
+      boost::asio::async_write(_socket, boost::asio::buffer(remaining), handler);
+    });
+  }
+
+  error_code Connection::Read(Message &message, const time_duration timeout) {
+    uint32_t size;
+    auto ec = Fill(_read + sizeof(size), timeout);
+    if (ec) {
+      return ec;
+    }
+    std::memcpy(&size, _buffer.get() + _read, sizeof(size));
+    ec = Fill(_read + sizeof(size) + size, timeout);
+    if (ec) {
+      return ec;
+    }
+    message = {_read + sizeof(size), size};
+    _read += sizeof(size) + size;
+    return ec;
+  }
+
+  void Connection::ClearMessages() {
+    if (_read > 0u) {
+      std::memmove(_buffer.get(), _buffer.get() + _read, _size - _read);
+      _size -= _read;
+      _read = 0u;
+    }
+  }
+
+  error_code Connection::Fill(const size_t size, const time_duration timeout) {
+    if (size > _capacity) {
+      Reserve(std::max(size, 2u * _capacity));
+    }
+    while (_size < size) {
+      auto buffer = boost::asio::buffer(_buffer.get() + _size, _capacity - _size);
+      error_code ec;
+      auto received = _socket.read_some(buffer, ec);
+      if (ec == boost::asio::error::would_block) {
+        ec = RunWithTimeout(timeout, [&](auto &&handler) {
+          _socket.async_read_some(buffer, [&, handler](const error_code &result, size_t bytes) {
+            received = bytes;
+            handler(result);
+          });
+        });
+      }
+      if (ec) {
+        return ec;
+      }
+      _size += received;
+    }
+    return error_code();
+  }
+
+  void Connection::Reserve(const size_t capacity) {
+    auto buffer = std::make_unique<unsigned char[]>(capacity);
+    if (_size > 0u) {
+      std::memcpy(buffer.get(), _buffer.get(), _size);
+    }
+    _buffer = std::move(buffer);
+    _capacity = capacity;
+  }
+
+  template <typename Operation>
+  error_code Connection::RunWithTimeout(const time_duration timeout, Operation &&start) {
+    // Asio guarantees that its asynchronous operations will never fail with
+    // would_block, so any other value in ec indicates completion.
+    error_code ec = boost::asio::error::would_block;
+    bool timed_out = false;
+    _service.reset();
+    _timer.expires_from_now(timeout);
+    _timer.async_wait([this, &timed_out](const error_code &result) {
+      if (result != boost::asio::error::operation_aborted) {
+        timed_out = true;
+        error_code ignored;
+        _socket.cancel(ignored);
+      }
+    });
+    start([&ec](const error_code &result, auto && ...) { ec = result; });
+    do {
+      _service.run_one();
+    } while (ec == boost::asio::error::would_block);
+    // Wait for the handler of the timer too.
+    _timer.cancel();
+    _service.run();
+    return (timed_out ? boost::asio::error::timed_out : ec);
+  }
+
+} // namespace client
+} // namespace carla
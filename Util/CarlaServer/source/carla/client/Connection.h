@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_service.hpp>
+
+#include "carla/ArrayView.h"
+#include "carla/NonCopyable.h"
+
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace client {
+
+  using error_code = boost::system::error_code;
+
+  using time_duration = boost::posix_time::time_duration;
+
+  /// Blocking stream connection with time-out, the client side of
+  /// server::TCPServer. Messages are prefixed by their uint32 size.
+  ///
+  /// Received bytes are accumulated in a buffer that is reused between reads.
+  /// Each read of the socket takes as much as is available, so usually a whole
+  /// frame of messages is received with a few system calls, and the messages
+  /// are left in place in the buffer.
+  class Connection : private NonCopyable {
+  public:
+
+    /// Location of a message in the receive buffer.
+    struct Message {
+      size_t offset;
+      size_t size;
+    };
+
+    Connection();
+
+    ~Connection();
+
+    /// Connect to @a host at @a port, retrying until @a timeout if the
+    /// connection is refused. If @a host is "unix://<path>", connect to the
+    /// Unix domain socket "<path>-<port>".
+    error_code Connect(const std::string &host, uint32_t port, time_duration timeout);
+
+    void Disconnect();
+
+    bool IsConnected() const {
+      return _socket.is_open();
+    }
+
+    /// Write @a message prefixed with its size.
+    error_code Write(const_array_view<unsigned char> message, time_duration timeout);
+
+    /// Read the next message into the receive buffer. The buffer may be
+    /// reallocated while reading, the messages are located with GetView once
+    /// all are read.
+    error_code Read(Message &message, time_duration timeout);
+
+    const_array_view<unsigned char> GetView(const Message &message) const {
+      return array_view::make_const(_buffer.get() + message.offset, message.size);
+    }
+
+    /// Discard the messages read so far, the bytes received past them are
+    /// kept for the next read.
+    void ClearMessages();
+
+  private:
+
+    using protocol_type = boost::asio::generic::stream_protocol;
+
+    /// Read until the receive buffer holds at least @a size bytes.
+    error_code Fill(size_t size, time_duration timeout);
+
+    void Reserve(size_t capacity);
+
+    /// Start an asynchronous operation with @a start, passing it the handler
+    /// to call on completion, and run the io_service until it completes or
+    /// @a timeout expires.
+    template <typename Operation>
+    error_code RunWithTimeout(time_duration timeout, Operation &&start);
+
+    boost::asio::io_service _service;
+
+    protocol_type::socket _socket;
+
+    boost::asio::deadline_timer _timer;
+
+    std::unique_ptr<unsigned char[]> _buffer;
+
+    size_t _capacity = 0u;
+
+    /// Bytes received.
+    size_t _size = 0u;
+
+    /// Bytes of the messages read.
+    size_t _read = 0u;
+  };
+
+} // namespace client
+} // namespace carla
@@ -6,6 +6,8 @@
 
 #include "carla/server/AgentServer.h"
 
+#include "carla/Tracer.h"
+
 namespace carla {
 namespace server {
 
@@ -14,12 +16,40 @@ namespace server {
       const uint32_t out_port,
       const uint32_t in_port,
       const SensorDataInbox::Sensors &sensors,
-      const time_duration timeout)
-      : _out(encoder),
+      const time_duration timeout,
+      const uint32_t observer_port,
+      std::string encoded_scene,
+      const uint64_t shared_memory_size,
+      const std::string &unix_socket_path,
+      std::shared_ptr<Recorder> recorder)
+      : _recorder(std::move(recorder)),
+        _observers(
+            observer_port != 0u ?
+                std::make_unique<ObserverServer>(observer_port, std::move(encoded_scene)) :
+                nullptr),
+        _out(encoder),
         _in(encoder),
-        _sensor_inbox(sensors),
+        _shared_memory(
+            shared_memory_size != 0u ?
+                std::make_unique<SharedMemoryRing>(
+                    "/carla-server-" + std::to_string(out_port),
+                    shared_memory_size) :
+                nullptr),
+        _sensor_inbox(
+            sensors,
+            (_shared_memory != nullptr) && _shared_memory->IsValid() ?
+                _shared_memory.get() :
+                nullptr),
         _measurements(timeout),
         _control(timeout) {
+    if (!unix_socket_path.empty()) {
+      _out.SetUnixSocketPath(unix_socket_path);
+      _in.SetUnixSocketPath(unix_socket_path);
+    }
+    if (_recorder != nullptr) {
+      _out.SetRecorder(_recorder.get());
+      _in.SetRecorder(_recorder.get());
+    }
     _out.Connect(out_port, timeout);
     _out.Execute(_measurements);
     _in.Connect(in_port, timeout);
@@ -27,21 +57,26 @@ namespace server {
   }
 
   error_code AgentServer::WriteSensorData(const carla_sensor_data &data) {
+    CARLA_TRACE_SCOPE(AgentServer, WriteSensorData);
     _sensor_inbox.Write(data);
     return errc::success();
   }
 
-  error_code AgentServer::WriteMeasurements(const carla_measurements &measurements) {
+  error_code AgentServer::WriteMeasurements(
+      const carla_measurements &measurements,
+      const bool wait_for_sensor_data) {
+    CARLA_TRACE_SCOPE(AgentServer, WriteMeasurements);
     error_code ec;
     if (!_measurements.TryGetResult(ec)) {
       auto writer = _measurements.buffer()->MakeWriter();
-      writer->Write(measurements, _sensor_inbox);
+      writer->Write(measurements, _sensor_inbox, _observers.get(), wait_for_sensor_data);
       ec = errc::success();
     }
     return ec;
   };
 
   error_code AgentServer::ReadControl(carla_control &control, timeout_t timeout) {
+    CARLA_TRACE_SCOPE(AgentServer, ReadControl);
     error_code ec = errc::try_again();
     if (!_control.TryGetResult(ec)) {
       auto reader = _control.buffer()->TryMakeReader(timeout);
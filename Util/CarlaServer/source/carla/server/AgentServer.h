@@ -9,7 +9,10 @@
 #include "carla/NonCopyable.h"
 #include "carla/server/AsyncServer.h"
 #include "carla/server/EncoderServer.h"
+#include "carla/server/ObserverServer.h"
+#include "carla/server/Recorder.h"
 #include "carla/server/SensorDataInbox.h"
+#include "carla/server/SharedMemoryRing.h"
 #include "carla/server/TCPServer.h"
 
 namespace carla {
@@ -20,25 +23,54 @@ namespace server {
   class AgentServer : private NonCopyable {
   public:
 
+    /// If @a observer_port is not zero, read-only observers are accepted at
+    /// that port, and receive @a encoded_scene on connection.
+    ///
+    /// If @a shared_memory_size is not zero, the sensor data is written to a
+    /// shared memory region of that size named "/carla-server-<out_port>".
+    ///
+    /// If @a unix_socket_path is not empty, the client connects through Unix
+    /// domain sockets instead of TCP, see TCPServer.
+    ///
+    /// If @a recorder is not null, the frames sent and the controls received
+    /// are recorded.
     explicit AgentServer(
         CarlaEncoder &encoder,
         uint32_t out_port,
         uint32_t in_port,
         const SensorDataInbox::Sensors &sensors,
-        time_duration timeout);
+        time_duration timeout,
+        uint32_t observer_port = 0u,
+        std::string encoded_scene = std::string(),
+        uint64_t shared_memory_size = 0u,
+        const std::string &unix_socket_path = std::string(),
+        std::shared_ptr<Recorder> recorder = nullptr);
 
     error_code WriteSensorData(const carla_sensor_data &data);
 
-    error_code WriteMeasurements(const carla_measurements &measurements);
+    /// If @a wait_for_sensor_data is true, the sensor data of the same frame
+    /// is sent with the measurements as soon as it is ready, otherwise only
+    /// the sensor data already available is sent.
+    error_code WriteMeasurements(
+        const carla_measurements &measurements,
+        bool wait_for_sensor_data = false);
 
     error_code ReadControl(carla_control &control, timeout_t timeout);
 
   private:
 
+    /// Declared first to outlive the threads writing to them.
+    std::shared_ptr<Recorder> _recorder;
+
+    std::unique_ptr<ObserverServer> _observers;
+
     AsyncServer<EncoderServer<TCPServer>> _out;
 
     AsyncServer<EncoderServer<TCPServer>> _in;
 
+    /// Declared before the inbox that references it.
+    std::unique_ptr<SharedMemoryRing> _shared_memory;
+
     SensorDataInbox _sensor_inbox;
 
     StreamWriteTask<MeasurementsMessage> _measurements;
@@ -8,6 +8,7 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/Profiler.h"
+#include "carla/Tracer.h"
 #include "carla/server/AsyncService.h"
 #include "carla/server/ServerTraits.h"
 #include "carla/server/Task.h"
@@ -15,6 +16,8 @@
 namespace carla {
 namespace server {
 
+  class Recorder;
+
   // ===========================================================================
   // -- AsyncServer ------------------------------------------------------------
   // ===========================================================================
@@ -23,6 +26,11 @@ namespace server {
   /// submitted to a queue of asynchronous jobs. These jobs are executed in a
   /// single separate thread in order of submission. The "Disconnect()" function
   /// of the underlying server is assumed to be thread-safe.
+  ///
+  /// Only one job runs at a time. Each channel has its own AsyncServer and
+  /// its protocol only reads or writes in sequence, so the jobs use the
+  /// blocking Read and Write of the server even though a TCPServer could
+  /// keep a read and a write in flight.
   template <typename SERVER>
   class AsyncServer : private NonCopyable {
   public:
@@ -38,6 +46,13 @@ namespace server {
 
     std::future<error_code> Connect(uint32_t port, time_duration timeout);
 
+    /// Applies to the connections made after this call, see TCPServer.
+    void SetUnixSocketPath(std::string path);
+
+    /// Applies to the operations submitted after this call, see
+    /// EncoderServer.
+    void SetRecorder(Recorder *recorder);
+
     void Execute(ConnectTask &task);
 
     template <typename T>
@@ -72,6 +87,20 @@ namespace server {
     });
   }
 
+  template <typename S>
+  void AsyncServer<S>::SetUnixSocketPath(std::string path) {
+    _service.Post([this, path{std::move(path)}]() mutable {
+      _server.SetUnixSocketPath(std::move(path));
+    });
+  }
+
+  template <typename S>
+  void AsyncServer<S>::SetRecorder(Recorder *recorder) {
+    _service.Post([this, recorder]() {
+      _server.SetRecorder(recorder);
+    });
+  }
+
   template <typename S>
   void AsyncServer<S>::Execute(ConnectTask &task) {
     task._result = std::move(Connect(task.port(), task.timeout()));
@@ -82,6 +111,7 @@ namespace server {
   void AsyncServer<S>::Execute(ReadTask<T> &task) {
     auto job = [this, timeout=task.timeout()](){
       CARLA_PROFILE_SCOPE(AsyncServer, Read);
+      CARLA_TRACE_SCOPE(AsyncServer, Read);
       Reading<T> result;
       result.error_code = _server.Read(result.message, timeout);
       return result;
@@ -97,6 +127,7 @@ namespace server {
     auto message = std::make_shared<std::future<T>>(task.get_future_message());
     auto job = [this, message{std::move(message)}, timeout = task.timeout()]() {
       CARLA_PROFILE_SCOPE(AsyncServer, Write);
+      CARLA_TRACE_SCOPE(AsyncServer, Write);
       while (!_service.done()) {
         T message_value;
         if (future::wait_and_get(*message, message_value, timeout_t::milliseconds(1))) {
@@ -115,6 +146,7 @@ namespace server {
       error_code ec;
       do {
         CARLA_PROFILE_SCOPE(AsyncServer, StreamRead);
+        CARLA_TRACE_SCOPE(AsyncServer, StreamRead);
         if (_service.done()) {
           ec = errc::operation_aborted();
           break;
@@ -134,6 +166,7 @@ namespace server {
       error_code ec;
       do {
         CARLA_PROFILE_SCOPE(AsyncServer, StreamWrite);
+        CARLA_TRACE_SCOPE(AsyncServer, StreamWrite);
         if (_service.done()) {
           ec = errc::operation_aborted();
           break;
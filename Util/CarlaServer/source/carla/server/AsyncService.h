@@ -10,6 +10,7 @@
 #include <type_traits>
 
 #include "carla/NonCopyable.h"
+#include "carla/Tracer.h"
 #include "carla/server/ThreadSafeQueue.h"
 
 namespace carla {
@@ -39,7 +40,15 @@ namespace server {
     std::future<R> Post(F task) {
       auto ptask = std::make_shared<std::packaged_task<R()>>(std::move(task));
       auto future = ptask->get_future();
-      _queue.Push([ptask{std::move(ptask)}]() { (*ptask)(); });
+      // The time spent in the queue is traced too.
+      const auto posted = (tracer::IsEnabled() ? tracer::Clock::Now() : 0u);
+      _queue.Push([ptask{std::move(ptask)}, posted]() {
+        if (posted != 0u) {
+          tracer::RecordEvent("AsyncService.Queued", posted, tracer::Clock::Now());
+        }
+        CARLA_TRACE_SCOPE(AsyncService, Job);
+        (*ptask)();
+      });
       return future;
     }
 
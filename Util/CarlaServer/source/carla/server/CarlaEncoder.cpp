@@ -153,7 +153,9 @@ namespace server {
     return Protobuf::Encode(*message);
   }
 
-  std::string CarlaEncoder::Encode(const carla_measurements &values) {
+  std::string CarlaEncoder::Encode(
+      const carla_measurements &values,
+      const carla_telemetry *server_telemetry) {
     static thread_local auto *message = _protobuf.CreateMessage<cs::Measurements>();
     DEBUG_ASSERT(message != nullptr);
     message->set_frame_number(values.frame_number);
@@ -177,6 +179,24 @@ namespace server {
     for (auto &agent : agents(values)) {
       Set(message->add_non_player_agents(), agent);
     }
+    // Telemetry.
+    if (values.telemetry != nullptr) {
+      auto *telemetry = message->mutable_telemetry();
+      DEBUG_ASSERT(telemetry != nullptr);
+      telemetry->set_game_thread_time(values.telemetry->game_thread_time);
+      telemetry->set_sensor_readback_time(values.telemetry->sensor_readback_time);
+      telemetry->set_read_control_time(values.telemetry->read_control_time);
+      telemetry->set_walkers_pending_spawn(values.telemetry->walkers_pending_spawn);
+      telemetry->set_walkers_spawned(values.telemetry->walkers_spawned);
+      telemetry->set_walkers_checked(values.telemetry->walkers_checked);
+      telemetry->set_walkers_pooled(values.telemetry->walkers_pooled);
+      if (server_telemetry != nullptr) {
+        telemetry->set_encode_time(server_telemetry->encode_time);
+        telemetry->set_bytes_sent(server_telemetry->bytes_sent);
+      }
+    } else {
+      message->clear_telemetry();
+    }
     return Protobuf::Encode(*message);
   }
 
@@ -220,6 +240,7 @@ namespace server {
       values.brake = message->brake();
       values.hand_brake = message->hand_brake();
       values.reverse = message->reverse();
+      values.repeat_frames = message->repeat_frames();
 
       values.number_of_agent_controls = 0;
 
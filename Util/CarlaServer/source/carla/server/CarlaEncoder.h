@@ -46,7 +46,11 @@ namespace server {
 
     std::string Encode(const carla_episode_ready &values);
 
-    std::string Encode(const carla_measurements &values);
+    /// The encode time and bytes sent of @a server_telemetry are added to the
+    /// telemetry of @a values, if any.
+    std::string Encode(
+        const carla_measurements &values,
+        const carla_telemetry *server_telemetry = nullptr);
 
     bool Decode(const std::string &message, RequestNewEpisode &values);
 
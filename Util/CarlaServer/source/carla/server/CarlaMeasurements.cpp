@@ -22,6 +22,10 @@ namespace server {
     std::memcpy(_agents_buffer.get(), measurements.non_player_agents, size);
     _measurements.non_player_agents =
         reinterpret_cast<const carla_agent *>(_agents_buffer.get());
+    if (measurements.telemetry != nullptr) {
+      _telemetry = *measurements.telemetry;
+      _measurements.telemetry = &_telemetry;
+    }
   }
 
 } // namespace server
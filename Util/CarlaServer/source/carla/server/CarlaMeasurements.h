@@ -32,6 +32,8 @@ namespace server {
     std::unique_ptr<unsigned char[]> _agents_buffer = nullptr;
 
     uint32_t _agents_buffer_size = 0u;
+
+    carla_telemetry _telemetry;
   };
 
 } // namespace server
@@ -6,9 +6,14 @@
 
 #include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/Profiler.h"
+#include "carla/Tracer.h"
 #include "carla/server/AgentServer.h"
 #include "carla/server/CarlaServer.h"
 
+#include <algorithm>
+#include <fstream>
+
 using namespace carla;
 using namespace carla::server;
 
@@ -35,6 +40,7 @@ CarlaServerPtr carla_make_server() {
 
 void carla_free_server(CarlaServerPtr self) {
   delete Cast(self);
+  logging::Flush();
 }
 
 int32_t carla_server_connect(
@@ -53,6 +59,30 @@ int32_t carla_server_connect_blocking(
   return result.get().value();
 }
 
+int32_t carla_server_set_observer_port(
+    CarlaServerPtr self,
+    const uint32_t observer_port) {
+  return Cast(self)->SetObserverPort(observer_port).value();
+}
+
+void carla_server_set_unix_socket_path(
+    CarlaServerPtr self,
+    const char *path) {
+  Cast(self)->SetUnixSocketPath(path != nullptr ? path : "");
+}
+
+void carla_server_set_shared_memory_size(
+    CarlaServerPtr self,
+    const uint64_t size_in_bytes) {
+  Cast(self)->SetSharedMemorySize(size_in_bytes);
+}
+
+int32_t carla_server_set_recording_file(
+    CarlaServerPtr self,
+    const char *path) {
+  return Cast(self)->SetRecordingFile(path != nullptr ? path : "").value();
+}
+
 void carla_disconnect_server(CarlaServerPtr self) {
   Cast(self)->Disconnect();
 }
@@ -61,7 +91,8 @@ int32_t carla_read_request_new_episode(
       CarlaServerPtr self,
       carla_request_new_episode &values,
       const uint32_t timeout) {
-  CARLA_PROFILE_SCOPE(C_API, RequestNewEpisode)
+  CARLA_PROFILE_SCOPE(C_API, RequestNewEpisode);
+  CARLA_TRACE_SCOPE(C_API, RequestNewEpisode);
   auto ec = Cast(self)->TryRead(values, timeout_t::milliseconds(timeout));
   if (!ec) {
     log_debug("received valid request new episode");
@@ -108,6 +139,7 @@ int32_t carla_read_control(
       carla_control &values,
       const uint32_t timeout) {
   CARLA_PROFILE_SCOPE(C_API, ReadControl);
+  CARLA_TRACE_SCOPE(C_API, ReadControl);
   auto agent = Cast(self)->GetAgentServer();
   if (agent == nullptr) {
     log_debug("trying to read control but agent server is missing");
@@ -120,6 +152,7 @@ int32_t carla_write_sensor_data(
     CarlaServerPtr self,
     const carla_sensor_data &sensor_data) {
   CARLA_PROFILE_SCOPE(C_API, WriteSensorData);
+  CARLA_TRACE_SCOPE(C_API, WriteSensorData);
   auto agent = Cast(self)->GetAgentServer();
   if (agent == nullptr) {
     log_debug("trying to write sensor data but agent server is missing");
@@ -134,6 +167,7 @@ int32_t carla_write_measurements(
     const carla_measurements &measurements) {
   CARLA_PROFILE_FPS(FPS, SendMeasurements);
   CARLA_PROFILE_SCOPE(C_API, WriteMeasurements);
+  CARLA_TRACE_SCOPE(C_API, WriteMeasurements);
   auto agent = Cast(self)->GetAgentServer();
   if (agent == nullptr) {
     log_debug("trying to write measurements but agent server is missing");
@@ -142,3 +176,53 @@ int32_t carla_write_measurements(
     return agent->WriteMeasurements(measurements).value();
   }
 }
+
+int32_t carla_write_measurements_pipelined(
+    CarlaServerPtr self,
+    const carla_measurements &measurements) {
+  CARLA_PROFILE_FPS(FPS, SendMeasurements);
+  CARLA_PROFILE_SCOPE(C_API, WriteMeasurements);
+  CARLA_TRACE_SCOPE(C_API, WriteMeasurements);
+  auto agent = Cast(self)->GetAgentServer();
+  if (agent == nullptr) {
+    log_debug("trying to write measurements but agent server is missing");
+    return CARLA_SERVER_OPERATION_ABORTED;
+  } else {
+    return agent->WriteMeasurements(measurements, true).value();
+  }
+}
+
+uint32_t carla_profiler_snapshot(
+    carla_profiler_scope *scopes,
+    const uint32_t size) {
+  const auto statistics = profiler::GetStatistics();
+  const auto count = std::min(static_cast<size_t>(size), statistics.size());
+  for (auto i = 0u; i < count; ++i) {
+    const auto &scope = statistics[i];
+    scopes[i] = {scope.name, scope.count, scope.total, scope.min, scope.max, scope.p50, scope.p99, scope.p999};
+  }
+  return static_cast<uint32_t>(statistics.size());
+}
+
+void carla_tracer_set_enabled(const bool enabled) {
+  tracer::SetEnabled(enabled);
+}
+
+int32_t carla_tracer_dump(const char *path) {
+  std::ofstream file(path != nullptr ? path : "");
+  if (!file) {
+    log_error("unable to open trace file", (path != nullptr ? path : "(null)"));
+    return errc::invalid_argument().value();
+  }
+  tracer::Dump(file);
+  file.close();
+  return (file ? CARLA_SERVER_SUCCESS : errc::invalid_argument().value());
+}
+
+void carla_logging_set_level(const int32_t level) {
+  logging::SetLevel(level);
+}
+
+void carla_logging_set_rate_limit(const uint32_t messages_per_second) {
+  logging::SetRateLimit(messages_per_second);
+}
@@ -84,7 +84,7 @@ namespace detail {
       auto state = _state.load(std::memory_order_relaxed);
       std::uint32_t sub = (0x10 >> (state & 1)) | 0x2;
       state = _state.fetch_sub(sub, std::memory_order_relaxed) - sub;
-      if ((state & 0x6) == 0 && (state & (0x8 << (state & 1))) == 1) {
+      if ((state & 0x6) == 0 && (state & (0x8 << (state & 1))) != 0) {
           // Oi, we were the last ones accessing the data when we released
           // our cell. That means we should swap, but only if the producer
           // isn't in the middle of producing something, and hasn't already
@@ -14,6 +14,7 @@
 #include <mutex>
 
 #include "carla/Logging.h"
+#include "carla/Tracer.h"
 #include "carla/server/ServerTraits.h"
 
 namespace carla {
@@ -82,6 +83,7 @@ namespace detail {
       const auto deleter = [this](const T *ptr) { if (ptr) EndReading(); };
       ActiveBuffer active = NUMBER_OF_BUFFERS;
       {
+        CARLA_TRACE_SCOPE(DoubleBuffer, WaitForReader);
         std::unique_lock<std::mutex> lock(_mutex);
         _condition.wait_for(lock, timeout.to_chrono(), [&] {
           active = StartReading();
@@ -8,11 +8,17 @@
 
 #include "carla/Logging.h"
 #include "carla/NonCopyable.h"
+#include "carla/StopWatch.h"
+#include "carla/Tracer.h"
 #include "carla/server/CarlaEncoder.h"
 #include "carla/server/MeasurementsMessage.h"
+#include "carla/server/ObserverServer.h"
+#include "carla/server/Recorder.h"
 #include "carla/server/SensorDataInbox.h"
 #include "carla/server/ServerTraits.h"
 
+#include <cstring>
+
 namespace carla {
 namespace server {
 
@@ -34,10 +40,20 @@ namespace server {
       return _server.Connect(port, timeout);
     }
 
+    void SetUnixSocketPath(std::string path) {
+      _server.SetUnixSocketPath(std::move(path));
+    }
+
     void Disconnect() {
       _server.Disconnect();
     }
 
+    /// Record the frames written and, as controls, the messages read. Null
+    /// to stop recording.
+    void SetRecorder(Recorder *recorder) {
+      _recorder = recorder;
+    }
+
     /// @warning Since every received message consists of two Reads, the timeout
     /// applies to each individual Read. Effectively, it may wait twice the
     /// timeout.
@@ -50,41 +66,133 @@ namespace server {
             boost::system::errc::illegal_byte_sequence,
             boost::system::system_category());
       }
+      if (!ec && (_recorder != nullptr)) {
+        Record(string);
+      }
       return ec;
     }
 
     template <typename T>
     error_code Write(const T &values, time_duration timeout) {
+      CARLA_TRACE_SCOPE(EncoderServer, Write);
       const auto string = _encoder.Encode(values);
       return _server.Write(boost::asio::buffer(string), timeout);
     }
 
-    /// @warning This operation consists of several Writes, the timeout applies
-    /// to each individual Write. Effectively, it may wait the timeout for each
-    /// sensor.
+    /// The measurements, the sensor data and the end-of-data marker are
+    /// written with a single operation. If the sensor data has to be waited
+    /// for, the measurements are written first so the client can start
+    /// processing them in the meantime.
+    ///
+    /// @warning The timeout applies to each individual Write, and once more
+    /// to the wait for the sensor data of all the sensors.
     error_code Write(const MeasurementsMessage &values, time_duration timeout) {
-      const auto string = _encoder.Encode(values.measurements());
-      auto ec = _server.Write(boost::asio::buffer(string), timeout);
+      // If there are observers or a recorder, everything written is also
+      // copied into a frame to be shared between them.
+      auto *observers = values.observers();
+      const bool observe = (observers != nullptr) && observers->HasObservers();
+      std::shared_ptr<ObserverServer::frame_type> frame = nullptr;
+      if (observe || (_recorder != nullptr)) {
+        frame = std::make_shared<ObserverServer::frame_type>();
+      }
+      const auto string = [&]() {
+        CARLA_TRACE_SCOPE(EncoderServer, EncodeMeasurements);
+        StopWatch stop_watch;
+        auto result = _encoder.Encode(values.measurements(), &_telemetry);
+        stop_watch.Stop();
+        _telemetry.encode_time = 1e-3f * stop_watch.GetElapsedTime<std::chrono::microseconds>();
+        _telemetry.bytes_sent = 0u;
+        return result;
+      }();
+      Append(boost::asio::buffer(string), frame.get());
+      error_code ec;
+      if (values.wait_for_sensor_data()) {
+        ec = Flush(timeout);
+        if (!ec) {
+          Append(values.sensor_inbox(), values.measurements().frame_number, timeout, frame.get());
+        }
+      } else {
+        Append(values.sensor_inbox(), frame.get());
+      }
       if (!ec) {
-        ec = Write(values.sensor_inbox(), timeout);
+        Append(boost::asio::buffer(&_end_of_sensor_data, sizeof(_end_of_sensor_data)), frame.get());
+        ec = Flush(timeout);
+      }
+      if (!ec && (_recorder != nullptr)) {
+        _recorder->Write(recording::FRAME, values.measurements().frame_number, frame);
+      }
+      if (!ec && observe) {
+        observers->Write(std::move(frame));
       }
       return ec;
     }
 
   private:
 
-    error_code Write(SensorDataInbox &inbox, time_duration timeout) {
-      error_code ec;
+    /// Write the buffers appended and release the sensor data.
+    error_code Flush(time_duration timeout) {
+      CARLA_TRACE_SCOPE(EncoderServer, Flush);
+      _telemetry.bytes_sent += boost::asio::buffer_size(_buffers);
+      auto ec = _server.Write(_buffers, timeout);
+      _buffers.clear();
+      _readers.clear();
+      return ec;
+    }
+
+    /// Append @a buffer to the next write and a copy to @a frame if not null.
+    void Append(const_buffer buffer, ObserverServer::frame_type *frame) {
+      if (frame != nullptr) {
+        const auto begin = boost::asio::buffer_cast<const unsigned char *>(buffer);
+        frame->insert(frame->end(), begin, begin + boost::asio::buffer_size(buffer));
+      }
+      _buffers.push_back(buffer);
+    }
+
+    /// Append the sensor data of @a reader, kept until the next flush.
+    /// Observers always receive the data inline as they may not have access to
+    /// the shared memory.
+    void Append(SensorDataInbox::reader_type reader, ObserverServer::frame_type *frame) {
+      if ((frame != nullptr) && reader->is_shared()) {
+        reader->AppendInline(*frame);
+        frame = nullptr;
+      }
+      Append(reader->buffer(), frame);
+      _readers.push_back(std::move(reader));
+    }
+
+    void Append(SensorDataInbox &inbox, ObserverServer::frame_type *frame) {
       for (auto &sensor_buffer : inbox) {
         auto reader = sensor_buffer.TryMakeReader();
         if (reader != nullptr) {
-          auto ec = _server.Write(reader->buffer(), timeout);
-          if (ec)
-            return ec;
+          Append(std::move(reader), frame);
         }
       }
-      const uint32_t end_message = 0u;
-      return _server.Write(boost::asio::buffer(&end_message, sizeof(end_message)), timeout);;
+    }
+
+    /// Append the data of each sensor with frame number @a frame_number,
+    /// see SensorDataInbox::ReadFrame.
+    void Append(
+        SensorDataInbox &inbox,
+        uint32_t frame_number,
+        time_duration timeout,
+        ObserverServer::frame_type *frame) {
+      CARLA_TRACE_SCOPE(EncoderServer, WaitForSensorData);
+      const auto skipped = inbox.ReadFrame(frame_number, timeout, [&](auto reader) {
+        Append(std::move(reader), frame);
+      });
+      if (skipped > 0u) {
+        log_debug("sensor data of frame", frame_number, "timed-out for", skipped, "sensors");
+      }
+    }
+
+    /// Record @a message with its size prefix, as it was received.
+    void Record(const std::string &message) {
+      CARLA_TRACE_SCOPE(EncoderServer, Record);
+      const uint32_t size = static_cast<uint32_t>(message.size());
+      auto record = std::make_shared<std::vector<unsigned char>>(sizeof(size) + message.size());
+      std::memcpy(record->data(), &size, sizeof(size));
+      std::memcpy(record->data() + sizeof(size), message.data(), message.size());
+      _recorder->Write(recording::CONTROL, 0u, std::move(record));
     }
 
     error_code ReadString(std::string &string, time_duration timeout) {
@@ -106,6 +214,20 @@ namespace server {
     server_type _server;
 
     encoder_type &_encoder;
+
+    /// Buffers of the next write, reused every frame.
+    std::vector<const_buffer> _buffers;
+
+    /// Sensor data referenced by the buffers of the next write.
+    std::vector<SensorDataInbox::reader_type> _readers;
+
+    const uint32_t _end_of_sensor_data = 0u;
+
+    Recorder *_recorder = nullptr;
+
+    /// Encode time and bytes sent of the last measurements, sent with the
+    /// next ones.
+    carla_telemetry _telemetry = {};
   };
 
 } // namespace server
@@ -14,6 +14,7 @@
 namespace carla {
 namespace server {
 
+  class ObserverServer;
   class SensorDataInbox;
 
   class MeasurementsMessage : private NonCopyable {
@@ -21,9 +22,13 @@ namespace server {
 
     void Write(
         const carla_measurements &measurements,
-        SensorDataInbox &sensor_inbox) {
+        SensorDataInbox &sensor_inbox,
+        ObserverServer *observers,
+        bool wait_for_sensor_data = false) {
       _measurements.Write(measurements);
       _sensor_inbox = &sensor_inbox;
+      _observers = observers;
+      _wait_for_sensor_data = wait_for_sensor_data;
     }
 
     const carla_measurements &measurements() const {
@@ -35,11 +40,26 @@ namespace server {
       return *_sensor_inbox;
     }
 
+    /// Observers to receive a copy of the message, may be null.
+    ObserverServer *observers() const {
+      return _observers;
+    }
+
+    /// Whether the sensor data of the same frame as the measurements has to
+    /// be waited for, instead of sending only the data already available.
+    bool wait_for_sensor_data() const {
+      return _wait_for_sensor_data;
+    }
+
   private:
 
     CarlaMeasurements _measurements;
 
     SensorDataInbox *_sensor_inbox = nullptr;
+
+    ObserverServer *_observers = nullptr;
+
+    bool _wait_for_sensor_data = false;
   };
 
 } // namespace server
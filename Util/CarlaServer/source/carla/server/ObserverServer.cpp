@@ -0,0 +1,128 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/ObserverServer.h"
+
+#include <boost/asio/write.hpp>
+
+#include "carla/Logging.h"
+
+#include <algorithm>
+
+using namespace boost::asio::ip;
+
+namespace carla {
+namespace server {
+
+  // ===========================================================================
+  // -- ObserverServer::Connection ---------------------------------------------
+  // ===========================================================================
+
+  struct ObserverServer::Connection {
+    explicit Connection(boost::asio::io_service &service) : socket(service) {}
+
+    tcp::socket socket;
+
+    /// Whether a write is in progress.
+    bool busy = false;
+
+    /// Latest frame received while busy, sent when the write in progress
+    /// completes.
+    shared_frame pending_frame = nullptr;
+
+    uint64_t dropped_frames = 0u;
+  };
+
+  // ===========================================================================
+  // -- ObserverServer ---------------------------------------------------------
+  // ===========================================================================
+
+  ObserverServer::ObserverServer(const uint32_t port, std::string encoded_scene)
+      : _service(),
+        _work(_service),
+        _acceptor(_service),
+        _encoded_scene(std::move(encoded_scene)) {
+    try {
+      _acceptor = tcp::acceptor(_service, tcp::endpoint(tcp::v4(), port));
+      AcceptNext();
+    } catch (const boost::system::system_error &exception) {
+      log_error("observer server: unable to listen at port", port, ':', exception.what());
+    }
+    _thread = std::thread([this]() { _service.run(); });
+  }
+
+  ObserverServer::~ObserverServer() {
+    _service.stop();
+    if (_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+  void ObserverServer::Write(shared_frame frame) {
+    _service.post([this, frame{std::move(frame)}]() {
+      for (auto &connection : _connections) {
+        if (!connection->busy) {
+          Send(connection, boost::asio::buffer(*frame), frame);
+        } else {
+          if (connection->pending_frame != nullptr) {
+            ++connection->dropped_frames;
+          }
+          connection->pending_frame = frame;
+        }
+      }
+    });
+  }
+
+  void ObserverServer::AcceptNext() {
+    auto connection = std::make_shared<Connection>(_service);
+    _acceptor.async_accept(connection->socket, [this, connection](const error_code &ec) {
+      if (ec) {
+        log_error("observer server: connection failed:", ec.message());
+        return;
+      }
+      log_info("observer server: observer connected");
+      _connections.emplace_back(connection);
+      ++_number_of_observers;
+      Send(connection, boost::asio::buffer(_encoded_scene), nullptr);
+      AcceptNext();
+    });
+  }
+
+  void ObserverServer::Send(
+      std::shared_ptr<Connection> connection,
+      const const_buffer buffer,
+      shared_frame frame) {
+    connection->busy = true;
+    // The frame is captured to keep it alive until the write completes.
+    boost::asio::async_write(
+        connection->socket,
+        boost::asio::buffer(buffer),
+        [this, connection, frame{std::move(frame)}](const error_code &ec, size_t) {
+          connection->busy = false;
+          if (ec) {
+            log_info("observer server: observer disconnected:", ec.message());
+            Close(connection);
+          } else if (connection->pending_frame != nullptr) {
+            auto pending = std::move(connection->pending_frame);
+            connection->pending_frame = nullptr;
+            Send(connection, boost::asio::buffer(*pending), pending);
+          }
+        });
+  }
+
+  void ObserverServer::Close(const std::shared_ptr<Connection> &connection) {
+    auto it = std::find(_connections.begin(), _connections.end(), connection);
+    if (it != _connections.end()) {
+      log_debug("observer server: observer dropped", connection->dropped_frames, "frames");
+      _connections.erase(it);
+      --_number_of_observers;
+    }
+    error_code ec;
+    connection->socket.close(ec);
+  }
+
+} // namespace server
+} // namespace carla
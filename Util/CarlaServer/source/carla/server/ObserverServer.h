@@ -0,0 +1,80 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "carla/NonCopyable.h"
+#include "carla/server/ServerTraits.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace server {
+
+  /// Server for read-only observers of an episode. On connection, observers
+  /// receive the scene description followed by the same stream of
+  /// measurements and sensor data sent to the client.
+  ///
+  /// Each frame is serialized once and shared by every connection. A
+  /// connection still sending a previous frame keeps only the latest frame
+  /// to send next, so slow observers drop frames but never stall the
+  /// simulation.
+  class ObserverServer : private NonCopyable {
+  public:
+
+    using frame_type = std::vector<unsigned char>;
+
+    using shared_frame = std::shared_ptr<const frame_type>;
+
+    /// @a encoded_scene is the scene description as sent to the client.
+    ObserverServer(uint32_t port, std::string encoded_scene);
+
+    ~ObserverServer();
+
+    /// Whether there is any observer connected, there is no need to
+    /// serialize the frames otherwise.
+    bool HasObservers() const {
+      return _number_of_observers > 0u;
+    }
+
+    /// Send @a frame to every observer ready to receive it. Never blocks.
+    void Write(shared_frame frame);
+
+  private:
+
+    struct Connection;
+
+    void AcceptNext();
+
+    void Send(std::shared_ptr<Connection> connection, const_buffer buffer, shared_frame frame);
+
+    void Close(const std::shared_ptr<Connection> &connection);
+
+    boost::asio::io_service _service;
+
+    boost::asio::io_service::work _work;
+
+    boost::asio::ip::tcp::acceptor _acceptor;
+
+    const std::string _encoded_scene;
+
+    /// Only accessed from the service thread.
+    std::vector<std::shared_ptr<Connection>> _connections;
+
+    std::atomic<uint32_t> _number_of_observers{0u};
+
+    std::thread _thread;
+  };
+
+} // namespace server
+} // namespace carla
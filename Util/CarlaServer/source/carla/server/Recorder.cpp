@@ -0,0 +1,172 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/Recorder.h"
+
+#include "carla/Logging.h"
+#include "carla/Tracer.h"
+
+#include <cstring>
+
+namespace carla {
+namespace server {
+
+  using namespace recording;
+
+  // Integers are written in host order, as in the rest of the protocol.
+  template <typename T>
+  static void Append(std::vector<unsigned char> &buffer, const T value) {
+    const auto begin = reinterpret_cast<const unsigned char *>(&value);
+    buffer.insert(buffer.end(), begin, begin + sizeof(T));
+  }
+
+  Recorder::Recorder(
+      const std::string &path,
+      const size_t chunk_size,
+      const size_t max_pending_size)
+    : _file(path, std::ios::binary | std::ios::trunc),
+      _is_valid(_file.is_open()),
+      _chunk_size(chunk_size),
+      _max_pending_size(max_pending_size) {
+    if (!_is_valid) {
+      log_error("recorder: unable to create", path);
+      return;
+    }
+    std::vector<unsigned char> header(FILE_MAGIC, FILE_MAGIC + 8u);
+    Append(header, VERSION);
+    Append(header, uint32_t(0u));
+    _file.write(reinterpret_cast<const char *>(header.data()), header.size());
+    _offset = header.size();
+    _thread = std::thread([this]() { WriteChunks(); });
+    log_info("recorder: recording to", path);
+  }
+
+  Recorder::~Recorder() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _done = true;
+    }
+    _condition.notify_all();
+    if (_thread.joinable()) {
+      _thread.join();
+    }
+  }
+
+  void Recorder::Write(
+      const RecordType type,
+      uint32_t frame_number,
+      payload_type payload) {
+    if (!_is_valid) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    // Wait for the disk only if it cannot keep up.
+    _condition.wait(lock, [this]() {
+      return _done || (_pending_size < _max_pending_size);
+    });
+    if (type == FRAME) {
+      _last_frame_number = frame_number;
+    } else if (type == CONTROL) {
+      frame_number = _last_frame_number;
+    }
+    _pending_size += payload->size();
+    _pending.push_back({type, frame_number, std::move(payload)});
+    lock.unlock();
+    _condition.notify_all();
+  }
+
+  void Recorder::Write(
+      const RecordType type,
+      const uint32_t frame_number,
+      const std::string &payload) {
+    Write(type, frame_number, std::make_shared<std::vector<unsigned char>>(payload.begin(), payload.end()));
+  }
+
+  void Recorder::WriteChunks() {
+    std::vector<Record> chunk;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _done || !_pending.empty(); });
+        if (_pending.empty()) {
+          break;
+        }
+        // Take at least one record, and as many as fit in a chunk.
+        size_t size = 0u;
+        do {
+          size += _pending.front().payload->size();
+          _pending_size -= _pending.front().payload->size();
+          chunk.emplace_back(std::move(_pending.front()));
+          _pending.pop_front();
+        } while (!_pending.empty() && (size + _pending.front().payload->size() <= _chunk_size));
+      }
+      _condition.notify_all();
+      WriteChunk(chunk);
+      chunk.clear();
+    }
+    WriteIndex();
+  }
+
+  void Recorder::WriteChunk(const std::vector<Record> &records) {
+    CARLA_TRACE_SCOPE(Recorder, WriteChunk);
+    if (_failed) {
+      return;
+    }
+    std::vector<unsigned char> header;
+    header.reserve(CHUNK_HEADER_SIZE);
+    uint64_t size = 0u;
+    for (auto &record : records) {
+      size += RECORD_HEADER_SIZE + record.payload->size();
+    }
+    Append(header, CHUNK_MAGIC);
+    Append(header, static_cast<uint32_t>(records.size()));
+    Append(header, size);
+    _file.write(reinterpret_cast<const char *>(header.data()), header.size());
+    _offset += header.size();
+    for (auto &record : records) {
+      header.clear();
+      Append(header, static_cast<uint32_t>(record.type));
+      Append(header, record.frame_number);
+      Append(header, static_cast<uint64_t>(record.payload->size()));
+      _file.write(reinterpret_cast<const char *>(header.data()), header.size());
+      _offset += header.size();
+      _index.push_back({record.type, record.frame_number, _offset, record.payload->size()});
+      _file.write(reinterpret_cast<const char *>(record.payload->data()), record.payload->size());
+      _offset += record.payload->size();
+    }
+    _file.flush();
+    if (!_file) {
+      log_error("recorder: error writing the recording, the rest of the session is not recorded");
+      _failed = true;
+    }
+  }
+
+  void Recorder::WriteIndex() {
+    if (_failed) {
+      return;
+    }
+    std::vector<unsigned char> buffer;
+    buffer.reserve(_index.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+    for (auto &entry : _index) {
+      Append(buffer, entry.type);
+      Append(buffer, entry.frame_number);
+      Append(buffer, entry.offset);
+      Append(buffer, entry.size);
+    }
+    Append(buffer, _offset);
+    Append(buffer, static_cast<uint64_t>(_index.size()));
+    buffer.insert(buffer.end(), INDEX_MAGIC, INDEX_MAGIC + 8u);
+    _file.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+    _file.close();
+    if (!_file) {
+      log_error("recorder: error writing the index of the recording");
+    } else {
+      log_info("recorder: recorded", _index.size(), "records");
+    }
+  }
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,154 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace server {
+
+  /// Layout of the session recordings written by Recorder and read by
+  /// Recording. Every integer is little-endian.
+  ///
+  ///     file    := header chunk* index trailer
+  ///     header  := "CARLAREC" u32:version u32:reserved
+  ///     chunk   := u32:CHUNK_MAGIC u32:number_of_records u64:size record*
+  ///     record  := u32:type u32:frame_number u64:size u8[size]
+  ///     index   := (u32:type u32:frame_number u64:offset u64:size)*
+  ///     trailer := u64:index_offset u64:number_of_entries "CARLAIDX"
+  ///
+  /// The payload of each record is exactly what was sent or received through
+  /// the socket, including the size prefix of the messages. The index
+  /// offsets point to the payloads. A recording without trailer, e.g. if the
+  /// process crashed, can still be read by scanning the chunks.
+  namespace recording {
+
+    enum RecordType : uint32_t {
+      /// Scene description, starts a new episode.
+      SCENE_DESCRIPTION = 1u,
+      /// Measurements, sensor data and end-of-data marker of a frame, with
+      /// the sensor data always inline.
+      FRAME = 2u,
+      /// Control received, with the frame number of the last frame recorded.
+      CONTROL = 3u
+    };
+
+    constexpr uint32_t VERSION = 1u;
+
+    constexpr uint32_t CHUNK_MAGIC = 0x4b4e4843u; // "CHNK"
+
+    constexpr char FILE_MAGIC[] = "CARLAREC";
+
+    constexpr char INDEX_MAGIC[] = "CARLAIDX";
+
+    constexpr size_t HEADER_SIZE = 16u;
+
+    constexpr size_t CHUNK_HEADER_SIZE = 16u;
+
+    constexpr size_t RECORD_HEADER_SIZE = 16u;
+
+    constexpr size_t INDEX_ENTRY_SIZE = 24u;
+
+    constexpr size_t TRAILER_SIZE = 24u;
+
+    struct IndexEntry {
+      uint32_t type;
+      uint32_t frame_number;
+      uint64_t offset;
+      uint64_t size;
+    };
+
+  } // namespace recording
+
+  /// Writes a session recording, see recording namespace for the layout.
+  ///
+  /// Records are queued by Write and written to disk in chunks by a separate
+  /// thread, so writing never waits for the disk unless more than
+  /// @a max_pending_size bytes are queued.
+  class Recorder : private NonCopyable {
+  public:
+
+    using payload_type = std::shared_ptr<const std::vector<unsigned char>>;
+
+    explicit Recorder(
+        const std::string &path,
+        size_t chunk_size = 64u * 1024u * 1024u,
+        size_t max_pending_size = 512u * 1024u * 1024u);
+
+    /// Writes the pending records and the index.
+    ~Recorder();
+
+    /// Whether the file could be created.
+    bool IsValid() const {
+      return _is_valid;
+    }
+
+    /// Queue a record, thread-safe. Controls take the frame number of the
+    /// last frame written.
+    void Write(recording::RecordType type, uint32_t frame_number, payload_type payload);
+
+    void Write(recording::RecordType type, uint32_t frame_number, const std::string &payload);
+
+  private:
+
+    struct Record {
+      recording::RecordType type;
+      uint32_t frame_number;
+      payload_type payload;
+    };
+
+    void WriteChunks();
+
+    void WriteChunk(const std::vector<Record> &records);
+
+    void WriteIndex();
+
+    std::ofstream _file;
+
+    const bool _is_valid;
+
+    const size_t _chunk_size;
+
+    const size_t _max_pending_size;
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    /// Everything below is guarded by the mutex.
+
+    std::deque<Record> _pending;
+
+    size_t _pending_size = 0u;
+
+    uint32_t _last_frame_number = 0u;
+
+    bool _done = false;
+
+    /// Only accessed by the writer thread.
+
+    uint64_t _offset = 0u;
+
+    std::vector<recording::IndexEntry> _index;
+
+    bool _failed = false;
+
+    std::thread _thread;
+  };
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,162 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/Recording.h"
+
+#include "carla/Logging.h"
+
+#include <cstring>
+
+namespace carla {
+namespace server {
+
+  using namespace recording;
+
+  template <typename T>
+  static T ReadValue(const unsigned char *data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  static error_code IllegalByteSequence() {
+    return boost::system::errc::make_error_code(boost::system::errc::illegal_byte_sequence);
+  }
+
+  error_code Recording::Open(const std::string &path) {
+    _entries.clear();
+    _episodes.clear();
+    _file.close();
+    _file.clear();
+    _file.open(path, std::ios::binary);
+    if (!_file) {
+      log_error("recording: unable to open", path);
+      return errc::invalid_argument();
+    }
+    _file.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(_file.tellg());
+    unsigned char header[HEADER_SIZE];
+    _file.seekg(0);
+    if ((file_size < HEADER_SIZE) ||
+        !_file.read(reinterpret_cast<char *>(header), HEADER_SIZE) ||
+        (std::memcmp(header, FILE_MAGIC, 8u) != 0)) {
+      log_error("recording:", path, "is not a recording");
+      return IllegalByteSequence();
+    }
+    if (ReadValue<uint32_t>(header + 8u) != VERSION) {
+      log_error("recording:", path, "has an unsupported version");
+      return IllegalByteSequence();
+    }
+    if (!ReadIndex(file_size)) {
+      log_warning("recording:", path, "has no index, scanning it");
+      _file.clear();
+      if (!ScanChunks(file_size)) {
+        return IllegalByteSequence();
+      }
+    }
+    for (auto i = 0u; i < _entries.size(); ++i) {
+      if (_entries[i].type == SCENE_DESCRIPTION) {
+        if (!_episodes.empty()) {
+          _episodes.back().end = i;
+        }
+        _episodes.push_back({i, _entries.size()});
+      }
+    }
+    return errc::success();
+  }
+
+  error_code Recording::Read(const entry_type &entry, std::vector<unsigned char> &buffer) {
+    buffer.resize(entry.size);
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!_file.read(reinterpret_cast<char *>(buffer.data()), entry.size)) {
+      return IllegalByteSequence();
+    }
+    return errc::success();
+  }
+
+  bool Recording::ReadIndex(const uint64_t file_size) {
+    unsigned char trailer[TRAILER_SIZE];
+    if (file_size < HEADER_SIZE + TRAILER_SIZE) {
+      return false;
+    }
+    _file.seekg(static_cast<std::streamoff>(file_size - TRAILER_SIZE));
+    if (!_file.read(reinterpret_cast<char *>(trailer), TRAILER_SIZE) ||
+        (std::memcmp(trailer + 16u, INDEX_MAGIC, 8u) != 0)) {
+      return false;
+    }
+    const auto index_offset = ReadValue<uint64_t>(trailer);
+    const auto number_of_entries = ReadValue<uint64_t>(trailer + 8u);
+    if ((index_offset > file_size) ||
+        (number_of_entries * INDEX_ENTRY_SIZE != file_size - TRAILER_SIZE - index_offset)) {
+      return false;
+    }
+    std::vector<unsigned char> index(number_of_entries * INDEX_ENTRY_SIZE);
+    _file.seekg(static_cast<std::streamoff>(index_offset));
+    if (!_file.read(reinterpret_cast<char *>(index.data()), index.size())) {
+      return false;
+    }
+    _entries.reserve(number_of_entries);
+    for (auto *entry = index.data(); entry != index.data() + index.size(); entry += INDEX_ENTRY_SIZE) {
+      _entries.push_back({
+          ReadValue<uint32_t>(entry),
+          ReadValue<uint32_t>(entry + 4u),
+          ReadValue<uint64_t>(entry + 8u),
+          ReadValue<uint64_t>(entry + 16u)});
+      if (_entries.back().offset + _entries.back().size > index_offset) {
+        _entries.clear();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Recording::ScanChunks(const uint64_t file_size) {
+    uint64_t offset = HEADER_SIZE;
+    unsigned char header[CHUNK_HEADER_SIZE];
+    while (offset + CHUNK_HEADER_SIZE <= file_size) {
+      _file.seekg(static_cast<std::streamoff>(offset));
+      if (!_file.read(reinterpret_cast<char *>(header), CHUNK_HEADER_SIZE) ||
+          (ReadValue<uint32_t>(header) != CHUNK_MAGIC)) {
+        break;
+      }
+      const auto number_of_records = ReadValue<uint32_t>(header + 4u);
+      const auto size = ReadValue<uint64_t>(header + 8u);
+      const auto end = offset + CHUNK_HEADER_SIZE + size;
+      if ((size > file_size) || (end > file_size)) {
+        // Last chunk, incomplete.
+        break;
+      }
+      std::vector<entry_type> entries;
+      uint64_t record = offset + CHUNK_HEADER_SIZE;
+      for (auto i = 0u; i < number_of_records; ++i) {
+        unsigned char record_header[RECORD_HEADER_SIZE];
+        _file.seekg(static_cast<std::streamoff>(record));
+        if ((record + RECORD_HEADER_SIZE > end) ||
+            !_file.read(reinterpret_cast<char *>(record_header), RECORD_HEADER_SIZE)) {
+          log_error("recording: corrupt chunk at offset", offset);
+          return false;
+        }
+        const entry_type entry = {
+            ReadValue<uint32_t>(record_header),
+            ReadValue<uint32_t>(record_header + 4u),
+            record + RECORD_HEADER_SIZE,
+            ReadValue<uint64_t>(record_header + 8u)};
+        if (entry.size > end - entry.offset) {
+          log_error("recording: corrupt chunk at offset", offset);
+          return false;
+        }
+        entries.push_back(entry);
+        record = entry.offset + entry.size;
+      }
+      _entries.insert(_entries.end(), entries.begin(), entries.end());
+      offset = end;
+    }
+    return true;
+  }
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,62 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/server/Recorder.h"
+#include "carla/server/ServerTraits.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace server {
+
+  /// Reads a session recording written by Recorder.
+  class Recording : private NonCopyable {
+  public:
+
+    using entry_type = recording::IndexEntry;
+
+    /// Records of an episode, from its scene description up to the next one.
+    struct Episode {
+      size_t begin;
+      size_t end;
+    };
+
+    /// Open the recording at @a path and load its index. If the index is
+    /// missing, it is rebuilt by scanning the chunks, ignoring an incomplete
+    /// last chunk.
+    error_code Open(const std::string &path);
+
+    const std::vector<entry_type> &entries() const {
+      return _entries;
+    }
+
+    const std::vector<Episode> &episodes() const {
+      return _episodes;
+    }
+
+    /// Read the payload of @a entry into @a buffer.
+    error_code Read(const entry_type &entry, std::vector<unsigned char> &buffer);
+
+  private:
+
+    bool ReadIndex(uint64_t file_size);
+
+    bool ScanChunks(uint64_t file_size);
+
+    std::ifstream _file;
+
+    std::vector<entry_type> _entries;
+
+    std::vector<Episode> _episodes;
+  };
+
+} // namespace server
+} // namespace carla
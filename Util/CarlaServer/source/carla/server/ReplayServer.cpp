@@ -0,0 +1,135 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/ReplayServer.h"
+
+#include "carla/Logging.h"
+
+#include <future>
+#include <thread>
+
+namespace carla {
+namespace server {
+
+  /// Read and discard a message with its size prefix.
+  static error_code ReadMessage(
+      TCPServer &server,
+      std::vector<unsigned char> &buffer,
+      const time_duration timeout) {
+    uint32_t size;
+    auto ec = server.Read(boost::asio::buffer(&size, sizeof(size)), timeout);
+    if (!ec) {
+      buffer.resize(size);
+      ec = server.Read(boost::asio::buffer(buffer), timeout);
+    }
+    return ec;
+  }
+
+  ReplayServer::ReplayServer(Recording &recording, const time_duration timeout)
+    : _recording(recording),
+      _timeout(timeout) {}
+
+  error_code ReplayServer::Connect(const uint32_t world_port) {
+    _port = world_port;
+    return _world.Connect(world_port, _timeout);
+  }
+
+  error_code ReplayServer::PlayEpisode(const size_t index) {
+    _frames_sent = 0u;
+    const auto &entries = _recording.entries();
+    const auto &episode = _recording.episodes().at(index);
+    std::vector<Recording::entry_type> frames;
+    for (auto i = episode.begin; i < episode.end; ++i) {
+      if (entries[i].type == recording::FRAME) {
+        frames.push_back(entries[i]);
+      }
+    }
+
+    // World protocol, the recorded scene description is sent as it is.
+    std::vector<unsigned char> message;
+    // The new episode request comes whenever the client is done with the
+    // previous one.
+    auto ec = ReadMessage(_world, message, boost::posix_time::pos_infin);
+    if (!ec) {
+      ec = _recording.Read(entries[episode.begin], message);
+    }
+    if (!ec) {
+      ec = _world.Write(boost::asio::buffer(message), _timeout);
+    }
+    if (!ec) {
+      ec = ReadMessage(_world, message, _timeout);
+    }
+    if (!ec) {
+      const auto ready = _encoder.Encode(carla_episode_ready{true});
+      ec = _world.Write(boost::asio::buffer(ready), _timeout);
+    }
+    if (ec) {
+      return ec;
+    }
+
+    // Agent connections, the controls are read by a separate thread so the
+    // client never blocks sending them.
+    TCPServer stream;
+    TCPServer control;
+    ec = stream.Connect(_port + 1u, _timeout);
+    if (!ec) {
+      ec = control.Connect(_port + 2u, _timeout);
+    }
+    if (ec) {
+      return ec;
+    }
+    auto controls = std::async(std::launch::async, [&]() {
+      std::vector<unsigned char> buffer;
+      error_code result;
+      for (auto i = 0u; (i < frames.size()) && !result; ++i) {
+        result = ReadMessage(control, buffer, _timeout);
+      }
+      return result;
+    });
+    ec = WriteFrames(stream, frames);
+    if (ec) {
+      control.Disconnect();
+    }
+    // A client that stops sending controls only delays closing the episode.
+    if (controls.get()) {
+      log_debug("replay: not every control was received");
+    }
+    log_info("replay: episode", index, "sent", _frames_sent, "frames");
+    return ec;
+  }
+
+  error_code ReplayServer::WriteFrames(
+      TCPServer &stream,
+      const std::vector<Recording::entry_type> &frames) {
+    // The next frame is read from disk while the current one is sent.
+    std::vector<unsigned char> current;
+    std::vector<unsigned char> next;
+    error_code ec;
+    if (!frames.empty()) {
+      ec = _recording.Read(frames[0u], current);
+    }
+    for (auto i = 0u; (i < frames.size()) && !ec; ++i) {
+      std::future<error_code> reading;
+      if (i + 1u < frames.size()) {
+        reading = std::async(std::launch::async, [&]() {
+          return _recording.Read(frames[i + 1u], next);
+        });
+      }
+      ec = stream.Write(boost::asio::buffer(current), _timeout);
+      if (!ec) {
+        ++_frames_sent;
+      }
+      if (reading.valid()) {
+        const auto read_ec = reading.get();
+        ec = (ec ? ec : read_ec);
+      }
+      std::swap(current, next);
+    }
+    return ec;
+  }
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,63 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/server/CarlaEncoder.h"
+#include "carla/server/Recording.h"
+#include "carla/server/ServerTraits.h"
+#include "carla/server/TCPServer.h"
+
+#include <vector>
+
+namespace carla {
+namespace server {
+
+  /// Plays the role of the game for a client using a session recording. The
+  /// world protocol is answered with the recorded scene description, and the
+  /// recorded frames are streamed as fast as the client reads them; the
+  /// controls received are discarded.
+  class ReplayServer : private NonCopyable {
+  public:
+
+    /// @a recording must outlive the server.
+    ReplayServer(Recording &recording, time_duration timeout);
+
+    /// Wait for a client to connect at @a world_port, the agent ports are
+    /// the next two as in CarlaServer.
+    error_code Connect(uint32_t world_port);
+
+    /// Answer the next new episode request with episode @a index of the
+    /// recording and stream its frames. Once the client has sent a control
+    /// for every frame the agent connections are closed, so the client sees
+    /// the end of the episode as a disconnection.
+    error_code PlayEpisode(size_t index);
+
+    /// Frames sent by the last PlayEpisode.
+    size_t GetNumberOfFramesSent() const {
+      return _frames_sent;
+    }
+
+  private:
+
+    error_code WriteFrames(TCPServer &stream, const std::vector<Recording::entry_type> &frames);
+
+    Recording &_recording;
+
+    const time_duration _timeout;
+
+    uint32_t _port = 0u;
+
+    TCPServer _world;
+
+    CarlaEncoder _encoder;
+
+    size_t _frames_sent = 0u;
+  };
+
+} // namespace server
+} // namespace carla
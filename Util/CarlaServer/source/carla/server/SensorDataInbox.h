@@ -11,6 +11,8 @@
 #include "carla/server/DoubleBuffer.h"
 #include "carla/server/SensorDataMessage.h"
 
+#include <algorithm>
+#include <chrono>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -68,7 +70,14 @@ namespace detail {
 
     using buffer_iterator = detail::value_iterator<Map::iterator>;
 
-    explicit SensorDataInbox(const Sensors &sensors) {
+    using reader_type = decltype(std::declval<DataBuffer &>().TryMakeReader());
+
+    /// If @a shared_memory is not null, the sensor data is written there and
+    /// the messages only reference it. See SensorDataMessage.
+    explicit SensorDataInbox(
+        const Sensors &sensors,
+        SharedMemoryRing *shared_memory = nullptr)
+      : _shared_memory(shared_memory) {
       // We need to initialize the map before hand so it remains constant and
       // doesn't need a lock.
       for (auto &sensor : sensors)
@@ -77,7 +86,7 @@ namespace detail {
 
     void Write(const carla_sensor_data &data) {
       auto writer = _buffers.at(data.id).MakeWriter();
-      writer->Write(data);
+      writer->Write(data, _shared_memory);
     }
 
     /// Tries to acquire a reader on the buffer of the given sensor. See
@@ -86,6 +95,37 @@ namespace detail {
       return _buffers.at(sensor_id).TryMakeReader();
     }
 
+    /// Call @a callback with a reader on the data of each sensor with frame
+    /// number @a frame_number, waiting for it if necessary. Older data is
+    /// discarded. The @a timeout applies to the whole call, once it expires
+    /// the sensors whose data has not arrived yet are skipped.
+    ///
+    /// @return the number of sensors skipped.
+    template <typename F>
+    uint32_t ReadFrame(uint32_t frame_number, timeout_t timeout, F &&callback) {
+      using clock = std::chrono::steady_clock;
+      const auto deadline = clock::now() + timeout.to_chrono();
+      uint32_t skipped = 0u;
+      for (auto &item : _buffers) {
+        for (;;) {
+          const auto time_left = std::max(deadline - clock::now(), clock::duration::zero());
+          auto reader = item.second.TryMakeReader(time_left);
+          if (reader == nullptr) {
+            ++skipped;
+            break;
+          }
+          // Measurements only carry the lower 32 bits of the frame number.
+          const auto frame_difference = static_cast<int32_t>(
+              static_cast<uint32_t>(reader->frame_number()) - frame_number);
+          if (frame_difference >= 0) {
+            callback(std::move(reader));
+            break;
+          }
+        }
+      }
+      return skipped;
+    }
+
     buffer_iterator begin() {
       return _buffers.begin();
     }
@@ -97,6 +137,8 @@ namespace detail {
   private:
 
     Map _buffers;
+
+    SharedMemoryRing *_shared_memory;
   };
 
 } // namespace server
@@ -8,11 +8,34 @@
 
 #include "carla/Logging.h"
 #include "carla/server/CarlaServerAPI.h"
+#include "carla/server/SharedMemoryRing.h"
 
 namespace carla {
 namespace server {
 
-  void SensorDataMessage::Write(const carla_sensor_data &data) {
+  void SensorDataMessage::Write(
+      const carla_sensor_data &data,
+      SharedMemoryRing *shared_memory) {
+    // Every sensor header starts with the frame number.
+    _frame_number = 0u;
+    if (data.header_size >= sizeof(_frame_number)) {
+      std::memcpy(&_frame_number, data.header, sizeof(_frame_number));
+    }
+
+    _shared_memory = nullptr;
+    uint64_t offset;
+    uint64_t sequence;
+    if ((shared_memory != nullptr) && shared_memory->Write(
+            static_cast<const unsigned char *>(data.header), data.header_size,
+            static_cast<const unsigned char *>(data.data), data.data_size,
+            offset, sequence)) {
+      WriteSharedMemoryReference(data, offset, sequence);
+      _shared_memory = shared_memory;
+      _shared_offset = offset;
+      _shared_sequence = sequence;
+      return;
+    }
+
     // The buffer contains id + data-header + data.
     const uint32_t buffer_size =
         sizeof(uint32_t) +
@@ -35,6 +58,63 @@ namespace server {
     std::memcpy(begin, data.data, data.data_size);
   }
 
+  void SensorDataMessage::WriteSharedMemoryReference(
+      const carla_sensor_data &data,
+      const uint64_t offset,
+      const uint64_t sequence) {
+    // The buffer contains id + offset + size + sequence.
+    const uint32_t buffer_size =
+        sizeof(uint32_t) +
+        sizeof(uint64_t) +
+        sizeof(uint32_t) +
+        sizeof(uint64_t);
+    Reset(sizeof(uint32_t) + buffer_size);
+
+    auto begin = _buffer.get();
+
+    std::memcpy(begin, &buffer_size, sizeof(uint32_t));
+    begin += sizeof(uint32_t);
+
+    const uint32_t id = data.id | SHARED_MEMORY_FLAG;
+    std::memcpy(begin, &id, sizeof(uint32_t));
+    begin += sizeof(uint32_t);
+
+    std::memcpy(begin, &offset, sizeof(uint64_t));
+    begin += sizeof(uint64_t);
+
+    const uint32_t size = data.header_size + data.data_size;
+    std::memcpy(begin, &size, sizeof(uint32_t));
+    begin += sizeof(uint32_t);
+
+    std::memcpy(begin, &sequence, sizeof(uint64_t));
+  }
+
+  void SensorDataMessage::AppendInline(std::vector<unsigned char> &output) const {
+    if (!is_shared()) {
+      output.insert(output.end(), _buffer.get(), _buffer.get() + _size);
+      return;
+    }
+    // See WriteSharedMemoryReference for the layout of the reference.
+    uint32_t id;
+    std::memcpy(&id, _buffer.get() + sizeof(uint32_t), sizeof(uint32_t));
+    id &= ~SHARED_MEMORY_FLAG;
+    uint32_t size;
+    std::memcpy(&size, _buffer.get() + 2u * sizeof(uint32_t) + sizeof(uint64_t), sizeof(uint32_t));
+    const uint32_t buffer_size = sizeof(uint32_t) + size;
+    const auto append = [&output](const void *data, size_t count) {
+      auto begin = static_cast<const unsigned char *>(data);
+      output.insert(output.end(), begin, begin + count);
+    };
+    append(&buffer_size, sizeof(uint32_t));
+    append(&id, sizeof(uint32_t));
+    const auto region = _shared_memory->data();
+    append(region + _shared_offset + SharedMemoryRing::SLOT_PREFIX_SIZE, size);
+    // The slot is checked after the copy, it may be overwritten meanwhile.
+    if (!SharedMemoryRing::IsSlotValid(region, _shared_memory->size(), _shared_offset, size, _shared_sequence)) {
+      log_error("shared memory: sensor", id, "data overwritten before being copied");
+    }
+  }
+
   void SensorDataMessage::Reset(uint32_t count) {
     if (_capacity < count) {
       log_debug("allocating sensor buffer of", count, "bytes");
@@ -10,6 +10,7 @@
 #include "carla/server/ServerTraits.h"
 
 #include <memory>
+#include <vector>
 
 struct carla_sensor_data;
 struct carla_sensor_definition;
@@ -17,17 +18,47 @@ struct carla_sensor_definition;
 namespace carla {
 namespace server {
 
+  class SharedMemoryRing;
+
   class SensorDataMessage : private NonCopyable {
   public:
 
-    void Write(const carla_sensor_data &data);
+    /// Set in the sensor id of messages whose header and data are in shared
+    /// memory, the message contains only the uint64 offset of their slot,
+    /// their uint32 size and the uint64 sequence of the slot (see
+    /// SharedMemoryRing).
+    static constexpr uint32_t SHARED_MEMORY_FLAG = 1u << 31;
+
+    /// If @a shared_memory is not null, the header and data are written to it
+    /// if they fit, the message only references them.
+    void Write(const carla_sensor_data &data, SharedMemoryRing *shared_memory = nullptr);
 
     const_buffer buffer() const {
       return boost::asio::buffer(_buffer.get(), _size);
     }
 
+    /// Frame number found at the beginning of the sensor header, zero if the
+    /// header is too small to contain one.
+    uint64_t frame_number() const {
+      return _frame_number;
+    }
+
+    /// Whether the header and data are in shared memory.
+    bool is_shared() const {
+      return _shared_memory != nullptr;
+    }
+
+    /// Append the message with the header and data inline, as if it was
+    /// written without shared memory, to @a output.
+    void AppendInline(std::vector<unsigned char> &output) const;
+
   private:
 
+    void WriteSharedMemoryReference(
+        const carla_sensor_data &data,
+        uint64_t offset,
+        uint64_t sequence);
+
     void Reset(uint32_t count);
 
     std::unique_ptr<unsigned char[]> _buffer = nullptr;
@@ -35,6 +66,15 @@ namespace server {
     uint32_t _size = 0u;
 
     uint32_t _capacity = 0u;
+
+    uint64_t _frame_number = 0u;
+
+    /// Region holding the header and data, null if inline.
+    const SharedMemoryRing *_shared_memory = nullptr;
+
+    uint64_t _shared_offset = 0u;
+
+    uint64_t _shared_sequence = 0u;
   };
 
 } // namespace server
@@ -0,0 +1,124 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/SharedMemoryRing.h"
+
+#include "carla/Logging.h"
+
+#include <atomic>
+#include <cstring>
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif // __linux__
+
+namespace carla {
+namespace server {
+
+#ifdef __linux__
+
+  SharedMemoryRing::SharedMemoryRing(std::string name, const uint64_t size)
+      : _name(std::move(name)) {
+    const int fd = shm_open(_name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+      log_error("shared memory: unable to open", _name, ':', std::strerror(errno));
+      return;
+    }
+    if (ftruncate(fd, size) != 0) {
+      log_error("shared memory: unable to resize", _name, ':', std::strerror(errno));
+    } else {
+      void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        log_error("shared memory: unable to map", _name, ':', std::strerror(errno));
+      } else {
+        _data = static_cast<unsigned char *>(ptr);
+        _size = size;
+        log_info("shared memory: created", _name, "of", size, "bytes");
+      }
+    }
+    // The mapping stays valid after closing the descriptor.
+    close(fd);
+    if (_data == nullptr) {
+      shm_unlink(_name.c_str());
+    }
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() {
+    if (_data != nullptr) {
+      munmap(_data, _size);
+      shm_unlink(_name.c_str());
+    }
+  }
+
+#else
+
+  SharedMemoryRing::SharedMemoryRing(std::string name, uint64_t)
+      : _name(std::move(name)) {
+    log_error("shared memory: not supported on this platform");
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() {}
+
+#endif // __linux__
+
+  constexpr uint64_t SharedMemoryRing::SLOT_PREFIX_SIZE;
+  constexpr uint64_t SharedMemoryRing::SLOT_SUFFIX_SIZE;
+
+  bool SharedMemoryRing::Write(
+      const unsigned char *header,
+      const uint32_t header_size,
+      const unsigned char *data,
+      const uint32_t data_size,
+      uint64_t &offset,
+      uint64_t &sequence) {
+    const uint64_t payload_size = static_cast<uint64_t>(header_size) + data_size;
+    const uint64_t size = SLOT_PREFIX_SIZE + payload_size + SLOT_SUFFIX_SIZE;
+    if ((_data == nullptr) || (size > _size / 2u)) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_cursor + size > _size) {
+        _cursor = 0u;
+      }
+      offset = _cursor;
+      sequence = ++_sequence;
+      // Keep the slots aligned for the client to read them as arrays.
+      _cursor += (size + 15u) & ~uint64_t(15u);
+    }
+    unsigned char *slot = _data + offset;
+    // A reader that sees the sequence after the payload sees the whole slot.
+    std::memcpy(slot, &sequence, sizeof(uint64_t));
+    std::memcpy(slot + sizeof(uint64_t), &payload_size, sizeof(uint64_t));
+    std::memcpy(slot + SLOT_PREFIX_SIZE, header, header_size);
+    std::memcpy(slot + SLOT_PREFIX_SIZE + header_size, data, data_size);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(slot + SLOT_PREFIX_SIZE + payload_size, &sequence, sizeof(uint64_t));
+    return true;
+  }
+
+  bool SharedMemoryRing::IsSlotValid(
+      const unsigned char *region,
+      const uint64_t region_size,
+      const uint64_t offset,
+      const uint32_t size,
+      const uint64_t sequence) {
+    const uint64_t slot_size = SLOT_PREFIX_SIZE + size + SLOT_SUFFIX_SIZE;
+    if ((region == nullptr) || (offset > region_size) || (slot_size > region_size - offset)) {
+      return false;
+    }
+    uint64_t after;
+    std::memcpy(&after, region + offset + SLOT_PREFIX_SIZE + size, sizeof(uint64_t));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t before;
+    std::memcpy(&before, region + offset, sizeof(uint64_t));
+    return (before == sequence) && (after == sequence);
+  }
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace carla {
+namespace server {
+
+  /// A ring buffer in a named POSIX shared memory region, for passing sensor
+  /// data to a client in the same host without copying it through a socket.
+  ///
+  /// Writers allocate consecutive slots of the region wrapping around at the
+  /// end, old data is overwritten without checking whether the client is done
+  /// with it. The region must be big enough to hold a few frames of data.
+  ///
+  /// Each slot is laid out as
+  ///
+  ///     [sequence (uint64), size (uint64), header + data, sequence (uint64)]
+  ///
+  /// with a sequence number unique to the slot, written before and after
+  /// the payload. A client that lags behind detects that its slot was
+  /// overwritten because either sequence no longer matches the one it was
+  /// given.
+  ///
+  /// Only supported on Linux, elsewhere the region is never valid.
+  class SharedMemoryRing : private NonCopyable {
+  public:
+
+    /// Create the region @a name (e.g. "/carla-server-2001") of @a size bytes,
+    /// the region is removed on destruction.
+    SharedMemoryRing(std::string name, uint64_t size);
+
+    ~SharedMemoryRing();
+
+    /// Whether the region was successfully created.
+    bool IsValid() const {
+      return _data != nullptr;
+    }
+
+    const std::string &name() const {
+      return _name;
+    }
+
+    uint64_t size() const {
+      return _size;
+    }
+
+    const unsigned char *data() const {
+      return _data;
+    }
+
+    /// Bytes before the payload of a slot, the sequence and the size.
+    static constexpr uint64_t SLOT_PREFIX_SIZE = 2u * sizeof(uint64_t);
+
+    /// Bytes after the payload of a slot, the sequence again.
+    static constexpr uint64_t SLOT_SUFFIX_SIZE = sizeof(uint64_t);
+
+    /// Copy @a header followed by @a data into the next slot of the region,
+    /// set @a offset to the position of the slot and @a sequence to its
+    /// sequence number. Returns false, without writing anything, if it does
+    /// not fit in half the region. Thread-safe.
+    bool Write(
+        const unsigned char *header,
+        uint32_t header_size,
+        const unsigned char *data,
+        uint32_t data_size,
+        uint64_t &offset,
+        uint64_t &sequence);
+
+    /// Whether the slot at @a offset of @a region still holds the payload of
+    /// @a size bytes written with @a sequence.
+    static bool IsSlotValid(
+        const unsigned char *region,
+        uint64_t region_size,
+        uint64_t offset,
+        uint32_t size,
+        uint64_t sequence);
+
+  private:
+
+    const std::string _name;
+
+    uint64_t _size = 0u;
+
+    unsigned char *_data = nullptr;
+
+    std::mutex _mutex;
+
+    uint64_t _cursor = 0u;
+
+    /// Sequence of the last slot written, the region starts zeroed so zero is
+    /// never valid.
+    uint64_t _sequence = 0u;
+  };
+
+} // namespace server
+} // namespace carla
@@ -13,41 +13,22 @@
 
 #include "carla/server/TCPServer.h"
 
-#include <boost/asio/read.hpp>
-#include <boost/asio/write.hpp>
-#include <boost/lambda/bind.hpp>
-#include <boost/lambda/lambda.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/system/system_error.hpp>
 
 #include "carla/Logging.h"
+#include "carla/Tracer.h"
+
+#include <cstdio>
 
-using boost::lambda::_1;
-using boost::lambda::var;
 using namespace boost::asio::ip;
 
 namespace carla {
 namespace server {
 
-  // ===========================================================================
-  // -- Static local methods ---------------------------------------------------
-  // ===========================================================================
-
-  static inline int GetPort(const tcp::socket &socket) {
-    return (socket.is_open() ? socket.local_endpoint().port() : 0);
-  }
-
-#define LOG_PREFIX "tcpserver", GetPort(_socket), ':'
-
-  static void CloseConnection(tcp::acceptor &_acceptor, tcp::socket &_socket) {
-    log_info(LOG_PREFIX, "disconnecting");
-    if (_acceptor.is_open()) {
-      _acceptor.close();
-    }
-    if (_socket.is_open()) {
-      _socket.close();
-    }
-  }
+#define LOG_PREFIX "tcpserver", _port, ':'
 
   // ===========================================================================
   // -- TCPServer --------------------------------------------------------------
@@ -55,38 +36,47 @@ namespace server {
 
   TCPServer::TCPServer()
       : _service(),
+        _work(_service),
         _acceptor(_service),
         _socket(_service),
-        _deadline(_service) {
-    // No deadline is required until the first socket operation is started. We
-    // set the deadline to positive infinity so that the actor takes no action
-    // until a specific deadline is set.
-    _deadline.expires_at(boost::posix_time::pos_infin);
-    // Start the persistent actor that checks for deadline expiry.
-    CheckDeadline();
-  }
+        _read_timeout(_service, [this]() { OnTimeout(); }),
+        _write_timeout(_service, [this]() { OnTimeout(); }) {}
 
   TCPServer::~TCPServer() {
-    CloseConnection(_acceptor, _socket);
+    CloseConnection();
   }
 
   void TCPServer::Disconnect() {
     log_debug(LOG_PREFIX, "request close connection");
-    _service.post([this](){ CloseConnection(_acceptor, _socket); });
+    _service.post([this](){ CloseConnection(); });
   }
 
   error_code TCPServer::Connect(uint32_t port, time_duration timeout) {
-    // Set the deadline, it will close the socket when expired.
-    _deadline.expires_from_now(timeout);
-
     if (_acceptor.is_open()) {
       log_error(LOG_PREFIX, "already connected");
       return boost::asio::error::already_connected;
     }
 
-    // Create an acceptor at the given port.
+    _port = port;
+
+    // Create an acceptor at the given port, or its Unix socket.
     try {
-      _acceptor = tcp::acceptor(_service, tcp::endpoint(tcp::v4(), port));
+      if (_unix_socket_path.empty()) {
+        const protocol_type::endpoint endpoint = tcp::endpoint(tcp::v4(), port);
+        _acceptor = decltype(_acceptor)(_service, endpoint);
+      } else {
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+        _socket_file = _unix_socket_path + '-' + std::to_string(port);
+        // Remove the file left by a previous connection or process.
+        std::remove(_socket_file.c_str());
+        const protocol_type::endpoint endpoint =
+            boost::asio::local::stream_protocol::endpoint(_socket_file);
+        _acceptor = decltype(_acceptor)(_service, endpoint);
+#else
+        log_error(LOG_PREFIX, "Unix domain sockets not supported on this platform");
+        return boost::asio::error::operation_not_supported;
+#endif // BOOST_ASIO_HAS_LOCAL_SOCKETS
+      }
     } catch (const boost::system::system_error &exception) {
       log_error(LOG_PREFIX, "unable to accept connection:", exception.what());
       return exception.code();
@@ -96,13 +86,16 @@ namespace server {
     // would_block, so any other value in ec indicates completion.
     error_code ec = boost::asio::error::would_block;
 
-    // Start the asynchronous operation.
-    _acceptor.async_accept(_socket, var(ec) = _1);
+    // Start the asynchronous operation, the connection is closed if the
+    // time-out expires.
+    _read_timeout.Arm(timeout);
+    _acceptor.async_accept(_socket, [this, &ec](const error_code &result) {
+      _read_timeout.Disarm();
+      ec = result;
+    });
 
     // Block until the asynchronous operation has completed.
-    do {
-      _service.run_one();
-    } while (ec == boost::asio::error::would_block);
+    RunUntilCompleted(ec);
 
     // Determine whether a connection was successfully established.
     if (ec) {
@@ -110,21 +103,21 @@ namespace server {
       Disconnect(); // Will disconnect on the next run.
     } else {
       log_info(LOG_PREFIX, "connected");
+      // Synchronous writes fail with would_block instead of blocking, see
+      // WriteBuffers.
+      _socket.non_blocking(true, ec);
     }
     return ec;
   }
 
   error_code TCPServer::Read(mutable_buffer buffer, time_duration timeout) {
+    CARLA_TRACE_SCOPE(TCPServer, Read);
     log_debug(LOG_PREFIX, "receiving to buffer of length", boost::asio::buffer_size(buffer));
-    _deadline.expires_from_now(timeout);
-
     error_code ec = boost::asio::error::would_block;
-    boost::asio::async_read(_socket, boost::asio::buffer(buffer), var(ec) = _1);
-
-    do {
-      _service.run_one();
-    } while (ec == boost::asio::error::would_block);
-
+    AsyncRead(boost::asio::buffer(buffer), timeout, [&ec](const error_code &result) {
+      ec = result;
+    });
+    RunUntilCompleted(ec);
     if (ec) {
       log_error(LOG_PREFIX, "error reading message:", ec.message());
     }
@@ -133,28 +126,67 @@ namespace server {
 
   error_code TCPServer::Write(const_buffer buffer, time_duration timeout) {
     log_debug(LOG_PREFIX, "sending from buffer of length", boost::asio::buffer_size(buffer));
-    _deadline.expires_from_now(timeout);
-
-    error_code ec = boost::asio::error::would_block;
-    boost::asio::async_write(_socket, boost::asio::buffer(buffer), var(ec) = _1);
+    return WriteBuffers(boost::asio::buffer(buffer), timeout);
+  }
 
-    do {
-      _service.run_one();
-    } while (ec == boost::asio::error::would_block);
+  error_code TCPServer::Write(const std::vector<const_buffer> &buffers, time_duration timeout) {
+    log_debug(LOG_PREFIX, "sending", buffers.size(), "buffers of total length", boost::asio::buffer_size(buffers));
+    return WriteBuffers(buffers, timeout);
+  }
 
+  template <typename ConstBufferSequence>
+  error_code TCPServer::WriteBuffers(const ConstBufferSequence &buffers, time_duration timeout) {
+    CARLA_TRACE_SCOPE(TCPServer, Write);
+    // Most writes fit in the socket's send buffer, try first to write without
+    // involving the io_service.
+    error_code ec;
+    size_t written = boost::asio::write(_socket, buffers, ec);
+    if (ec == boost::asio::error::would_block) {
+      // Wait for the socket to be ready to write the rest.
+      std::vector<const_buffer> remaining;
+      for (const_buffer buffer : buffers) {
+        const auto size = boost::asio::buffer_size(buffer);
+        if (written >= size) {
+          written -= size;
+        } else {
+          remaining.push_back(buffer + written);
+          written = 0u;
+        }
+      }
+      AsyncWrite(remaining, timeout, [&ec](const error_code &result) {
+        ec = result;
+      });
+      RunUntilCompleted(ec);
+    }
     if (ec) {
       log_error(LOG_PREFIX, "error writing message:", ec.message());
     }
     return ec;
   }
 
-  void TCPServer::CheckDeadline() {
-    if (_deadline.expires_at() <= boost::asio::deadline_timer::traits_type::now()) {
-      log_info(LOG_PREFIX, "timed out");
-      CloseConnection(_acceptor, _socket);
-      _deadline.expires_at(boost::posix_time::pos_infin);
+  void TCPServer::RunUntilCompleted(const error_code &ec) {
+    do {
+      _service.run_one();
+    } while (ec == boost::asio::error::would_block);
+  }
+
+  void TCPServer::OnTimeout() {
+    log_info(LOG_PREFIX, "timed out");
+    CloseConnection();
+  }
+
+  void TCPServer::CloseConnection() {
+    log_info(LOG_PREFIX, "disconnecting");
+    if (_acceptor.is_open()) {
+      _acceptor.close();
+    }
+    if (_socket.is_open()) {
+      _socket.close();
+    }
+    if (!_socket_file.empty()) {
+      std::remove(_socket_file.c_str());
+      _socket_file.clear();
     }
-    _deadline.async_wait(boost::lambda::bind(&TCPServer::CheckDeadline, this));
   }
 
 #undef LOG_PREFIX
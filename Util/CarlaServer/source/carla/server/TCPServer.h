@@ -6,18 +6,34 @@
 
 #pragma once
 
-#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/generic/stream_protocol.hpp>
 #include <boost/asio/io_service.hpp>
-#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
 
 #include "carla/NonCopyable.h"
 #include "carla/server/ServerTraits.h"
+#include "carla/server/TimerWheel.h"
+
+#include <string>
+#include <vector>
 
 namespace carla {
 namespace server {
 
-  /// Basic blocking TCP server with time-out. It is safe to call disconnect
-  /// in a separate thread.
+  /// Stream server with time-out. It is safe to call disconnect in a
+  /// separate thread.
+  ///
+  /// Operations are asynchronous, their handlers are called by the thread
+  /// running the server's io_service. The blocking Read and Write run it
+  /// until their own operation completes. A read and a write can be in
+  /// flight at the same time, each with its own time-out; time-outs are
+  /// kept in the process-wide TimerWheel, so they cost no system calls.
+  ///
+  /// By default the server listens at a TCP port. If a Unix socket path is
+  /// set, it listens instead at the Unix domain socket "<path>-<port>", so
+  /// the port still identifies the channel.
   class TCPServer : private NonCopyable {
   public:
 
@@ -25,6 +41,12 @@ namespace server {
 
     ~TCPServer();
 
+    /// Listen at Unix domain sockets based on @a path from the next Connect
+    /// on, empty to use TCP. Not thread-safe, see AsyncServer.
+    void SetUnixSocketPath(std::string path) {
+      _unix_socket_path = std::move(path);
+    }
+
     /// Posts a job to disconnect the server.
     void Disconnect();
 
@@ -34,18 +56,90 @@ namespace server {
 
     error_code Write(const_buffer buffer, time_duration timeout);
 
+    /// Write every buffer of @a buffers with a single operation.
+    error_code Write(const std::vector<const_buffer> &buffers, time_duration timeout);
+
+    /// Read into @a buffers, @a handler is called with the error code on
+    /// completion. The connection is closed if it does not complete within
+    /// @a timeout.
+    template <typename MutableBufferSequence, typename Handler>
+    void AsyncRead(const MutableBufferSequence &buffers, time_duration timeout, Handler &&handler);
+
+    /// Write @a buffers, @a handler is called with the error code on
+    /// completion. The connection is closed if it does not complete within
+    /// @a timeout.
+    template <typename ConstBufferSequence, typename Handler>
+    void AsyncWrite(const ConstBufferSequence &buffers, time_duration timeout, Handler &&handler);
+
   private:
 
-    void CheckDeadline();
+    using protocol_type = boost::asio::generic::stream_protocol;
+
+    template <typename ConstBufferSequence>
+    error_code WriteBuffers(const ConstBufferSequence &buffers, time_duration timeout);
+
+    /// Run the io_service until @a ec is set by the handler of an operation.
+    void RunUntilCompleted(const error_code &ec);
+
+    void CloseConnection();
+
+    void OnTimeout();
 
     boost::asio::io_service _service;
 
-    boost::asio::ip::tcp::acceptor _acceptor;
+    boost::asio::io_service::work _work;
+
+    boost::asio::basic_socket_acceptor<protocol_type> _acceptor;
+
+    protocol_type::socket _socket;
+
+    /// Used by Connect and Read.
+    TimerWheel::Timeout _read_timeout;
 
-    boost::asio::ip::tcp::socket _socket;
+    TimerWheel::Timeout _write_timeout;
 
-    boost::asio::deadline_timer _deadline;
+    std::string _unix_socket_path;
+
+    /// Port of the current connection, for logging.
+    uint32_t _port = 0u;
+
+    /// Unix socket the current connection is listening at, empty if TCP.
+    std::string _socket_file;
   };
 
+  // ===========================================================================
+  // -- TCPServer implementation -----------------------------------------------
+  // ===========================================================================
+
+  template <typename MutableBufferSequence, typename Handler>
+  void TCPServer::AsyncRead(
+      const MutableBufferSequence &buffers,
+      const time_duration timeout,
+      Handler &&handler) {
+    _read_timeout.Arm(timeout);
+    boost::asio::async_read(
+        _socket,
+        buffers,
+        [this, handler{std::forward<Handler>(handler)}](const error_code &ec, size_t) mutable {
+          _read_timeout.Disarm();
+          handler(ec);
+        });
+  }
+
+  template <typename ConstBufferSequence, typename Handler>
+  void TCPServer::AsyncWrite(
+      const ConstBufferSequence &buffers,
+      const time_duration timeout,
+      Handler &&handler) {
+    _write_timeout.Arm(timeout);
+    boost::asio::async_write(
+        _socket,
+        buffers,
+        [this, handler{std::forward<Handler>(handler)}](const error_code &ec, size_t) mutable {
+          _write_timeout.Disarm();
+          handler(ec);
+        });
+  }
+
 } // namespace server
 } // namespace carla
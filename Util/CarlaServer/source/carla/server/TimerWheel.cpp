@@ -0,0 +1,203 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/server/TimerWheel.h"
+
+#include <limits>
+
+namespace carla {
+namespace server {
+
+namespace detail {
+
+  static constexpr uint64_t NO_TICK = std::numeric_limits<uint64_t>::max();
+
+  struct TimeoutState {
+    TimeoutState(boost::asio::io_service &service, std::function<void()> on_expired)
+      : service(&service),
+        on_expired(std::move(on_expired)) {}
+
+    std::mutex mutex;
+
+    /// Null once the owner Timeout is destroyed.
+    boost::asio::io_service *service;
+
+    std::function<void()> on_expired;
+
+    /// Tick at which the armed time-out expires, NO_TICK if disarmed.
+    uint64_t deadline = NO_TICK;
+
+    /// Tick of the entry in the wheel, NO_TICK if none.
+    uint64_t scheduled = NO_TICK;
+
+    /// Incremented every time the time-out is armed or disarmed, so expired
+    /// handlers of previous operations are ignored.
+    std::atomic<uint64_t> generation{0u};
+  };
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- TimerWheel::Timeout ----------------------------------------------------
+  // ===========================================================================
+
+  TimerWheel::Timeout::Timeout(
+      boost::asio::io_service &service,
+      std::function<void()> on_expired)
+    : _state(std::make_shared<detail::TimeoutState>(service, std::move(on_expired))) {}
+
+  TimerWheel::Timeout::~Timeout() {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    _state->service = nullptr;
+    _state->deadline = detail::NO_TICK;
+  }
+
+  void TimerWheel::Timeout::Arm(const time_duration timeout) {
+    if (timeout.is_special()) {
+      Disarm();
+      return;
+    }
+    auto &wheel = TimerWheel::Get();
+    const auto deadline = wheel.ToTick(
+        clock_type::now() + std::chrono::microseconds(timeout.total_microseconds()));
+    bool schedule = false;
+    {
+      std::lock_guard<std::mutex> lock(_state->mutex);
+      ++_state->generation;
+      _state->deadline = deadline;
+      // The entry in the wheel is reused if it expires before the new
+      // deadline, it is then rescheduled.
+      if (deadline < _state->scheduled) {
+        _state->scheduled = deadline;
+        schedule = true;
+      }
+    }
+    if (schedule) {
+      wheel.Schedule(_state, deadline);
+    }
+  }
+
+  void TimerWheel::Timeout::Disarm() {
+    std::lock_guard<std::mutex> lock(_state->mutex);
+    ++_state->generation;
+    _state->deadline = detail::NO_TICK;
+  }
+
+  // ===========================================================================
+  // -- TimerWheel -------------------------------------------------------------
+  // ===========================================================================
+
+  TimerWheel &TimerWheel::Get() {
+    static TimerWheel wheel;
+    return wheel;
+  }
+
+  TimerWheel::TimerWheel(
+      const std::chrono::milliseconds resolution,
+      const size_t number_of_slots)
+    : _resolution(resolution),
+      _start(clock_type::now()),
+      _slots(number_of_slots) {
+    _thread = std::thread([this]() { Run(); });
+  }
+
+  TimerWheel::~TimerWheel() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _done = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+  }
+
+  TimerWheel::tick_type TimerWheel::ToTick(const clock_type::time_point time_point) const {
+    // Round up, a time-out never expires early.
+    const auto elapsed = time_point - _start;
+    return static_cast<tick_type>((elapsed + _resolution - clock_type::duration(1)) / _resolution);
+  }
+
+  void TimerWheel::Schedule(std::shared_ptr<detail::TimeoutState> state, const tick_type tick) {
+    bool was_empty;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      was_empty = (_number_of_entries == 0u);
+      _slots[tick % _slots.size()].push_back({std::move(state), tick});
+      ++_number_of_entries;
+    }
+    // The thread only needs to be woken up if it is waiting for entries.
+    if (was_empty) {
+      _condition.notify_one();
+    }
+  }
+
+  void TimerWheel::Run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _current_tick = ToTick(clock_type::now());
+    while (!_done) {
+      if (_number_of_entries == 0u) {
+        _condition.wait(lock, [this]() { return _done || (_number_of_entries > 0u); });
+        // Skip the ticks spent idle, there was nothing to expire.
+        _current_tick = std::max(_current_tick, ToTick(clock_type::now()));
+        continue;
+      }
+      const auto now = ToTick(clock_type::now());
+      if (_current_tick > now) {
+        _condition.wait_until(lock, _start + _current_tick * _resolution);
+        continue;
+      }
+      auto &slot = _slots[_current_tick % _slots.size()];
+      std::vector<Entry> entries;
+      entries.swap(slot);
+      _number_of_entries -= entries.size();
+      const auto tick = _current_tick++;
+      lock.unlock();
+      auto rescheduled = Process(entries, tick);
+      lock.lock();
+      for (auto &entry : rescheduled) {
+        _slots[entry.tick % _slots.size()].push_back(std::move(entry));
+        ++_number_of_entries;
+      }
+    }
+  }
+
+  std::vector<TimerWheel::Entry> TimerWheel::Process(
+      std::vector<Entry> &entries,
+      const tick_type tick) {
+    std::vector<Entry> rescheduled;
+    for (auto &entry : entries) {
+      if (entry.tick > tick) {
+        // Not in this round of the wheel.
+        rescheduled.push_back(std::move(entry));
+        continue;
+      }
+      auto &state = *entry.state;
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (state.scheduled != entry.tick) {
+        // Replaced by an earlier entry.
+        continue;
+      }
+      if ((state.deadline == detail::NO_TICK) || (state.service == nullptr)) {
+        state.scheduled = detail::NO_TICK;
+      } else if (state.deadline > tick) {
+        // Re-armed since scheduled.
+        state.scheduled = state.deadline;
+        rescheduled.push_back({entry.state, state.deadline});
+      } else {
+        state.scheduled = detail::NO_TICK;
+        state.deadline = detail::NO_TICK;
+        const uint64_t generation = state.generation;
+        state.service->post([state = entry.state, generation]() {
+          if (state->generation == generation) {
+            state->on_expired();
+          }
+        });
+      }
+    }
+    return rescheduled;
+  }
+
+} // namespace server
+} // namespace carla
@@ -0,0 +1,115 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+
+#include "carla/NonCopyable.h"
+#include "carla/server/ServerTraits.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace server {
+
+namespace detail {
+
+  struct TimeoutState;
+
+} // namespace detail
+
+  /// Time-outs of the network operations, shared by every server of the
+  /// process.
+  ///
+  /// A single thread advances the wheel every few milliseconds and expires
+  /// the time-outs that were not disarmed. Arming and disarming a time-out
+  /// only stores its deadline, no timer is scheduled or cancelled per
+  /// operation, so the threads doing the operations make no extra system
+  /// calls. Expiring a time-out is precise to the resolution of the wheel.
+  class TimerWheel : private NonCopyable {
+  public:
+
+    using clock_type = std::chrono::steady_clock;
+
+    /// Reusable time-out of a sequence of operations, at most one armed at a
+    /// time. Destroy before the io_service it posts to.
+    class Timeout : private NonCopyable {
+    public:
+
+      /// When an armed time-out expires, @a on_expired is posted to
+      /// @a service. It is not called if the time-out is disarmed or re-armed
+      /// before the handler runs.
+      Timeout(boost::asio::io_service &service, std::function<void()> on_expired);
+
+      ~Timeout();
+
+      /// Infinite time-outs never expire.
+      void Arm(time_duration timeout);
+
+      void Disarm();
+
+    private:
+
+      std::shared_ptr<detail::TimeoutState> _state;
+    };
+
+    /// Wheel shared by every server of the process.
+    static TimerWheel &Get();
+
+    explicit TimerWheel(
+        std::chrono::milliseconds resolution = std::chrono::milliseconds(10),
+        size_t number_of_slots = 256u);
+
+    ~TimerWheel();
+
+  private:
+
+    using tick_type = uint64_t;
+
+    struct Entry {
+      std::shared_ptr<detail::TimeoutState> state;
+      tick_type tick;
+    };
+
+    tick_type ToTick(clock_type::time_point time_point) const;
+
+    void Schedule(std::shared_ptr<detail::TimeoutState> state, tick_type tick);
+
+    void Run();
+
+    /// Expire or reschedule the time-outs of @a entries, returns the entries
+    /// to be rescheduled.
+    std::vector<Entry> Process(std::vector<Entry> &entries, tick_type tick);
+
+    const std::chrono::milliseconds _resolution;
+
+    const clock_type::time_point _start;
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    std::vector<std::vector<Entry>> _slots;
+
+    size_t _number_of_entries = 0u;
+
+    tick_type _current_tick = 0u;
+
+    bool _done = false;
+
+    std::thread _thread;
+  };
+
+} // namespace server
+} // namespace carla
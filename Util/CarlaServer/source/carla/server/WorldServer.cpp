@@ -9,6 +9,10 @@
 #include "carla/Debug.h"
 #include "carla/server/AgentServer.h"
 
+#include <mutex>
+#include <set>
+#include <vector>
+
 namespace carla {
 namespace server {
 
@@ -28,6 +32,38 @@ namespace server {
     return promise.get_future();
   }
 
+  /// Ports bound by the world servers of this process.
+  static struct {
+    std::mutex mutex;
+    std::set<uint32_t> ports;
+  } PORTS_IN_USE;
+
+  /// Ports of a session, world, world + 1 and world + 2.
+  static std::vector<uint32_t> GetSessionPorts(const uint32_t port) {
+    return {port, port + 1u, port + 2u};
+  }
+
+  /// Reserve @a ports for a session, fails if any of them is already used by
+  /// a session of this process.
+  static bool ReservePorts(const std::vector<uint32_t> &ports) {
+    std::lock_guard<std::mutex> lock(PORTS_IN_USE.mutex);
+    for (auto port : ports) {
+      if (PORTS_IN_USE.ports.count(port) > 0u) {
+        log_error("port", port, "is already used by a session");
+        return false;
+      }
+    }
+    PORTS_IN_USE.ports.insert(ports.begin(), ports.end());
+    return true;
+  }
+
+  static void ReleasePorts(const std::vector<uint32_t> &ports) {
+    std::lock_guard<std::mutex> lock(PORTS_IN_USE.mutex);
+    for (auto port : ports) {
+      PORTS_IN_USE.ports.erase(port);
+    }
+  }
+
   template <typename T>
   static error_code TryRead(ReadTask<T> &task, T &value, timeout_t timeout) {
     DEBUG_ASSERT(task.valid());
@@ -64,7 +100,14 @@ namespace server {
       : _encoder(),
         _world_server(_encoder) {}
 
-  WorldServer::~WorldServer() {}
+  WorldServer::~WorldServer() {
+    if (_port != 0u) {
+      ReleasePorts(GetSessionPorts(_port));
+    }
+    if (_observer_port != 0u) {
+      ReleasePorts({_observer_port});
+    }
+  }
 
   std::future<error_code> WorldServer::Connect(
       const uint32_t port,
@@ -72,6 +115,14 @@ namespace server {
     if (!IsPortValid(port)) {
       return GetInvalidPortResult(port);
     }
+    if (_port != port) {
+      if (!ReservePorts(GetSessionPorts(port))) {
+        return GetInvalidPortResult(port);
+      }
+      if (_port != 0u) {
+        ReleasePorts(GetSessionPorts(_port));
+      }
+    }
     _port = port;
     _timeout = timeout;
     auto result = _world_server.Connect(_port, _timeout);
@@ -96,7 +147,14 @@ namespace server {
         scene_description.sensors,
         scene_description.sensors + scene_description.number_of_sensors);
     _sensor_definitions = std::move(defs);
-    CarlaSceneDescription scene(_encoder.Encode(scene_description));
+    auto encoded_scene = _encoder.Encode(scene_description);
+    if (_observer_port != 0u) {
+      _encoded_scene = encoded_scene;
+    }
+    if (_recorder != nullptr) {
+      _recorder->Write(recording::SCENE_DESCRIPTION, 0u, encoded_scene);
+    }
+    CarlaSceneDescription scene(std::move(encoded_scene));
     return carla::server::Write(_protocol.scene_description, std::move(scene));
   }
 
@@ -112,19 +170,54 @@ namespace server {
   }
 
   void WorldServer::StartAgentServer() {
-    _agent_server = std::make_unique<AgentServer>(
+    auto agent_server = std::make_shared<AgentServer>(
         _encoder,
         _port + 1u,
         _port + 2u,
         _sensor_definitions,
-        _timeout);
+        _timeout,
+        _observer_port,
+        _encoded_scene,
+        _shared_memory_size,
+        _unix_socket_path,
+        _recorder);
+    std::atomic_store(&_agent_server, std::move(agent_server));
   }
 
   void WorldServer::KillAgentServer() {
-    _agent_server = nullptr;
+    std::atomic_store(&_agent_server, std::shared_ptr<AgentServer>());
     _sensor_definitions.clear();
   }
 
+  error_code WorldServer::SetObserverPort(const uint32_t port) {
+    if (port == _observer_port) {
+      return errc::success();
+    }
+    if ((port != 0u) && (!IsPortValid(port) || !ReservePorts({port}))) {
+      log_error("invalid observer port", port);
+      return errc::invalid_argument();
+    }
+    if (_observer_port != 0u) {
+      ReleasePorts({_observer_port});
+    }
+    _observer_port = port;
+    return errc::success();
+  }
+
+  error_code WorldServer::SetRecordingFile(const std::string &path) {
+    // The current agent server keeps the previous recorder, if any, until the
+    // episode ends.
+    _recorder = nullptr;
+    if (!path.empty()) {
+      auto recorder = std::make_shared<Recorder>(path);
+      if (!recorder->IsValid()) {
+        return errc::invalid_argument();
+      }
+      _recorder = std::move(recorder);
+    }
+    return errc::success();
+  }
+
   void WorldServer::ResetProtocol() {
     Protocol protocol(_timeout);
     // Here we need to wait forever for the new episode, as it will take as long
@@ -11,9 +11,12 @@
 #include "carla/server/CarlaEncoder.h"
 #include "carla/server/CarlaSceneDescription.h"
 #include "carla/server/EncoderServer.h"
+#include "carla/server/Recorder.h"
 #include "carla/server/RequestNewEpisode.h"
 #include "carla/server/TCPServer.h"
 
+#include <memory>
+
 namespace carla {
 namespace server {
 
@@ -45,14 +48,39 @@ namespace server {
     /// control.
     void StartAgentServer();
 
-    AgentServer *GetAgentServer() {
-      return _agent_server.get();
+    /// The agent server of the current episode, or null. Other threads may
+    /// still be using it when it is killed, so it is destroyed once the last
+    /// of them is done with it.
+    std::shared_ptr<AgentServer> GetAgentServer() const {
+      return std::atomic_load(&_agent_server);
     }
 
     void KillAgentServer();
 
     void ResetProtocol();
 
+    /// Port to accept read-only observers during the episodes, zero to
+    /// disable. Applies from the next episode on. Fails if the port is used
+    /// by a session of this process.
+    error_code SetObserverPort(uint32_t port);
+
+    /// Listen at the Unix domain sockets "<path>-<port>" instead of the TCP
+    /// ports, empty to use TCP (default). Must be set before connecting.
+    void SetUnixSocketPath(std::string path) {
+      _unix_socket_path = path;
+      _world_server.SetUnixSocketPath(std::move(path));
+    }
+
+    /// Size in bytes of the shared memory region for the sensor data, zero to
+    /// send it through the socket. Applies from the next episode on.
+    void SetSharedMemorySize(uint64_t size) {
+      _shared_memory_size = size;
+    }
+
+    /// Record the episodes to the file at @a path, see Recorder. Empty to stop
+    /// recording. Applies from the next episode on.
+    error_code SetRecordingFile(const std::string &path);
+
   private:
 
     struct Protocol {
@@ -67,7 +95,8 @@ namespace server {
 
     void ExecuteProtocol(Protocol &&protocol);
 
-    uint32_t _port;
+    /// World port, zero if not connected yet.
+    uint32_t _port = 0u;
 
     time_duration _timeout;
 
@@ -79,7 +108,18 @@ namespace server {
 
     std::vector<carla_sensor_definition> _sensor_definitions;
 
-    std::unique_ptr<AgentServer> _agent_server;
+    uint32_t _observer_port = 0u;
+
+    /// Scene description of the current episode, sent to the observers.
+    std::string _encoded_scene;
+
+    uint64_t _shared_memory_size = 0u;
+
+    std::string _unix_socket_path;
+
+    std::shared_ptr<Recorder> _recorder;
+
+    std::shared_ptr<AgentServer> _agent_server;
 
     RequestNewEpisode _new_episode_data;
   };
@@ -0,0 +1,94 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+// Streams a session recording (see carla_server_set_recording_file) to a
+// client as fast as it reads it, without the simulator. Every new episode the
+// client requests plays the next recorded episode.
+
+#include "carla/Logging.h"
+#include "carla/server/Recording.h"
+#include "carla/server/ReplayServer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace carla::server;
+
+struct Options {
+  std::string path;
+  uint32_t port = 2000u;
+  uint32_t timeout = 10u * 1000u;
+  bool loop = false;
+};
+
+static void PrintUsage(const char *program) {
+  const Options defaults;
+  std::cout
+      << "Usage: " << program << " [options] RECORDING\n"
+      << "  --port=N     world port, the next two are used too (default " << defaults.port << ")\n"
+      << "  --timeout=N  time-out in milliseconds (default " << defaults.timeout << ")\n"
+      << "  --loop       start again from the first episode after the last one\n";
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options) {
+  for (auto i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto equal = arg.find('=');
+    const auto name = arg.substr(0u, equal);
+    const auto value = (equal != std::string::npos ? arg.substr(equal + 1u) : "");
+    const auto number = [&]() { return static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)); };
+    if (name == "--port") {
+      options.port = number();
+    } else if (name == "--timeout") {
+      options.timeout = number();
+    } else if (name == "--loop") {
+      options.loop = true;
+    } else if ((arg.compare(0u, 2u, "--") != 0) && options.path.empty()) {
+      options.path = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options.path.empty();
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  Recording recording;
+  if (recording.Open(options.path)) {
+    std::cerr << "replay: unable to read " << options.path << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto number_of_episodes = recording.episodes().size();
+  std::cout << options.path << ": " << number_of_episodes << " episodes, "
+            << recording.entries().size() << " records" << std::endl;
+  if (number_of_episodes == 0u) {
+    return EXIT_FAILURE;
+  }
+
+  ReplayServer server(recording, boost::posix_time::milliseconds(options.timeout));
+  std::cout << "Waiting for the client at port " << options.port << "..." << std::endl;
+  if (server.Connect(options.port)) {
+    std::cerr << "replay: no client connected" << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (auto episode = 0u; options.loop || (episode < number_of_episodes); ++episode) {
+    const auto index = episode % number_of_episodes;
+    if (server.PlayEpisode(index)) {
+      std::cerr << "replay: episode " << index << " failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Episode " << index << ": " << server.GetNumberOfFramesSent()
+              << " frames sent" << std::endl;
+  }
+  carla::logging::Flush();
+  return EXIT_SUCCESS;
+}
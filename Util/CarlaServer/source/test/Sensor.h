@@ -22,6 +22,11 @@ namespace test {
       return _definition.id;
     }
 
+    /// Frame number of the last data made.
+    uint64_t frame_number() const {
+      return _frame_number;
+    }
+
     const carla_sensor_definition &definition() const {
       return _definition;
     }
@@ -0,0 +1,223 @@
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <carla/carla_client.h>
+#include <carla/carla_server.h>
+#include <carla/server/Recording.h>
+#include <carla/server/ReplayServer.h>
+
+static constexpr uint32_t TIMEOUT = 6u * 1000u;
+static constexpr uint32_t NUMBER_OF_FRAMES = 20u;
+static constexpr uint32_t NUMBER_OF_AGENTS = 30u;
+static constexpr uint32_t IMAGE_SIZE = 300u * 200u * 4u;
+
+static const char *INI_FILE = "[CARLA/Server]\nSynchronousMode=true\n";
+
+struct ImageHeader {
+  uint64_t frame_number;
+  uint32_t width;
+  uint32_t height;
+  uint32_t type;
+  float fov;
+};
+
+static unsigned char Pattern(const uint32_t frame, const uint32_t i) {
+  return static_cast<unsigned char>((frame + i) % 251u);
+}
+
+static auto make_server() {
+  return std::unique_ptr<void, void(*)(void *)>(carla_make_server(), carla_free_server);
+}
+
+static auto make_client() {
+  return std::unique_ptr<void, void(*)(void *)>(carla_make_client(), carla_free_client);
+}
+
+/// Plays the role of the game, one episode of NUMBER_OF_FRAMES frames with a
+/// camera.
+static void RunServer(CarlaServerPtr server, const uint32_t port) {
+  const auto S = CARLA_SERVER_SUCCESS;
+  ASSERT_EQ(S, carla_server_connect(server, port, TIMEOUT));
+  {
+    carla_request_new_episode values;
+    ASSERT_EQ(S, carla_read_request_new_episode(server, values, TIMEOUT));
+    ASSERT_EQ(std::string(INI_FILE), std::string(values.ini_file, values.ini_file_length));
+  }
+  {
+    const carla_transform start_spots[2u] = {};
+    const carla_sensor_definition sensors[1u] = {{7u, CARLA_SERVER_CAMERA, "Camera"}};
+    const carla_scene_description values{"TestTown", start_spots, 2u, sensors, 1u};
+    ASSERT_EQ(S, carla_write_scene_description(server, values, TIMEOUT));
+  }
+  {
+    carla_episode_start values;
+    ASSERT_EQ(S, carla_read_episode_start(server, values, TIMEOUT));
+    ASSERT_EQ(1u, values.player_start_spot_index);
+  }
+  ASSERT_EQ(S, carla_write_episode_ready(server, carla_episode_ready{true}, TIMEOUT));
+
+  carla_agent agents[NUMBER_OF_AGENTS] = {};
+  for (auto i = 0u; i < NUMBER_OF_AGENTS; ++i) {
+    agents[i].id = i;
+    agents[i].type = CARLA_SERVER_AGENT_VEHICLE;
+    agents[i].forward_speed = static_cast<float>(i);
+  }
+  const carla_telemetry telemetry = {2.0f, 3.0f, 4.0f, 0.0f, 0u, 5u, 6u, 7u, 8u};
+  std::unique_ptr<unsigned char[]> image(new unsigned char[IMAGE_SIZE]);
+  // Too big for the stack.
+  auto measurements = std::make_unique<carla_measurements>();
+  auto control = std::make_unique<carla_control>();
+  for (auto frame = 1u; frame <= NUMBER_OF_FRAMES; ++frame) {
+    *measurements = {};
+    measurements->frame_number = frame;
+    measurements->non_player_agents = agents;
+    measurements->number_of_non_player_agents = NUMBER_OF_AGENTS;
+    measurements->telemetry = &telemetry;
+    ASSERT_EQ(S, carla_write_measurements_pipelined(server, *measurements));
+
+    const ImageHeader header = {frame, 300u, 200u, 1u, 90.0f};
+    for (auto i = 0u; i < IMAGE_SIZE; ++i) {
+      image[i] = Pattern(frame, i);
+    }
+    const carla_sensor_data data = {7u, &header, sizeof(header), image.get(), IMAGE_SIZE};
+    ASSERT_EQ(S, carla_write_sensor_data(server, data));
+
+    // The control double buffer may give back a control of a previous frame.
+    ASSERT_EQ(S, carla_read_control(server, *control, TIMEOUT));
+    ASSERT_EQ(1u, control->number_of_agent_controls);
+    const auto sent_frame = control->agent_controls[0u].id;
+    ASSERT_GE(frame, sent_frame);
+    ASSERT_LT(0u, sent_frame);
+    ASSERT_FLOAT_EQ(0.01f * sent_frame, control->steer);
+    ASSERT_FLOAT_EQ(0.5f, control->agent_controls[0u].vehicle_control.throttle);
+  }
+}
+
+/// Plays the episode of RunServer with the client API. The client must stay
+/// connected until the server reads the last control.
+static void RunClient(CarlaClientPtr client, const std::string &host, const uint32_t port) {
+  const auto S = CARLA_CLIENT_SUCCESS;
+  ASSERT_EQ(S, carla_client_connect(client, host.c_str(), port, TIMEOUT));
+  {
+    carla_scene_description scene;
+    ASSERT_EQ(S, carla_client_load_settings(client, INI_FILE, &scene));
+    ASSERT_EQ(std::string("TestTown"), scene.map_name);
+    ASSERT_EQ(2u, scene.number_of_player_start_spots);
+    ASSERT_EQ(1u, scene.number_of_sensors);
+    ASSERT_EQ(7u, scene.sensors[0u].id);
+    ASSERT_EQ(CARLA_SERVER_CAMERA, scene.sensors[0u].type);
+    ASSERT_EQ(std::string("Camera"), scene.sensors[0u].name);
+  }
+  ASSERT_EQ(S, carla_client_start_episode(client, 1u));
+
+  auto control = std::make_unique<carla_control>();
+  *control = {};
+  control->number_of_agent_controls = 1u;
+  for (auto frame = 1u; frame <= NUMBER_OF_FRAMES; ++frame) {
+    const carla_measurements *measurements;
+    const carla_sensor_data *sensor_data;
+    uint32_t number_of_sensor_data;
+    ASSERT_EQ(S, carla_client_read_data(client, &measurements, &sensor_data, &number_of_sensor_data));
+    ASSERT_EQ(frame, measurements->frame_number);
+    ASSERT_EQ(NUMBER_OF_AGENTS, measurements->number_of_non_player_agents);
+    for (auto i = 0u; i < NUMBER_OF_AGENTS; ++i) {
+      ASSERT_EQ(i, measurements->non_player_agents[i].id);
+      ASSERT_EQ(CARLA_SERVER_AGENT_VEHICLE, measurements->non_player_agents[i].type);
+      ASSERT_FLOAT_EQ(static_cast<float>(i), measurements->non_player_agents[i].forward_speed);
+    }
+    ASSERT_TRUE(measurements->telemetry != nullptr);
+    ASSERT_FLOAT_EQ(3.0f, measurements->telemetry->sensor_readback_time);
+    ASSERT_EQ(7u, measurements->telemetry->walkers_checked);
+
+    ASSERT_EQ(1u, number_of_sensor_data);
+    ASSERT_EQ(7u, sensor_data[0u].id);
+    ASSERT_EQ(sizeof(ImageHeader), sensor_data[0u].header_size);
+    ImageHeader header;
+    std::memcpy(&header, sensor_data[0u].header, sizeof(header));
+    ASSERT_EQ(frame, header.frame_number);
+    ASSERT_EQ(300u, header.width);
+    ASSERT_EQ(IMAGE_SIZE, sensor_data[0u].data_size);
+    auto data = static_cast<const unsigned char *>(sensor_data[0u].data);
+    for (auto i = 0u; i < IMAGE_SIZE; ++i) {
+      ASSERT_EQ(Pattern(frame, i), data[i]);
+    }
+
+    control->steer = 0.01f * frame;
+    control->agent_controls[0u].id = frame;
+    control->agent_controls[0u].vehicle_control.throttle = 0.5f;
+    ASSERT_EQ(S, carla_client_send_control(client, control.get()));
+  }
+}
+
+TEST(CarlaClientAPI, TCP) {
+  constexpr uint32_t port = 5200u;
+  auto server = make_server();
+  auto client = make_client();
+  auto result = std::async(std::launch::async, [&]() { RunServer(server.get(), port); });
+  RunClient(client.get(), "127.0.0.1", port);
+  result.get();
+}
+
+#ifdef __linux__
+
+TEST(CarlaClientAPI, SharedMemory) {
+  constexpr uint32_t port = 5210u;
+  auto server = make_server();
+  carla_server_set_shared_memory_size(server.get(), 8u * IMAGE_SIZE);
+  auto client = make_client();
+  auto result = std::async(std::launch::async, [&]() { RunServer(server.get(), port); });
+  RunClient(client.get(), "127.0.0.1", port);
+  result.get();
+}
+
+TEST(CarlaClientAPI, UnixSocket) {
+  constexpr uint32_t port = 5220u;
+  auto server = make_server();
+  carla_server_set_unix_socket_path(server.get(), "/tmp/carla-client-test");
+  auto client = make_client();
+  auto result = std::async(std::launch::async, [&]() { RunServer(server.get(), port); });
+  RunClient(client.get(), "unix:///tmp/carla-client-test", port);
+  result.get();
+}
+
+#endif // __linux__
+
+TEST(CarlaClientAPI, RecordAndReplay) {
+  const char *path = "/tmp/carla-client-test-recording.bin";
+  {
+    constexpr uint32_t port = 5240u;
+    auto server = make_server();
+    ASSERT_EQ(CARLA_SERVER_SUCCESS, carla_server_set_recording_file(server.get(), path));
+    auto client = make_client();
+    auto result = std::async(std::launch::async, [&]() { RunServer(server.get(), port); });
+    RunClient(client.get(), "127.0.0.1", port);
+    result.get();
+  }
+  // The replayed episode is the same for the client.
+  carla::server::Recording recording;
+  ASSERT_FALSE(recording.Open(path));
+  ASSERT_EQ(1u, recording.episodes().size());
+  {
+    constexpr uint32_t port = 5250u;
+    carla::server::ReplayServer server(recording, boost::posix_time::milliseconds(TIMEOUT));
+    auto client = make_client();
+    auto result = std::async(std::launch::async, [&]() {
+      ASSERT_FALSE(server.Connect(port));
+      ASSERT_FALSE(server.PlayEpisode(0u));
+      ASSERT_EQ(NUMBER_OF_FRAMES, server.GetNumberOfFramesSent());
+    });
+    RunClient(client.get(), "127.0.0.1", port);
+    result.get();
+  }
+  std::remove(path);
+}
+
+TEST(CarlaClientAPI, ConnectTimesOut) {
+  auto client = make_client();
+  ASSERT_EQ(CARLA_CLIENT_TIMED_OUT, carla_client_connect(client.get(), "127.0.0.1", 5230u, 100u));
+}
@@ -1,12 +1,16 @@
 #include <atomic>
 #include <future>
+#include <memory>
 
 #include <gtest/gtest.h>
 
-#include <carla/carla_server.h>
-
+// The internal headers go first, they define CARLA_SERVER_API with the
+// visibility of the library before the public header does.
 #include "carla/Logging.h"
 #include "carla/server/ServerTraits.h"
+#include "carla/server/WorldServer.h"
+
+#include <carla/carla_server.h>
 
 #include "Sensor.h"
 
@@ -45,6 +49,32 @@ TEST(CarlaServerAPI, MakeCarlaServer) {
   ASSERT_TRUE(CarlaServer != nullptr);
 }
 
+TEST(WorldServer, PortsInUseByAnotherSession) {
+  WorldServer server0;
+  WorldServer server1;
+  auto result0 = server0.Connect(5000u, seconds(1));
+  // Overlaps with the agent ports of the first session.
+  auto result1 = server1.Connect(5002u, seconds(1));
+  ASSERT_EQ(errc::invalid_argument(), result1.get());
+  WorldServer server2;
+  auto result2 = server2.Connect(5003u, seconds(1));
+  // There is no client, but the ports are available.
+  ASSERT_NE(errc::invalid_argument(), result2.get());
+}
+
+TEST(WorldServer, ObserverPortInUseByAnotherSession) {
+  WorldServer server0;
+  WorldServer server1;
+  ASSERT_EQ(errc::success(), server0.SetObserverPort(5100u));
+  ASSERT_EQ(errc::invalid_argument(), server1.SetObserverPort(5100u));
+  // Overlaps with the observer port of the first session.
+  auto result1 = server1.Connect(5099u, seconds(1));
+  ASSERT_EQ(errc::invalid_argument(), result1.get());
+  // Released when changed.
+  ASSERT_EQ(errc::success(), server0.SetObserverPort(0u));
+  ASSERT_EQ(errc::success(), server1.SetObserverPort(5100u));
+}
+
 TEST(CarlaServerAPI, SimBlocking) {
   auto CarlaServerGuard = make_carla_server();
   CarlaServerPtr CarlaServer = CarlaServerGuard.get();
@@ -114,21 +144,22 @@ TEST(CarlaServerAPI, SimBlocking) {
 
     std::atomic_bool done{false};
 
-    // Simulate game thread.
+    // Simulate game thread. The structs are large, they go to the heap
+    // zero-initialized.
     auto game_thread_result = std::async(std::launch::async, [&](){
+      auto measurements = std::make_unique<carla_measurements>();
+      measurements->non_player_agents = agents_data.data();
+      measurements->number_of_non_player_agents = agents_data.size();
+      auto control = std::make_unique<carla_control>();
       while (!done) {
         {
-          carla_measurements measurements;
-          measurements.non_player_agents = agents_data.data();
-          measurements.number_of_non_player_agents = agents_data.size();
-          auto ec = carla_write_measurements(CarlaServer, measurements);
+          auto ec = carla_write_measurements(CarlaServer, *measurements);
           if (ec != S)
             break;
         }
         {
-          carla_control control;
           test_log("waiting for control...");
-          auto ec = carla_read_control(CarlaServer, control, TIMEOUT);
+          auto ec = carla_read_control(CarlaServer, *control, TIMEOUT);
           if ((ec != S) && (ec != CARLA_SERVER_TRY_AGAIN)) {
             break;
           }
@@ -149,10 +180,11 @@ TEST(CarlaServerAPI, SimBlocking) {
     for (;;) {
       carla_request_new_episode new_episode;
       auto ec = carla_read_request_new_episode(CarlaServer, new_episode, 0);
-      ASSERT_TRUE((ec == S) || (ec == CARLA_SERVER_TRY_AGAIN));
       if (ec != CARLA_SERVER_TRY_AGAIN) {
         test_log("received new episode request");
+        // Stop the threads before asserting, the futures wait for them.
         done = true;
+        ASSERT_EQ(S, ec);
         break;
       }
       std::this_thread::sleep_for(std::chrono::milliseconds(16));
@@ -144,3 +144,21 @@ TEST(DoubleBuffer, LongMessage) {
   result_reader.get();
   result_writer.get();
 }
+
+TEST(DoubleBuffer, WriteWhileReading) {
+  using namespace carla::server;
+
+  DoubleBuffer<size_t> buffer;
+  *buffer.MakeWriter() = 1u;
+  {
+    auto reader = buffer.TryMakeReader();
+    ASSERT_TRUE(reader != nullptr);
+    ASSERT_EQ(1u, *reader);
+    // Written while the reader holds the other buffer, it is swapped in when
+    // the reader is released.
+    *buffer.MakeWriter() = 2u;
+  }
+  auto reader = buffer.TryMakeReader();
+  ASSERT_TRUE(reader != nullptr);
+  ASSERT_EQ(2u, *reader);
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <carla/Logging.h>
+
+using namespace carla;
+
+/// Redirects the log output while alive.
+class CaptureLog {
+public:
+
+  CaptureLog() {
+    logging::SetOutput(out, err);
+  }
+
+  ~CaptureLog() {
+    logging::SetOutput(std::cout, std::cerr);
+  }
+
+  std::stringstream out;
+
+  std::stringstream err;
+};
+
+static size_t CountLines(const std::string &text, const std::string &substring) {
+  size_t count = 0u;
+  std::istringstream stream(text);
+  std::string line;
+  while (std::getline(stream, line)) {
+    count += (line.find(substring) != std::string::npos ? 1u : 0u);
+  }
+  return count;
+}
+
+/// Number of messages reported as dropped or suppressed in @a text.
+static size_t CountDiscarded(const std::string &text) {
+  size_t count = 0u;
+  std::istringstream stream(text);
+  std::string line;
+  while (std::getline(stream, line)) {
+    if ((line.find("dropped") != std::string::npos) || (line.find("suppressed") != std::string::npos)) {
+      count += std::stoul(line.substr(line.find(' ') + 1u));
+    }
+  }
+  return count;
+}
+
+TEST(Logging, Format) {
+  CaptureLog log;
+  log_warning("warning", 42, true);
+  log_error("error", 1.5);
+  logging::Flush();
+  ASSERT_EQ("WARNING: warning 42 true \nERROR: error 1.5 \n", log.err.str());
+}
+
+TEST(Logging, Truncated) {
+  CaptureLog log;
+  log_error(std::string(2u * logging::MaxRecordSize, 'a'));
+  logging::Flush();
+  const auto line = log.err.str();
+  ASSERT_EQ(logging::MaxRecordSize, line.size());
+  ASSERT_EQ("...\n", line.substr(line.size() - 4u));
+}
+
+TEST(Logging, RuntimeLevel) {
+  CaptureLog log;
+  const auto level = logging::GetLevel();
+  logging::SetLevel(CARLA_SERVER_LOG_LEVEL_ERROR);
+  log_info("discarded");
+  log_warning("discarded");
+  log_error("logged");
+  logging::SetLevel(level);
+  log_warning("logged");
+  logging::Flush();
+  ASSERT_EQ(0u, CountLines(log.out.str() + log.err.str(), "discarded"));
+  ASSERT_EQ(2u, CountLines(log.out.str() + log.err.str(), "logged"));
+}
+
+TEST(Logging, RateLimit) {
+  CaptureLog log;
+  constexpr size_t limit = 10u;
+  constexpr size_t total = 1000u;
+  logging::SetRateLimit(limit);
+  for (auto i = 0u; i < total; ++i) {
+    log_error("message", i);
+  }
+  logging::SetRateLimit(0u);
+  logging::Flush();
+  const auto text = log.err.str();
+  const auto logged = CountLines(text, "ERROR: message");
+  // The loop may span two windows of one second.
+  ASSERT_GE(logged, limit);
+  ASSERT_LE(logged, 2u * limit);
+  ASSERT_EQ(total, logged + CountDiscarded(text));
+}
+
+TEST(Logging, NoRecordLost) {
+  CaptureLog log;
+  constexpr size_t number_of_threads = 4u;
+  constexpr size_t records_per_thread = 4u * logging::QueueSize;
+  std::vector<std::thread> threads;
+  for (auto i = 0u; i < number_of_threads; ++i) {
+    threads.emplace_back([i]() {
+      for (auto j = 0u; j < records_per_thread; ++j) {
+        log_error("thread", i, "record", j);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  logging::Flush();
+  const auto text = log.err.str();
+  // Every record is either written intact or counted as dropped.
+  ASSERT_EQ(
+      number_of_threads * records_per_thread,
+      CountLines(text, "ERROR: thread") + CountDiscarded(text));
+}
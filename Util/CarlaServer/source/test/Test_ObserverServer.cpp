@@ -0,0 +1,72 @@
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/read.hpp>
+
+#include <carla/server/ObserverServer.h>
+
+using namespace carla::server;
+using namespace boost::asio::ip;
+
+static constexpr uint32_t PORT = 5100u;
+
+static void ConnectObserver(tcp::socket &socket, const ObserverServer &server) {
+  socket.connect(tcp::endpoint(address::from_string("127.0.0.1"), PORT));
+  // Wait until the server registers the connection.
+  for (auto i = 0u; (i < 100u) && !server.HasObservers(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10u));
+  }
+  ASSERT_TRUE(server.HasObservers());
+}
+
+static std::string Read(tcp::socket &socket, size_t size) {
+  std::string result(size, '\0');
+  boost::asio::read(socket, boost::asio::buffer(&result[0u], size));
+  return result;
+}
+
+static ObserverServer::shared_frame MakeFrame(size_t size, unsigned char value) {
+  return std::make_shared<ObserverServer::frame_type>(size, value);
+}
+
+TEST(ObserverServer, ReceiveSceneAndFrames) {
+  const std::string scene = "scene description";
+  ObserverServer server(PORT, scene);
+  ASSERT_FALSE(server.HasObservers());
+
+  boost::asio::io_service service;
+  tcp::socket socket(service);
+  ConnectObserver(socket, server);
+  ASSERT_EQ(scene, Read(socket, scene.size()));
+
+  for (auto i = 0u; i < 20u; ++i) {
+    auto frame = MakeFrame(1000u + i, static_cast<unsigned char>(i));
+    server.Write(frame);
+    const auto received = Read(socket, frame->size());
+    ASSERT_EQ(0, std::memcmp(received.data(), frame->data(), frame->size()));
+  }
+}
+
+TEST(ObserverServer, SlowObserverDoesNotBlock) {
+  ObserverServer server(PORT, "scene");
+
+  boost::asio::io_service service;
+  tcp::socket socket(service);
+  ConnectObserver(socket, server);
+
+  // The observer does not read, frames are dropped instead of queued.
+  constexpr size_t frame_size = 10u * 1024u * 1024u;
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0u; i < 100u; ++i) {
+    server.Write(MakeFrame(frame_size, static_cast<unsigned char>(i)));
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_LT(elapsed, std::chrono::seconds(1));
+
+  // The frame being sent arrives complete.
+  ASSERT_EQ(std::string("scene"), Read(socket, 5u));
+  const auto received = Read(socket, frame_size);
+  ASSERT_EQ(received.front(), received.back());
+}
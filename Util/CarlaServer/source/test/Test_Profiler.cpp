@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <carla/Profiler.h>
+#include <carla/carla_server.h>
+
+using namespace carla::profiler;
+
+static bool FindScope(const char *name, carla_profiler_scope &result) {
+  std::vector<carla_profiler_scope> scopes(carla_profiler_snapshot(nullptr, 0u));
+  const auto size = carla_profiler_snapshot(scopes.data(), static_cast<uint32_t>(scopes.size()));
+  scopes.resize(std::min(static_cast<size_t>(size), scopes.size()));
+  for (auto &scope : scopes) {
+    if (std::strcmp(scope.name, name) == 0) {
+      result = scope;
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(Profiler, HistogramBuckets) {
+  for (uint64_t value = 0u; value < (1u << 20u); value += 7u) {
+    const auto index = Histogram::GetBucketIndex(value);
+    ASSERT_LT(index, Histogram::NumberOfBuckets);
+    const auto upper_bound = Histogram::GetBucketUpperBound(index);
+    ASSERT_LE(value, upper_bound);
+    ASSERT_LE(upper_bound - value, value / Histogram::SubBuckets);
+  }
+  ASSERT_EQ(Histogram::NumberOfBuckets - 1u, Histogram::GetBucketIndex(UINT64_MAX));
+  ASSERT_EQ(UINT64_MAX, Histogram::GetBucketUpperBound(Histogram::NumberOfBuckets - 1u));
+}
+
+TEST(Profiler, Percentiles) {
+  auto &scope = GetScope("Test_Profiler.Percentiles");
+  // Two threads record 1000 to 1000000 ticks, the statistics are merged.
+  auto record = [&]() {
+    auto &histogram = scope.MakeThreadHistogram();
+    for (uint64_t value = 1u; value <= 1000u; ++value) {
+      histogram.Record(1000u * value);
+    }
+  };
+  std::thread thread(record);
+  record();
+  thread.join();
+
+  const auto statistics = scope.GetStatistics();
+  ASSERT_EQ(2000u, statistics.count);
+  // Back to thousands of ticks, with the error of the histogram plus some
+  // margin for the calibration of the clock.
+  const double ns_per_tick = Clock::GetNanosecondsPerTick();
+  auto ticks = [=](uint64_t nanoseconds) {
+    return 1e-3 * static_cast<double>(nanoseconds) / ns_per_tick;
+  };
+  constexpr double error = 1.0 / 16.0 + 0.02;
+  ASSERT_NEAR(1.0, ticks(statistics.min), 1.0 * error);
+  ASSERT_NEAR(1000.0, ticks(statistics.max), 1000.0 * error);
+  ASSERT_NEAR(500.0, ticks(statistics.p50), 500.0 * error);
+  ASSERT_NEAR(990.0, ticks(statistics.p99), 990.0 * error);
+  ASSERT_NEAR(999.0, ticks(statistics.p999), 999.0 * error);
+  ASSERT_LE(statistics.p50, statistics.p99);
+  ASSERT_LE(statistics.p99, statistics.p999);
+  ASSERT_LE(statistics.p999, statistics.max);
+}
+
+TEST(Profiler, Snapshot) {
+  for (auto i = 0u; i < 10u; ++i) {
+    CARLA_PROFILE_SCOPE(Test_Profiler, Sleep);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2u));
+  }
+  carla_profiler_scope scope;
+  ASSERT_TRUE(FindScope("Test_Profiler.Sleep", scope));
+  ASSERT_EQ(10u, scope.count);
+  ASSERT_GE(scope.min, 2000000u);
+  ASSERT_LE(scope.min, scope.p50);
+  ASSERT_LE(scope.p50, scope.p99);
+  ASSERT_LE(scope.p99, scope.p999);
+  ASSERT_LE(scope.p999, scope.max);
+  ASSERT_GE(scope.total, 10u * scope.min);
+}
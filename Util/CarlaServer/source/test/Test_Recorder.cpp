@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <carla/server/Recorder.h>
+#include <carla/server/Recording.h>
+
+using namespace carla::server;
+
+static const char *PATH = "/tmp/carla-recorder-test.bin";
+
+static constexpr uint32_t NUMBER_OF_EPISODES = 2u;
+static constexpr uint32_t NUMBER_OF_FRAMES = 50u;
+
+static std::string Frame(const uint32_t episode, const uint32_t frame) {
+  return std::string(100u + frame, static_cast<char>('a' + (episode + frame) % 26u));
+}
+
+/// Record NUMBER_OF_EPISODES episodes, each with a frame and a control per
+/// frame. A small chunk size makes it span several chunks.
+static void WriteRecording() {
+  Recorder recorder(PATH, 1024u);
+  ASSERT_TRUE(recorder.IsValid());
+  for (auto episode = 0u; episode < NUMBER_OF_EPISODES; ++episode) {
+    recorder.Write(recording::SCENE_DESCRIPTION, 0u, "scene" + std::to_string(episode));
+    for (auto frame = 1u; frame <= NUMBER_OF_FRAMES; ++frame) {
+      recorder.Write(recording::FRAME, frame, Frame(episode, frame));
+      recorder.Write(recording::CONTROL, 0u, "control" + std::to_string(frame));
+    }
+  }
+}
+
+static void CheckRecording(Recording &recording, const uint32_t number_of_frames) {
+  auto &entries = recording.entries();
+  std::vector<unsigned char> buffer;
+  for (auto episode = 0u; episode < recording.episodes().size(); ++episode) {
+    auto &range = recording.episodes().at(episode);
+    ASSERT_EQ(recording::SCENE_DESCRIPTION, entries[range.begin].type);
+    ASSERT_FALSE(recording.Read(entries[range.begin], buffer));
+    ASSERT_EQ("scene" + std::to_string(episode), std::string(buffer.begin(), buffer.end()));
+    auto frame = 0u;
+    for (auto i = range.begin + 1u; i < range.end; ++i) {
+      auto &entry = entries[i];
+      ASSERT_FALSE(recording.Read(entry, buffer));
+      if (entry.type == recording::FRAME) {
+        ++frame;
+        ASSERT_EQ(frame, entry.frame_number);
+        ASSERT_EQ(Frame(episode, frame), std::string(buffer.begin(), buffer.end()));
+      } else {
+        ASSERT_EQ(recording::CONTROL, entry.type);
+        // Controls take the number of the last frame.
+        ASSERT_EQ(frame, entry.frame_number);
+        ASSERT_EQ("control" + std::to_string(frame), std::string(buffer.begin(), buffer.end()));
+      }
+    }
+    ASSERT_LE(frame, number_of_frames);
+  }
+}
+
+TEST(Recorder, WriteAndRead) {
+  WriteRecording();
+  Recording recording;
+  ASSERT_FALSE(recording.Open(PATH));
+  ASSERT_EQ(NUMBER_OF_EPISODES * (1u + 2u * NUMBER_OF_FRAMES), recording.entries().size());
+  ASSERT_EQ(NUMBER_OF_EPISODES, recording.episodes().size());
+  CheckRecording(recording, NUMBER_OF_FRAMES);
+  std::remove(PATH);
+}
+
+TEST(Recorder, ReadWithoutIndex) {
+  WriteRecording();
+  // Cut the index and part of the last chunk, as if the process crashed.
+  std::string contents;
+  {
+    std::ifstream file(PATH, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  const auto index_size =
+      NUMBER_OF_EPISODES * (1u + 2u * NUMBER_OF_FRAMES) * recording::INDEX_ENTRY_SIZE +
+      recording::TRAILER_SIZE;
+  ASSERT_LT(index_size + 100u, contents.size());
+  contents.resize(contents.size() - index_size - 100u);
+  {
+    std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+  }
+  Recording recording;
+  ASSERT_FALSE(recording.Open(PATH));
+  ASSERT_LT(0u, recording.entries().size());
+  ASSERT_GT(NUMBER_OF_EPISODES * (1u + 2u * NUMBER_OF_FRAMES), recording.entries().size());
+  CheckRecording(recording, NUMBER_OF_FRAMES);
+  std::remove(PATH);
+}
+
+TEST(Recorder, NotARecording) {
+  {
+    std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+    file << "this is not a recording";
+  }
+  Recording recording;
+  ASSERT_TRUE(recording.Open(PATH));
+  std::remove(PATH);
+  ASSERT_TRUE(recording.Open(PATH));
+}
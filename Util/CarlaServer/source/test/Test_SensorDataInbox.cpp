@@ -5,6 +5,7 @@
 #include <carla/carla_server.h>
 
 #include "carla/server/SensorDataInbox.h"
+#include "carla/server/SharedMemoryRing.h"
 
 #include "Sensor.h"
 
@@ -27,6 +28,40 @@ TEST(SensorDataInbox, SyncSingleSensor) {
   }
 }
 
+TEST(SensorDataInbox, FrameNumber) {
+  using namespace carla::server;
+  test::Sensor sensor0;
+  SensorDataInbox::Sensors defs;
+  defs.push_back(sensor0.definition());
+  SensorDataInbox inbox(defs);
+  for (auto j = 0u; j < 100u; ++j) {
+    inbox.Write(sensor0.MakeRandomData());
+    auto buffer = (*inbox.begin()).TryMakeReader();
+    ASSERT_TRUE(buffer != nullptr);
+    ASSERT_EQ(sensor0.frame_number(), buffer->frame_number());
+  }
+}
+
+TEST(SensorDataInbox, SharedMemory) {
+  using namespace carla::server;
+  test::Sensor sensor0;
+  SensorDataInbox::Sensors defs;
+  defs.push_back(sensor0.definition());
+  SharedMemoryRing ring("/carla-server-test-inbox", 1024u * 1024u);
+  ASSERT_TRUE(ring.IsValid());
+  SensorDataInbox inbox(defs, &ring);
+  for (auto j = 0u; j < 100u; ++j) {
+    inbox.Write(sensor0.MakeRandomData());
+    auto buffer = (*inbox.begin()).TryMakeReader();
+    ASSERT_TRUE(buffer != nullptr);
+    ASSERT_TRUE(buffer->is_shared());
+    ASSERT_EQ(sensor0.frame_number(), buffer->frame_number());
+    std::vector<unsigned char> message;
+    buffer->AppendInline(message);
+    sensor0.CheckData(boost::asio::buffer(message));
+  }
+}
+
 TEST(SensorDataInbox, SyncMultipleSensors) {
   using namespace carla::server;
   std::array<test::Sensor, 50u> sensors;
@@ -88,3 +123,61 @@ TEST(SensorDataInbox, Async) {
   result_reader.get();
   result_writer.get();
 }
+
+TEST(SensorDataInbox, ReadFrameWaitsAndDiscardsOlderData) {
+  using namespace carla::server;
+  test::Sensor sensor0;
+  SensorDataInbox::Sensors defs;
+  defs.push_back(sensor0.definition());
+  SensorDataInbox inbox(defs);
+  inbox.Write(sensor0.MakeRandomData());
+  ASSERT_EQ(1u, sensor0.frame_number());
+  auto writer = std::async(std::launch::async, [&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+    inbox.Write(sensor0.MakeRandomData());
+  });
+  std::vector<uint64_t> frames;
+  const auto skipped = inbox.ReadFrame(2u, timeout_t::milliseconds(10000u), [&](auto reader) {
+    frames.push_back(reader->frame_number());
+    sensor0.CheckData(reader->buffer());
+  });
+  writer.get();
+  ASSERT_EQ(0u, skipped);
+  ASSERT_EQ(std::vector<uint64_t>{2u}, frames);
+}
+
+TEST(SensorDataInbox, ReadFrameSkipsSensorsThatTimeOut) {
+  using namespace carla::server;
+  test::Sensor sensor0;
+  test::Sensor sensor1;
+  SensorDataInbox::Sensors defs;
+  defs.push_back(sensor0.definition());
+  defs.push_back(sensor1.definition());
+  SensorDataInbox inbox(defs);
+  inbox.Write(sensor1.MakeRandomData());
+  auto readings = 0u;
+  const auto skipped = inbox.ReadFrame(1u, timeout_t::milliseconds(10u), [&](auto reader) {
+    sensor1.CheckData(reader->buffer());
+    ++readings;
+  });
+  ASSERT_EQ(1u, skipped);
+  ASSERT_EQ(1u, readings);
+}
+
+TEST(SensorDataInbox, ReadFrameTimeOutIsShared) {
+  using namespace carla::server;
+  constexpr auto timeout = std::chrono::milliseconds(50u);
+  std::array<test::Sensor, 20u> sensors;
+  SensorDataInbox::Sensors defs;
+  std::for_each(sensors.begin(), sensors.end(), [&](auto &s){
+    defs.push_back(s.definition());
+  });
+  SensorDataInbox inbox(defs);
+  const auto start = std::chrono::steady_clock::now();
+  const auto skipped = inbox.ReadFrame(1u, timeout, [](auto) {});
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_EQ(sensors.size(), skipped);
+  // Waiting the full time-out for each sensor would take sensors.size() times
+  // longer.
+  ASSERT_LT(elapsed, sensors.size() * timeout);
+}
@@ -0,0 +1,96 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <carla/server/SharedMemoryRing.h>
+
+using namespace carla::server;
+
+static constexpr uint64_t SIZE = 1024u;
+
+/// Map the region from "outside", as a client would do.
+static const unsigned char *MapReadOnly(const std::string &name) {
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  void *ptr = mmap(nullptr, SIZE, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  return ptr == MAP_FAILED ? nullptr : static_cast<const unsigned char *>(ptr);
+}
+
+TEST(SharedMemoryRing, WriteAndWrapAround) {
+  SharedMemoryRing ring("/carla-server-test", SIZE);
+  ASSERT_TRUE(ring.IsValid());
+  auto region = MapReadOnly(ring.name());
+  ASSERT_NE(nullptr, region);
+
+  const unsigned char header[] = {1u, 2u, 3u};
+  std::vector<unsigned char> data(300u);
+  const uint64_t slot_size =
+      SharedMemoryRing::SLOT_PREFIX_SIZE + sizeof(header) + data.size() + SharedMemoryRing::SLOT_SUFFIX_SIZE;
+
+  uint64_t expected = 0u;
+  for (auto i = 0u; i < 10u; ++i) {
+    std::fill(data.begin(), data.end(), static_cast<unsigned char>(i));
+    uint64_t offset;
+    uint64_t sequence;
+    ASSERT_TRUE(ring.Write(header, sizeof(header), data.data(), data.size(), offset, sequence));
+    if (expected + slot_size > SIZE) {
+      expected = 0u;
+    }
+    ASSERT_EQ(expected, offset);
+    ASSERT_EQ(0u, offset % 16u);
+    ASSERT_EQ(i + 1u, sequence);
+    const auto payload = region + offset + SharedMemoryRing::SLOT_PREFIX_SIZE;
+    ASSERT_EQ(0, std::memcmp(payload, header, sizeof(header)));
+    ASSERT_EQ(0, std::memcmp(payload + sizeof(header), data.data(), data.size()));
+    const uint32_t size = sizeof(header) + data.size();
+    ASSERT_TRUE(SharedMemoryRing::IsSlotValid(region, SIZE, offset, size, sequence));
+    expected += 336u;
+  }
+  munmap(const_cast<unsigned char *>(region), SIZE);
+}
+
+TEST(SharedMemoryRing, ReaderLagsBehind) {
+  SharedMemoryRing ring("/carla-server-test", SIZE);
+  ASSERT_TRUE(ring.IsValid());
+  auto region = MapReadOnly(ring.name());
+  ASSERT_NE(nullptr, region);
+
+  std::vector<unsigned char> data(300u, 42u);
+  const uint32_t size = data.size();
+  uint64_t first_offset;
+  uint64_t first_sequence;
+  ASSERT_TRUE(ring.Write(nullptr, 0u, data.data(), size, first_offset, first_sequence));
+  // The reader has not read the first slot yet when the ring wraps around.
+  for (auto i = 0u; i < 3u; ++i) {
+    uint64_t offset;
+    uint64_t sequence;
+    ASSERT_TRUE(ring.Write(nullptr, 0u, data.data(), size, offset, sequence));
+    ASSERT_TRUE(SharedMemoryRing::IsSlotValid(region, SIZE, offset, size, sequence));
+  }
+  ASSERT_FALSE(SharedMemoryRing::IsSlotValid(region, SIZE, first_offset, size, first_sequence));
+  // Out of the region.
+  ASSERT_FALSE(SharedMemoryRing::IsSlotValid(region, SIZE, SIZE - 16u, size, first_sequence));
+  munmap(const_cast<unsigned char *>(region), SIZE);
+}
+
+TEST(SharedMemoryRing, TooBig) {
+  SharedMemoryRing ring("/carla-server-test", SIZE);
+  ASSERT_TRUE(ring.IsValid());
+  std::vector<unsigned char> data(SIZE / 2u + 1u);
+  uint64_t offset;
+  uint64_t sequence;
+  ASSERT_FALSE(ring.Write(nullptr, 0u, data.data(), data.size(), offset, sequence));
+}
+
+TEST(SharedMemoryRing, RemovedOnDestruction) {
+  {
+    SharedMemoryRing ring("/carla-server-test", SIZE);
+    ASSERT_TRUE(ring.IsValid());
+  }
+  ASSERT_EQ(-1, shm_open("/carla-server-test", O_RDONLY, 0));
+}
@@ -1,7 +1,12 @@
+#include <array>
 #include <future>
 
 #include <gtest/gtest.h>
 
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
 #include <carla/Logging.h>
 #include <carla/server/Protobuf.h>
 #include <carla/server/TCPServer.h>
@@ -66,3 +71,35 @@ TEST(TCPServer, AsyncDisconnect) {
 
   result.get();
 }
+
+TEST(TCPServer, UnixSocket) {
+  TCPServer server;
+  server.SetUnixSocketPath("/tmp/carla-test");
+
+  // Echo client.
+  auto client = std::async(std::launch::async, [](){
+    using boost::asio::local::stream_protocol;
+    boost::asio::io_service service;
+    stream_protocol::socket socket(service);
+    for (auto i = 0u; i < 100u; ++i) {
+      boost::system::error_code ec;
+      socket.connect(stream_protocol::endpoint("/tmp/carla-test-5200"), ec);
+      if (!ec)
+        break;
+      socket.close();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10u));
+    }
+    std::array<char, 64u> buffer;
+    const auto size = boost::asio::read(socket, boost::asio::buffer(buffer));
+    boost::asio::write(socket, boost::asio::buffer(buffer, size));
+  });
+
+  ASSERT_FALSE(server.Connect(5200u, TIMEOUT));
+  std::array<char, 64u> message;
+  message.fill('x');
+  ASSERT_FALSE(server.Write(boost::asio::buffer(message), TIMEOUT));
+  std::array<char, 64u> received;
+  ASSERT_FALSE(server.Read(boost::asio::buffer(received), TIMEOUT));
+  ASSERT_EQ(message, received);
+  client.get();
+}
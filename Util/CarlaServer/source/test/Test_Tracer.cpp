@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <carla/Tracer.h>
+#include <carla/carla_server.h>
+
+using namespace carla;
+
+struct TraceEvent {
+  std::string name;
+  std::string phase;
+  uint32_t tid;
+  double ts;
+  double dur;
+};
+
+/// Parse the dump and return the events whose name starts with @a prefix.
+static std::vector<TraceEvent> ParseTrace(std::istream &input, const std::string &prefix) {
+  boost::property_tree::ptree tree;
+  boost::property_tree::read_json(input, tree);
+  EXPECT_EQ("ms", tree.get<std::string>("displayTimeUnit"));
+  std::vector<TraceEvent> events;
+  for (auto &item : tree.get_child("traceEvents")) {
+    auto &event = item.second;
+    TraceEvent result{
+        event.get<std::string>("name"),
+        event.get<std::string>("ph"),
+        event.get<uint32_t>("tid"),
+        event.get<double>("ts"),
+        event.get<double>("dur")};
+    EXPECT_EQ(1u, event.get<uint32_t>("pid"));
+    EXPECT_GE(result.ts, 0.0);
+    EXPECT_GE(result.dur, 0.0);
+    if (result.name.compare(0u, prefix.size(), prefix) == 0) {
+      events.push_back(result);
+    }
+  }
+  return events;
+}
+
+static std::vector<TraceEvent> DumpTrace(const std::string &prefix) {
+  std::stringstream stream;
+  tracer::Dump(stream);
+  return ParseTrace(stream, prefix);
+}
+
+TEST(Tracer, ChromeTraceFormat) {
+  // The events of the other tests are still in the buffers, this one uses its
+  // own context so they can be told apart.
+  tracer::SetEnabled(true);
+  auto work = []() {
+    CARLA_TRACE_SCOPE(Test_TracerFormat, Outer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2u));
+    {
+      CARLA_TRACE_SCOPE(Test_TracerFormat, Inner);
+      std::this_thread::sleep_for(std::chrono::milliseconds(2u));
+    }
+  };
+  std::thread thread(work);
+  work();
+  thread.join();
+  tracer::SetEnabled(false);
+  {
+    CARLA_TRACE_SCOPE(Test_TracerFormat, Disabled);
+  }
+
+  const std::string path = "/tmp/carla-test-trace.json";
+  ASSERT_EQ(CARLA_SERVER_SUCCESS, carla_tracer_dump(path.c_str()));
+  std::ifstream file(path);
+  const auto events = ParseTrace(file, "Test_TracerFormat.");
+  file.close();
+  std::remove(path.c_str());
+
+  ASSERT_EQ(4u, events.size());
+  for (auto &outer : events) {
+    ASSERT_EQ("X", outer.phase);
+    if (outer.name != "Test_TracerFormat.Outer") {
+      continue;
+    }
+    ASSERT_GE(outer.dur, 4000.0);
+    // The inner event of the same thread is nested in the outer one.
+    size_t nested = 0u;
+    for (auto &inner : events) {
+      if ((inner.name == "Test_TracerFormat.Inner") && (inner.tid == outer.tid)) {
+        ++nested;
+        ASSERT_GE(inner.dur, 2000.0);
+        ASSERT_GE(inner.ts, outer.ts);
+        ASSERT_LE(inner.ts + inner.dur, outer.ts + outer.dur);
+      }
+    }
+    ASSERT_EQ(1u, nested);
+  }
+}
+
+TEST(Tracer, InvalidPath) {
+  ASSERT_NE(CARLA_SERVER_SUCCESS, carla_tracer_dump("/nonexistent/directory/trace.json"));
+}
+
+TEST(Tracer, RingBuffer) {
+  tracer::SetEnabled(true);
+  std::thread([]() {
+    for (auto i = 0u; i < 2u * tracer::EventsPerThread; ++i) {
+      CARLA_TRACE_SCOPE(Test_Tracer, Ring);
+    }
+  }).join();
+  tracer::SetEnabled(false);
+  const auto events = DumpTrace("Test_Tracer.Ring");
+  ASSERT_GE(events.size(), tracer::EventsPerThread - 1u);
+  ASSERT_LE(events.size(), tracer::EventsPerThread);
+}
+
+TEST(Tracer, BoundedMemory) {
+  tracer::SetEnabled(true);
+  auto trace_in_new_thread = []() {
+    std::thread([]() {
+      CARLA_TRACE_SCOPE(Test_Tracer, ShortLivedThread);
+    }).join();
+  };
+  trace_in_new_thread();
+  const auto memory_usage = tracer::GetMemoryUsage();
+  // The buffers of the threads that exited are reused.
+  for (auto i = 0u; i < 100u; ++i) {
+    trace_in_new_thread();
+  }
+  tracer::SetEnabled(false);
+  ASSERT_EQ(memory_usage, tracer::GetMemoryUsage());
+  ASSERT_LE(memory_usage, 16u * tracer::EventsPerThread * 32u);
+}
@@ -0,0 +1,150 @@
+#ifdef __linux__
+
+#include <dlfcn.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <future>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <carla/server/TCPServer.h>
+
+using namespace carla::server;
+using namespace boost::posix_time;
+
+// Count the system calls made by each thread by interposing the libc wrappers
+// used by asio. Built as its own executable so the interposed functions don't
+// affect the rest of the tests.
+
+static thread_local uint64_t SYSCALLS = 0u;
+
+template <typename F>
+static F *Next(const char *name) {
+  return reinterpret_cast<F *>(dlsym(RTLD_NEXT, name));
+}
+
+#define CARLA_COUNT_SYSCALL(name, ...) \
+  ++SYSCALLS; \
+  static auto next = Next<decltype(::name)>(#name); \
+  return next(__VA_ARGS__);
+
+extern "C" {
+
+  ssize_t send(int fd, const void *buf, size_t len, int flags) {
+    CARLA_COUNT_SYSCALL(send, fd, buf, len, flags);
+  }
+
+  ssize_t recv(int fd, void *buf, size_t len, int flags) {
+    CARLA_COUNT_SYSCALL(recv, fd, buf, len, flags);
+  }
+
+  ssize_t sendmsg(int fd, const struct msghdr *msg, int flags) {
+    CARLA_COUNT_SYSCALL(sendmsg, fd, msg, flags);
+  }
+
+  ssize_t recvmsg(int fd, struct msghdr *msg, int flags) {
+    CARLA_COUNT_SYSCALL(recvmsg, fd, msg, flags);
+  }
+
+  ssize_t read(int fd, void *buf, size_t count) {
+    CARLA_COUNT_SYSCALL(read, fd, buf, count);
+  }
+
+  ssize_t write(int fd, const void *buf, size_t count) {
+    CARLA_COUNT_SYSCALL(write, fd, buf, count);
+  }
+
+  int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout) {
+    CARLA_COUNT_SYSCALL(epoll_wait, epfd, events, maxevents, timeout);
+  }
+
+  int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
+    CARLA_COUNT_SYSCALL(epoll_ctl, epfd, op, fd, event);
+  }
+
+  int timerfd_settime(int fd, int flags, const struct itimerspec *new_value, struct itimerspec *old_value) {
+    CARLA_COUNT_SYSCALL(timerfd_settime, fd, flags, new_value, old_value);
+  }
+
+} // extern "C"
+
+#undef CARLA_COUNT_SYSCALL
+
+static uint64_t GetContextSwitches() {
+  struct rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+TEST(TCPServer, SyscallsPerTick) {
+  constexpr uint32_t port = 5201u;
+  constexpr size_t message_size = 1024u;
+  constexpr size_t warm_up = 10u;
+  constexpr size_t ticks = 1000u;
+
+  // Echo client.
+  auto client = std::async(std::launch::async, [=](){
+    using namespace boost::asio::ip;
+    boost::asio::io_service service;
+    tcp::socket socket(service);
+    for (auto i = 0u; i < 100u; ++i) {
+      boost::system::error_code ec;
+      socket.connect(tcp::endpoint(address::from_string("127.0.0.1"), port), ec);
+      if (!ec)
+        break;
+      socket.close();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10u));
+    }
+    std::array<char, message_size> buffer;
+    for (auto i = 0u; i < warm_up + ticks; ++i) {
+      boost::asio::read(socket, boost::asio::buffer(buffer));
+      boost::asio::write(socket, boost::asio::buffer(buffer));
+    }
+  });
+
+  TCPServer server;
+  ASSERT_FALSE(server.Connect(port, seconds(10)));
+
+  std::array<char, message_size> message;
+  message.fill('x');
+  std::array<char, message_size> received;
+
+  // Each tick the server writes a message and reads the answer, as the
+  // agent server does with the measurements and the control.
+  auto tick = [&]() {
+    ASSERT_FALSE(server.Write(boost::asio::buffer(message), seconds(10)));
+    ASSERT_FALSE(server.Read(boost::asio::buffer(received), seconds(10)));
+  };
+
+  for (auto i = 0u; i < warm_up; ++i) {
+    tick();
+  }
+
+  const auto syscalls_begin = SYSCALLS;
+  const auto switches_begin = GetContextSwitches();
+  for (auto i = 0u; i < ticks; ++i) {
+    tick();
+  }
+  const double syscalls = static_cast<double>(SYSCALLS - syscalls_begin) / ticks;
+  const double switches = static_cast<double>(GetContextSwitches() - switches_begin) / ticks;
+  client.get();
+
+  // Context switches depend on the scheduler, only reported.
+  RecordProperty("syscalls_per_tick", std::to_string(syscalls));
+  RecordProperty("context_switches_per_tick", std::to_string(switches));
+  // One send, one receive and at most a wait for the answer. The time-outs
+  // must not add any.
+  ASSERT_LE(syscalls, 4.0);
+}
+
+#endif // __linux__
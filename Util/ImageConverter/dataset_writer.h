@@ -0,0 +1,155 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/gil/image.hpp>
+
+namespace image_converter {
+
+  // ===========================================================================
+  // -- dataset_writer ---------------------------------------------------------
+  // ===========================================================================
+
+  // Appends frames to a dataset folder, the format read by carla.dataset in
+  // the PythonClient (see its documentation for the layout). Only RGB images
+  // are written, one blob per frame.
+  class dataset_writer {
+  public:
+
+    static constexpr uint32_t version = 1u;
+
+    static constexpr uint64_t alignment = 64u;
+
+    static constexpr uint16_t rgb_encoding = 5u;
+
+    explicit dataset_writer(const boost::filesystem::path &folder) {
+      namespace fs = boost::filesystem;
+      if (!fs::is_directory(folder) && !fs::create_directories(folder)) {
+        throw std::invalid_argument("cannot create folder: " + folder.string());
+      }
+      open(folder / "data.bin", "CARLADAT", 0u, _data);
+      open(folder / "index.bin", "CARLAIDX", index_entry_size, _index);
+    }
+
+    // Append the view as the frame frame_number, named name.
+    template <typename VIEW>
+    void add_rgb_image(uint64_t frame_number, const std::string &name, const VIEW &view) {
+      const auto width = static_cast<uint32_t>(view.width());
+      const auto height = static_cast<uint32_t>(view.height());
+      const uint64_t begin = static_cast<uint64_t>(_data.tellp());
+      const uint64_t header_size = 16u + 40u + name.size();
+      const uint64_t offset = begin + header_size + padding(begin + header_size);
+      const uint64_t size = 3u * width * height;
+
+      std::vector<char> header;
+      append<uint64_t>(header, frame_number);
+      append<uint32_t>(header, 1u); // number of blobs.
+      append<uint32_t>(header, 0u);
+      append<uint16_t>(header, rgb_encoding);
+      append<uint16_t>(header, static_cast<uint16_t>(name.size()));
+      append<uint32_t>(header, width);
+      append<uint32_t>(header, height);
+      append<float>(header, 0.0f); // fov, unknown.
+      append<uint64_t>(header, offset);
+      append<uint64_t>(header, size);
+      header.insert(header.end(), name.begin(), name.end());
+      header.resize(offset - begin, '\0');
+      _data.write(header.data(), header.size());
+
+      std::vector<char> row(3u * width);
+      for (auto y = 0u; y < height; ++y) {
+        auto pixel = view.row_begin(y);
+        for (auto x = 0u; x < width; ++x, ++pixel) {
+          boost::gil::rgb8_pixel_t rgb;
+          boost::gil::color_convert(*pixel, rgb);
+          row[3u * x + 0u] = static_cast<char>(rgb[0u]);
+          row[3u * x + 1u] = static_cast<char>(rgb[1u]);
+          row[3u * x + 2u] = static_cast<char>(rgb[2u]);
+        }
+        _data.write(row.data(), row.size());
+      }
+      _data.flush();
+
+      // The index entry goes last, a frame is visible only once complete.
+      std::vector<char> entry;
+      append<uint64_t>(entry, frame_number);
+      append<uint64_t>(entry, begin);
+      append<uint64_t>(entry, offset + size - begin);
+      _index.write(entry.data(), entry.size());
+      _index.flush();
+      if (!_data || !_index) {
+        throw std::runtime_error("error writing to the dataset");
+      }
+    }
+
+  private:
+
+    static constexpr uint32_t index_entry_size = 24u;
+
+    static uint64_t padding(uint64_t offset) {
+      return (alignment - offset % alignment) % alignment;
+    }
+
+    template <typename T>
+    static void append(std::vector<char> &buffer, T value) {
+      static_assert(std::is_arithmetic<T>::value, "not a number");
+      char bytes[sizeof(T)];
+      std::memcpy(bytes, &value, sizeof(T)); // Little-endian only.
+      buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Open the file for appending, writing the header if new, and drop a
+    // partial index entry left by an interrupted writer.
+    static void open(
+        const boost::filesystem::path &path,
+        const char *magic,
+        uint32_t value,
+        std::fstream &file) {
+      namespace fs = boost::filesystem;
+      if (!fs::exists(path) || (fs::file_size(path) == 0u)) {
+        std::ofstream new_file(path.string(), std::ios::binary | std::ios::trunc);
+        std::vector<char> header(magic, magic + 8u);
+        append<uint32_t>(header, version);
+        append<uint32_t>(header, value);
+        new_file.write(header.data(), header.size());
+      }
+      file.open(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+      char header[16u];
+      if (!file.read(header, sizeof(header)) || (std::memcmp(header, magic, 8u) != 0)) {
+        throw std::invalid_argument("not a CARLA dataset: " + path.string());
+      }
+      uint32_t header_version;
+      uint32_t header_value;
+      std::memcpy(&header_version, header + 8u, sizeof(uint32_t));
+      std::memcpy(&header_value, header + 12u, sizeof(uint32_t));
+      if ((header_version != version) || (header_value != value)) {
+        throw std::invalid_argument("unsupported dataset version: " + path.string());
+      }
+      if (value != 0u) {
+        file.close();
+        const auto size = fs::file_size(path);
+        fs::resize_file(path, 16u + (size - 16u) / value * value);
+        file.open(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+      }
+      file.seekp(0, std::ios::end);
+    }
+
+    std::fstream _data;
+
+    std::fstream _index;
+  };
+
+} // namespace image_converter
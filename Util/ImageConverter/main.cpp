@@ -4,15 +4,18 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include <algorithm>
 #include <cstdint>
 #include <exception>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <regex>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#include "dataset_writer.h"
 #include "image_converter.h"
 
 enum MainFunctionReturnValues {
@@ -45,53 +48,91 @@ static bool match(const std::string &filepath, const std::string &regex) {
       std::regex(regex, std::regex_constants::icase));
 }
 
-// Load image, apply pixel converter, and save it.
+// Frame number of an image file, the last digits of its name (e.g.
+// "000123.png" is frame 123, as saved by the PythonClient).
+static bool get_frame_number(const fs::path &filepath, uint64_t &frame_number) {
+  std::smatch digits;
+  const auto stem = filepath.stem().string();
+  if (!std::regex_search(stem, digits, std::regex("([0-9]+)$"))) {
+    return false;
+  }
+  frame_number = std::stoull(digits[1u].str());
+  return true;
+}
+
+// Load image, apply pixel converter, and save it, either to out_filename or
+// appended to the dataset as the frame of the file name.
 template <typename IO>
 static void parse_image(
     const std::string &in_filename,
     const std::string &out_filename,
-    pixel_converter_function converter) {
+    pixel_converter_function converter,
+    image_converter::dataset_writer *dataset) {
   image_converter::image_file<IO> file_io(in_filename);
   file_io.apply(converter);
-  file_io.write(out_filename);
+  if (dataset == nullptr) {
+    file_io.write(out_filename);
+  } else {
+    uint64_t frame_number = 0u;
+    const fs::path in_path(in_filename);
+    if (!get_frame_number(in_path, frame_number)) {
+      throw std::invalid_argument("no frame number in the file name");
+    }
+    const auto name = fs::canonical(in_path).parent_path().filename().string();
+    // Appended in file name order, exceptions cannot leave the ordered block.
+    std::exception_ptr error;
+#pragma omp ordered
+    try {
+      dataset->add_rgb_image(frame_number, name, file_io.view());
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
 }
 
 // Determine the file format and parse it accordingly.
 static void parse_any_image(
     const std::string &in_filename,
     const std::string &out_filename,
-    pixel_converter_function converter) {
+    pixel_converter_function converter,
+    image_converter::dataset_writer *dataset) {
   namespace ic = image_converter;
   try {
     if (ic::has_png_support() && match(in_filename, ".*\\.png$")) {
-      parse_image<ic::png_io>(in_filename, out_filename, converter);
+      parse_image<ic::png_io>(in_filename, out_filename, converter, dataset);
     } else if (ic::has_jpeg_support() && match(in_filename, ".*\\.(jpg|jpeg)$")) {
-      parse_image<ic::jpeg_io>(in_filename, out_filename, converter);
+      parse_image<ic::jpeg_io>(in_filename, out_filename, converter, dataset);
     } else if (ic::has_tiff_support() && match(in_filename, ".*\\.tiff$")) {
-      parse_image<ic::tiff_io>(in_filename, out_filename, converter);
+      parse_image<ic::tiff_io>(in_filename, out_filename, converter, dataset);
     }
   } catch (const std::exception &e) {
     std::cerr << "exception thrown parsing file \"" << in_filename << "\"\n" << e.what() << std::endl;
   }
 }
 
-// Parse in parallel every regular file in input_folder.
+// Parse in parallel every regular file in input_folder. If dataset is not
+// null the images are appended to it instead of saved to output_folder.
 static void do_the_thing(
     const fs::path &input_folder,
     const fs::path &output_folder,
-    const pixel_converter_function converter) {
-  const std::vector<fs::directory_entry> entries{
+    const pixel_converter_function converter,
+    image_converter::dataset_writer *dataset) {
+  std::vector<fs::directory_entry> entries{
       fs::directory_iterator(input_folder),
       fs::directory_iterator()};
+  std::sort(entries.begin(), entries.end());
   std::cout << "parsing " << entries.size() << " files in folder\n";
 
-#pragma omp parallel for
+#pragma omp parallel for ordered schedule(dynamic)
   for (auto i = 0u; i < entries.size(); ++i) {
     const auto &entry = entries[i];
     if (fs::is_regular_file(entry.status())) {
       const auto &in_path = entry.path();
       const auto &out_path = output_folder / in_path.filename();
-      parse_any_image(in_path.string(), out_path.string(), converter);
+      parse_any_image(in_path.string(), out_path.string(), converter, dataset);
     }
   }
 }
@@ -101,6 +142,7 @@ int main(int argc, char *argv[]) {
     std::string converter_name;
     fs::path input_folder;
     fs::path output_folder;
+    fs::path dataset_folder;
 
     // Fill program options.
     po::options_description desc("Allowed options");
@@ -109,6 +151,7 @@ int main(int argc, char *argv[]) {
       ("converter,c", po::value<std::string>(&converter_name)->required(), "converter (semseg or depth or logdepth)")
       ("input-folder,i", po::value<fs::path>(&input_folder)->default_value("."), "input folder containing images")
       ("output-folder,o", po::value<fs::path>(&output_folder)->default_value("./converted_images"), "output folder to save converted images")
+      ("dataset,d", po::value<fs::path>(&dataset_folder), "append the converted images to this dataset folder instead (see carla.dataset)")
       ;
 
     try {
@@ -131,15 +174,18 @@ int main(int argc, char *argv[]) {
         throw std::invalid_argument("not a folder: " + input_folder.string());
       }
 
-      // Create output_folder if it doesn't exist.
-      if (!fs::is_directory(output_folder) && !fs::create_directories(output_folder)) {
+      // Open the dataset, or create output_folder if it doesn't exist.
+      std::unique_ptr<image_converter::dataset_writer> dataset;
+      if (!dataset_folder.empty()) {
+        dataset = std::make_unique<image_converter::dataset_writer>(dataset_folder);
+      } else if (!fs::is_directory(output_folder) && !fs::create_directories(output_folder)) {
         throw std::invalid_argument("cannot create folder: " + output_folder.string());
       }
 
       // Retrieve the pixel converter.
       const pixel_converter_function converter = get_pixel_converter(converter_name);
 
-      do_the_thing(input_folder, output_folder, converter);
+      do_the_thing(input_folder, output_folder, converter, dataset.get());
 
     } catch (const po::error &e) {
       std::cerr << desc << "\n" << e.what() << std::endl;